@@ -1245,6 +1245,8 @@ int CmdInterpreter::effects(Parser& input, unsigned char controlType)
                         value = 1;
                     else if (input.matchnMove(1, "bandwidth"))
                         value = 2;
+                    else if (input.matchnMove(2, "fdn"))
+                        value = 3;
                     else
                         return REPLY::value_msg;
                 }
@@ -1284,7 +1286,7 @@ int CmdInterpreter::effects(Parser& input, unsigned char controlType)
                         value = 1;
                     else return REPLY::value_msg;
                 }
-                else if (selected == 11) // subtract
+                else if (selected == 11 || selected == 12) // subtract, cubic
                 {
                     input.skipChars();
                     value = (input.toggle() == 1);
@@ -2485,6 +2487,20 @@ int CmdInterpreter::commandList(Parser& input)
         return REPLY::done_msg;
     }
 
+    if (input.matchnMove(2, "stats"))
+    {
+        synth->ListStats(msg);
+        synth->cliOutput(msg, LINES);
+        return REPLY::done_msg;
+    }
+
+    if (input.matchnMove(3, "meters"))
+    {
+        synth->ListMeters(msg);
+        synth->cliOutput(msg, LINES);
+        return REPLY::done_msg;
+    }
+
     if (input.matchnMove(2, "mlearn"))
     {
         if (input.nextChar('@'))
@@ -5901,6 +5917,30 @@ int CmdInterpreter::commandTest(Parser& input, unsigned char controlType)
         synth->swapTestPADtable();
     }// note: the following handler will consume the "swapwave" command and store the offset parameter
 
+    if (input.matchnMove(2, "benchshapers"))
+    {
+        list<string> msg;
+        test::benchmarkWaveShapers(msg, synth->buffersize);
+        synth->cliOutput(msg, LINES);
+        return REPLY::done_msg;
+    }
+
+    if (input.matchnMove(2, "benchunison"))
+    {
+        list<string> msg;
+        test::benchmarkUnison(msg, *synth);
+        synth->cliOutput(msg, LINES);
+        return REPLY::done_msg;
+    }
+
+    if (input.matchnMove(2, "benchlearn"))
+    {
+        list<string> msg;
+        test::benchmarkMidiLearn(msg, *synth);
+        synth->cliOutput(msg, LINES);
+        return REPLY::done_msg;
+    }
+
     string response;
     if (TestInvoker::access().handleParameterChange(input, controlType, response, synth->buffersize))
         synth->getRuntime().Log(response);
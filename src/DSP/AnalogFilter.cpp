@@ -26,6 +26,7 @@
 #include <cstring>
 
 #include "DSP/AnalogFilter.h"
+#include "DSP/Lanes.h"
 #include "Misc/SynthEngine.h"
 #include "Misc/NumericFuncs.h"
 
@@ -51,7 +52,6 @@ AnalogFilter::AnalogFilter(SynthEngine& _synth, uchar _type, float _freq, float
     , firsttime{true}
     , abovenq{false}
     , oldabovenq{false}
-    , tmpismp{0}
     , synth{_synth}
 {
 
@@ -84,7 +84,6 @@ AnalogFilter::AnalogFilter(AnalogFilter const& orig)
     , firsttime{orig.firsttime}
     , abovenq{orig.abovenq}
     , oldabovenq{orig.oldabovenq}
-    , tmpismp{0}              // No need to copy sample data, as this is filled from input data
     , synth{orig.synth}
 { }
 
@@ -420,11 +419,12 @@ void AnalogFilter::interpolatenextbuffer()
 void AnalogFilter::singlefilterout(float* smp, FStage& x, FStage& y, Coeffs const& c, Coeffs const& d)
 {
     float y0;
+    float bias = denormal::bias(1e-20f);
     if (order == 1)
     {   // First order filter
         for (int i = 0; i < synth.sent_buffersize; ++i)
-        { // anti-denormal added in here
-            y0 = (smp[i] + float(1e-20)) * c[0] + x.c1 * c[1] + y.c1 * d[1];
+        {
+            y0 = (smp[i] + bias) * c[0] + x.c1 * c[1] + y.c1 * d[1];
             y.c1 = y0;
             x.c1 = smp[i];
             smp[i] = y0; // out it goes
@@ -433,8 +433,8 @@ void AnalogFilter::singlefilterout(float* smp, FStage& x, FStage& y, Coeffs cons
     if (order == 2)
     { // Second order filter
         for (int i = 0; i < synth.sent_buffersize; ++i)
-        { // anti-denormal added in here
-            y0 = (smp[i] + float(1e-20)) * c[0] + x.c1 * c[1] + x.c2 * c[2] + y.c1 * d[1] + y.c2 * d[2];
+        {
+            y0 = (smp[i] + bias) * c[0] + x.c1 * c[1] + x.c2 * c[2] + y.c1 * d[1] + y.c2 * d[2];
             y.c2 = y.c1;
             y.c1 = y0;
             x.c2 = x.c1;
@@ -445,36 +445,228 @@ void AnalogFilter::singlefilterout(float* smp, FStage& x, FStage& y, Coeffs cons
 }
 
 
-void AnalogFilter::filterout(float* smp)
+/*
+ * Runs the whole cascade one sample at a time, with four filters side
+ * by side in the lanes: left and right with the current coefficients,
+ * then left and right with the old ones. The old pair only matters
+ * while a coefficient change is being crossfaded, which now happens in
+ * the same pass rather than filtering the buffer twice. Both orders use
+ * the biquad form, a first order filter simply has zero c[2] and d[2].
+ * For a mono filter right is null and the right lanes idle alongside.
+ */
+void AnalogFilter::laneFilterout(AnalogFilter* right, float* smpl, float* smpr)
 {
-    if (needsinterpolation)
+    using lanes::Four;
+    AnalogFilter& r = right ? *right : *this;
+    const float* inr = right ? smpr : smpl;
+
+    // if one side isn't changing, its old lane is ignored
+    const Coeffs& lc = needsinterpolation ? oldc : c;
+    const Coeffs& ld = needsinterpolation ? oldd : d;
+    const Coeffs& rc = r.needsinterpolation ? r.oldc : r.c;
+    const Coeffs& rd = r.needsinterpolation ? r.oldd : r.d;
+    const Four c0{c[0], r.c[0], lc[0], rc[0]};
+    const Four c1{c[1], r.c[1], lc[1], rc[1]};
+    const Four c2{c[2], r.c[2], lc[2], rc[2]};
+    const Four d1{d[1], r.d[1], ld[1], rd[1]};
+    const Four d2{d[2], r.d[2], ld[2], rd[2]};
+
+    const uint count = stages + 1;
+    Four x1[MAX_FILTER_STAGES + 1], x2[MAX_FILTER_STAGES + 1];
+    Four y1[MAX_FILTER_STAGES + 1], y2[MAX_FILTER_STAGES + 1];
+    for (uint s = 0; s < count; ++s)
     {
-        if (not tmpismp) // allocate interpolation buffer on first usage
-            tmpismp.reset(synth.buffersize);
+        const FStage& lx = needsinterpolation ? oldx[s] : x[s];
+        const FStage& ly = needsinterpolation ? oldy[s] : y[s];
+        const FStage& rx = r.needsinterpolation ? r.oldx[s] : r.x[s];
+        const FStage& ry = r.needsinterpolation ? r.oldy[s] : r.y[s];
+        x1[s] = Four{x[s].c1, r.x[s].c1, lx.c1, rx.c1};
+        x2[s] = Four{x[s].c2, r.x[s].c2, lx.c2, rx.c2};
+        y1[s] = Four{y[s].c1, r.y[s].c1, ly.c1, ry.c1};
+        y2[s] = Four{y[s].c2, r.y[s].c2, ly.c2, ry.c2};
+    }
 
-        memcpy(tmpismp.get(), smp, synth.sent_bufferbytes);
-        for (uint i = 0; i < stages + 1; ++i)
-            singlefilterout(tmpismp.get(), oldx[i], oldy[i], oldc, oldd);
+    const int frames = synth.sent_buffersize;
+    const float step = 1.0f / synth.sent_buffersize_f;
+    const float gainl = outgain;
+    const float gainr = r.outgain;
+    const bool fadel = needsinterpolation;
+    const bool fader = right && right->needsinterpolation;
+    for (int i = 0; i < frames; ++i)
+    {
+        Four v{smpl[i], inr[i], smpl[i], inr[i]};
+        for (uint s = 0; s < count; ++s)
+        {
+            Four y0 = v * c0 + x1[s] * c1 + x2[s] * c2 + y1[s] * d1 + y2[s] * d2;
+            x2[s] = x1[s];
+            x1[s] = v;
+            y2[s] = y1[s];
+            y1[s] = y0;
+            v = y0;
+        }
+        float t = i * step;
+        float tl = fadel ? t : 1.0f;
+        float tr = fader ? t : 1.0f;
+        smpl[i] = (v[0] * tl + v[2] * (1.0f - tl)) * gainl;
+        if (right)
+            smpr[i] = (v[1] * tr + v[3] * (1.0f - tr)) * gainr;
     }
 
-    for (uint i = 0; i < stages + 1; ++i)
-        singlefilterout(smp, x[i], y[i], c, d);
+    for (uint s = 0; s < count; ++s)
+    {
+        x[s].c1 = x1[s][0];
+        x[s].c2 = x2[s][0];
+        y[s].c1 = y1[s][0];
+        y[s].c2 = y2[s][0];
+        if (right)
+        {
+            right->x[s].c1 = x1[s][1];
+            right->x[s].c2 = x2[s][1];
+            right->y[s].c1 = y1[s][1];
+            right->y[s].c2 = y2[s][1];
+        }
+    }
+    needsinterpolation = false;
+    if (right)
+        right->needsinterpolation = false;
+}
 
-    if (needsinterpolation)
+
+/*
+ * Every filter of the bank runs in its own lane, four to a group, and
+ * all the groups are stepped together so the lanes only have to be
+ * summed once per sample. Filters waiting to be interpolated ramp their
+ * coefficients across the buffer instead of being run twice. The bank
+ * must all have the same number of stages.
+ */
+void AnalogFilter::filterBank(AnalogFilter* const* bank, int count, const float* in, float inGain,
+                              float* out, const float* ampFrom, const float* ampTo)
+{
+    using lanes::Four;
+    using lanes::WIDTH;
+    constexpr int MAX_GROUPS = (FF_MAX_FORMANTS + WIDTH - 1) / WIDTH;
+    if (count < 1)
+        return;
+    if (count > MAX_GROUPS * WIDTH)
+        count = MAX_GROUPS * WIDTH;
+    const int groups = (count + WIDTH - 1) / WIDTH;
+    const uint stages = bank[0]->stages + 1;
+    SynthEngine& synth = bank[0]->synth;
+    const int frames = synth.sent_buffersize;
+    const float step = 1.0f / synth.sent_buffersize_f;
+
+    Four c0[MAX_GROUPS], c1[MAX_GROUPS], c2[MAX_GROUPS], d1[MAX_GROUPS], d2[MAX_GROUPS];
+    Four dc0[MAX_GROUPS], dc1[MAX_GROUPS], dc2[MAX_GROUPS], dd1[MAX_GROUPS], dd2[MAX_GROUPS];
+    Four amp[MAX_GROUPS], damp[MAX_GROUPS];
+    Four x1[MAX_GROUPS][MAX_FILTER_STAGES + 1], x2[MAX_GROUPS][MAX_FILTER_STAGES + 1];
+    Four y1[MAX_GROUPS][MAX_FILTER_STAGES + 1], y2[MAX_GROUPS][MAX_FILTER_STAGES + 1];
+    for (int g = 0; g < groups; ++g)
+    {   // spare lanes have zero coefficients, state and amplitude
+        c0[g] = c1[g] = c2[g] = d1[g] = d2[g] = lanes::splat(0.0f);
+        dc0[g] = dc1[g] = dc2[g] = dd1[g] = dd2[g] = lanes::splat(0.0f);
+        amp[g] = damp[g] = lanes::splat(0.0f);
+        for (uint s = 0; s < stages; ++s)
+            x1[g][s] = x2[g][s] = y1[g][s] = y2[g][s] = lanes::splat(0.0f);
+        for (int l = 0; l < WIDTH && g * WIDTH + l < count; ++l)
+        {
+            int n = g * WIDTH + l;
+            AnalogFilter& f = *bank[n];
+            const Coeffs& fc = f.needsinterpolation ? f.oldc : f.c;
+            const Coeffs& fd = f.needsinterpolation ? f.oldd : f.d;
+            c0[g][l] = fc[0];
+            c1[g][l] = fc[1];
+            c2[g][l] = fc[2];
+            d1[g][l] = fd[1];
+            d2[g][l] = fd[2];
+            dc0[g][l] = (f.c[0] - fc[0]) * step;
+            dc1[g][l] = (f.c[1] - fc[1]) * step;
+            dc2[g][l] = (f.c[2] - fc[2]) * step;
+            dd1[g][l] = (f.d[1] - fd[1]) * step;
+            dd2[g][l] = (f.d[2] - fd[2]) * step;
+            amp[g][l] = ampFrom[n] * f.outgain;
+            damp[g][l] = (ampTo[n] - ampFrom[n]) * f.outgain * step;
+            for (uint s = 0; s < stages; ++s)
+            {
+                x1[g][s][l] = f.x[s].c1;
+                x2[g][s][l] = f.x[s].c2;
+                y1[g][s][l] = f.y[s].c1;
+                y2[g][s][l] = f.y[s].c2;
+            }
+        }
+    }
+
+    for (int i = 0; i < frames; ++i)
     {
-        for (int i = 0; i < synth.sent_buffersize; ++i)
+        const Four input = lanes::splat(in[i] * inGain);
+        Four mix = lanes::splat(0.0f);
+        for (int g = 0; g < groups; ++g)
+        {
+            Four v = input;
+            for (uint s = 0; s < stages; ++s)
+            {
+                Four y0 = v * c0[g] + x1[g][s] * c1[g] + x2[g][s] * c2[g] + y1[g][s] * d1[g] + y2[g][s] * d2[g];
+                x2[g][s] = x1[g][s];
+                x1[g][s] = v;
+                y2[g][s] = y1[g][s];
+                y1[g][s] = y0;
+                v = y0;
+            }
+            mix += v * amp[g];
+            amp[g] += damp[g];
+            c0[g] += dc0[g];
+            c1[g] += dc1[g];
+            c2[g] += dc2[g];
+            d1[g] += dd1[g];
+            d2[g] += dd2[g];
+        }
+        out[i] = lanes::sum(mix);
+    }
+
+    for (int n = 0; n < count; ++n)
+    {
+        int g = n / WIDTH;
+        int l = n % WIDTH;
+        AnalogFilter& f = *bank[n];
+        for (uint s = 0; s < stages; ++s)
         {
-            float x = (float)i / synth.sent_buffersize_f;
-            smp[i] = tmpismp[i] * (1.0f - x) + smp[i] * x;
+            f.x[s].c1 = x1[g][s][l];
+            f.x[s].c2 = x2[g][s][l];
+            f.y[s].c1 = y1[g][s][l];
+            f.y[s].c2 = y2[g][s][l];
         }
-        needsinterpolation = false;
+        f.needsinterpolation = false;
     }
+}
+
+
+void AnalogFilter::filterout(float* smp)
+{
+    if (needsinterpolation)
+    {
+        laneFilterout(nullptr, smp, smp);
+        return;
+    }
+
+    for (uint i = 0; i < stages + 1; ++i)
+        singlefilterout(smp, x[i], y[i], c, d);
 
     for (int i = 0; i < synth.sent_buffersize; ++i)
         smp[i] *= outgain;
 }
 
 
+void AnalogFilter::filterStereo(float* smpl, float* smpr, Filter_& right)
+{
+    AnalogFilter* twin = dynamic_cast<AnalogFilter*>(&right);
+    if (!twin || twin == this || twin->stages != stages)
+    {
+        Filter_::filterStereo(smpl, smpr, right);
+        return;
+    }
+    laneFilterout(twin, smpl, smpr);
+}
+
+
 /** @return Response for a given frequency, as numeric factor */
 float AnalogFilter::calcFilterResponse(float freq) const
 {
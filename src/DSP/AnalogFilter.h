@@ -49,6 +49,10 @@ class AnalogFilter : public Filter_
 
 
         void filterout(float* smp);
+        void filterStereo(float* smpl, float* smpr, Filter_& right) override;
+        // a parallel bank fed the same input, mixed with amplitudes ramped from..to (out may be in)
+        static void filterBank(AnalogFilter* const* bank, int count, const float* in, float inGain,
+                               float* out, const float* ampFrom, const float* ampTo);
         void setfreq(float);
         float getFreq();
         void setfreq_and_q(float frequency, float q_);
@@ -89,10 +93,10 @@ class AnalogFilter : public Filter_
         bool abovenq;       // if frequency is above the nyquist
         bool oldabovenq;    // (last state to determine if it needs interpolation)
 
-        Samples tmpismp;    // used if it needs interpolation in filterout()
         SynthEngine& synth;
 
         void singlefilterout(float* smp, FStage& x, FStage& y, Coeffs const& c, Coeffs const& d);
+        void laneFilterout(AnalogFilter* right, float* smpl, float* smpr);
         void computefiltercoefs();
 };
 
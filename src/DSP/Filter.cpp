@@ -24,6 +24,7 @@
 */
 
 #include "DSP/Filter.h"
+#include "Misc/SynthEngine.h"
 #include "Misc/NumericFuncs.h"
 
 using func::decibel;
@@ -43,6 +44,12 @@ Filter_* Filter::buildImpl(SynthEngine& synth)
 }
 
 
+SynthEngine* Filter::denormalWatch(SynthEngine& synth)
+{
+    return synth.getRuntime().denormalCheck ? &synth : nullptr;
+}
+
+
 void Filter::updateCurrentParameters()
 {
     switch (category)
@@ -73,6 +80,30 @@ void Filter::filterout(float *smp)
         updateCurrentParameters();
 
     filterImpl->filterout(smp);
+    if (watch)
+        watch->denormals.scanFilter(category, smp, watch->sent_buffersize);
+}
+
+
+void Filter::filterStereo(float *smpl, float *smpr, Filter& right)
+{
+    if (parsUpdate.checkUpdated())
+        updateCurrentParameters();
+    if (right.parsUpdate.checkUpdated())
+        right.updateCurrentParameters();
+
+    if (right.category == category)
+        filterImpl->filterStereo(smpl, smpr, *right.filterImpl);
+    else
+    {
+        filterImpl->filterout(smpl);
+        right.filterImpl->filterout(smpr);
+    }
+    if (watch)
+    {
+        watch->denormals.scanFilter(category, smpl, watch->sent_buffersize);
+        watch->denormals.scanFilter(right.category, smpr, watch->sent_buffersize);
+    }
 }
 
 
@@ -46,6 +46,7 @@ class Filter
             , params{p}
             , parsUpdate{p}
             , filterImpl{buildImpl(synth)}
+            , watch{denormalWatch(synth)}
             {
                 updateCurrentParameters();
             }
@@ -56,6 +57,7 @@ class Filter
             , params{o.params}
             , parsUpdate{o.parsUpdate}
             , filterImpl{o.filterImpl->clone()}
+            , watch{o.watch}
             { };
         // can be moved, but not assigned
         Filter(Filter&&)                 = default;
@@ -63,6 +65,7 @@ class Filter
         Filter& operator=(Filter const&) = delete;
 
         void filterout(float *smp);
+        void filterStereo(float *smpl, float *smpr, Filter& right); // right is this one's twin
         void setfreq(float frequency);
         void setfreq_and_q(float frequency, float q_);
         void setq(float q_);
@@ -70,12 +73,14 @@ class Filter
 
     private:
         Filter_* buildImpl(SynthEngine&);
+        static SynthEngine* denormalWatch(SynthEngine&);
         void updateCurrentParameters();
 
         uchar category;
         FilterParams& params;
         ParamBase::ParamsUpdate parsUpdate;
         std::unique_ptr<Filter_> filterImpl;
+        SynthEngine* watch; // only set for --denormal-check
 };
 
 #endif
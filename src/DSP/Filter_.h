@@ -36,6 +36,13 @@ class Filter_
         virtual ~Filter_() { };
         virtual Filter_* clone() = 0;
         virtual void filterout(float *smp) = 0;
+        // left through this one and right through its twin, which may
+        // be run side by side when both are of the same kind
+        virtual void filterStereo(float *smpl, float *smpr, Filter_& right)
+        {
+            filterout(smpl);
+            right.filterout(smpr);
+        }
         virtual void setfreq(float frequency) = 0;
         virtual void setfreq_and_q(float frequency, float q_) = 0;
         virtual void setq(float q_) = 0;
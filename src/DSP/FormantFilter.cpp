@@ -30,7 +30,6 @@
 #include "Misc/NumericFuncs.h"
 
 using synth::aboveAmplitudeThreshold;
-using synth::interpolateAmplitude;
 using func::decibel;
 using func::powFrac;
 using func::power;
@@ -39,9 +38,7 @@ using func::power;
 FormantFilter::FormantFilter(SynthEngine* _synth, FilterParams* pars_):
     pars(pars_),
     parsUpdate(*pars_),
-    synth(_synth),
-    inbuffer(synth->buffersize),
-    tmpbuff (synth->buffersize)
+    synth(_synth)
 {
     numformants = pars->Pnumformants;
     for (int i = 0; i < numformants; ++i)
@@ -87,10 +84,7 @@ FormantFilter::FormantFilter(const FormantFilter &orig) :
     oldQfactor(orig.oldQfactor),
     vowelclearness(orig.vowelclearness),
     sequencestretch(orig.sequencestretch),
-    synth(orig.synth),
-    // These don't hold persistent state and don't need a memcpy
-    inbuffer(synth->buffersize),
-    tmpbuff (synth->buffersize)
+    synth(orig.synth)
 {
     outgain = orig.outgain;
 
@@ -247,30 +241,24 @@ void FormantFilter::setfreq_and_q(float frequency, float q_)
 }
 
 
+// all the formants in one pass, see AnalogFilter::filterBank()
 void FormantFilter::filterout(float *smp)
 {
-    memcpy(inbuffer.get(), smp, synth->sent_bufferbytes);
-    memset(smp, 0, synth->sent_bufferbytes);
-
+    if (numformants < 1)
+    {
+        memset(smp, 0, synth->sent_bufferbytes);
+        return;
+    }
+    float ampFrom[FF_MAX_FORMANTS];
+    float ampTo[FF_MAX_FORMANTS];
     for (int j = 0; j < numformants; ++j)
     {
-        for (int k = 0; k < synth->sent_buffersize; ++k)
-            tmpbuff[k] = inbuffer[k] * outgain;
-        formant[j]->filterout(tmpbuff.get());
-
+        ampTo[j] = currentformants[j].amp;
         if (aboveAmplitudeThreshold(oldformantamp[j], currentformants[j].amp))
-        {
-            for (int i = 0; i < synth->sent_buffersize; ++i)
-                smp[i] += tmpbuff[i]
-                          * interpolateAmplitude(oldformantamp[j],
-                                                  currentformants[j].amp, i,
-                                                  synth->sent_buffersize);
-        }
+            ampFrom[j] = oldformantamp[j];
         else
-        {
-            for (int i = 0; i < synth->sent_buffersize; ++i)
-                smp[i] += tmpbuff[i] * currentformants[j].amp;
-        }
+            ampFrom[j] = currentformants[j].amp;
         oldformantamp[j] = currentformants[j].amp;
     }
+    AnalogFilter::filterBank(formant, numformants, smp, outgain, smp, ampFrom, ampTo);
 }
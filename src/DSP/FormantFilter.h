@@ -75,9 +75,6 @@ class FormantFilter : public Filter_
         float vowelclearness, sequencestretch;
 
         SynthEngine *synth;
-
-        Samples inbuffer;
-        Samples tmpbuff;
 };
 
 
@@ -0,0 +1,64 @@
+/*
+    Lanes.h - Groups of four floats processed side by side
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.   See the GNU General Public License (version 2 or
+    later) for more details.
+
+    You should have received a copy of the GNU General Public License along with
+    yoshimi; if not, write to the Free Software Foundation, Inc., 51 Franklin
+    Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef LANES_H
+#define LANES_H
+
+#include <cstring>
+
+/*
+ * Where independent filters or delay lines have to be stepped one
+ * sample at a time (because each sample depends on the last) the
+ * compiler won't vectorise across them by itself. These use the GCC /
+ * Clang vector extension, so the arithmetic is written once and maps
+ * to SSE on x86 and NEON on ARM without any platform intrinsics.
+ * Loads and stores go through memcpy so no alignment is assumed.
+ */
+namespace lanes {
+
+typedef float Four __attribute__((vector_size(16)));
+
+constexpr int WIDTH = 4;
+
+inline Four load(const float *from)
+{
+    Four v;
+    memcpy(&v, from, sizeof(Four));
+    return v;
+}
+
+inline void store(float *to, Four v)
+{
+    memcpy(to, &v, sizeof(Four));
+}
+
+inline Four splat(float value)
+{
+    return Four{value, value, value, value};
+}
+
+inline float sum(Four v)
+{
+    return (v[0] + v[1]) + (v[2] + v[3]);
+}
+
+} // namespace lanes
+
+#endif /*LANES_H*/
@@ -0,0 +1,302 @@
+/*
+    Oversampler.h - Polyphase half-band up/down sampling by 2, 4 or 8
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public
+    License as published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.   See the GNU General Public License (version 2 or
+    later) for more details.
+
+    You should have received a copy of the GNU General Public License along with
+    yoshimi; if not, write to the Free Software Foundation, Inc., 51 Franklin
+    Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef OVERSAMPLER_H
+#define OVERSAMPLER_H
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "Misc/Alloc.h"
+
+namespace halfband {
+
+inline double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x * 0.5 / k) * (x * 0.5 / k);
+        sum += term;
+    }
+    return sum;
+}
+
+} // namespace halfband
+
+
+/*
+ * One factor-of-two stage, a linear phase half-band FIR split into its
+ * two polyphase branches. Every other tap of a half-band filter is zero
+ * apart from the centre, so one branch is a plain delay and the other
+ * holds all the arithmetic, working at the lower of the two rates.
+ *
+ * The input is copied behind the tail of the previous call so the inner
+ * loops never test for the buffer edge and the compiler is free to
+ * vectorise them across the output samples.
+ */
+template<int PAIRS>
+class HalfBandStage
+{
+    public:
+        static constexpr int UPTAIL = 2 * PAIRS - 1;
+        static constexpr int DOWNTAIL = 4 * PAIRS - 2;
+
+        HalfBandStage(float beta) :
+            upExt{},
+            downExt{},
+            maxIn{0}
+        {
+            // windowed sinc, only the odd taps are non zero
+            double sum = 0.0;
+            for (int j = 0; j < PAIRS; ++j)
+            {
+                int k = 2 * j + 1;
+                double ratio = double(k) / (2 * PAIRS);
+                double window = halfband::besselI0(beta * sqrt(1.0 - ratio * ratio)) / halfband::besselI0(beta);
+                double tap = ((j & 1) ? -1.0 : 1.0) / (M_PI * k) * window;
+                coeff[j] = float(tap);
+                sum += tap;
+            }
+            for (int j = 0; j < PAIRS; ++j) // exactly unity gain at DC
+                coeff[j] = float(coeff[j] * 0.25 / sum);
+        }
+
+        void allocate(size_t maxFrames)
+        {
+            maxIn = maxFrames;
+            upExt.reset(UPTAIL + maxFrames);
+            downExt.reset(DOWNTAIL + 2 * maxFrames);
+        }
+
+        void reset()
+        {
+            if (upExt)
+                memset(upExt.get(), 0, UPTAIL * sizeof(float));
+            if (downExt)
+                memset(downExt.get(), 0, DOWNTAIL * sizeof(float));
+        }
+
+        size_t prefault()
+        {
+            return prefaultPages(upExt, UPTAIL + maxIn)
+                 + prefaultPages(downExt, DOWNTAIL + 2 * maxIn);
+        }
+
+        // writes 2 * frames samples to out
+        void up(const float *in, float *__restrict out, int frames)
+        {
+            float *__restrict ext = upExt.get();
+            memcpy(ext + UPTAIL, in, frames * sizeof(float));
+            for (int i = 0; i < frames; ++i)
+            {
+                float sum = 0.0f;
+                for (int j = 0; j < PAIRS; ++j)
+                    sum += coeff[j] * (ext[i + PAIRS - 1 - j] + ext[i + PAIRS + j]);
+                out[2 * i] = ext[i + PAIRS - 1];
+                out[2 * i + 1] = 2.0f * sum;
+            }
+            memmove(ext, ext + frames, UPTAIL * sizeof(float));
+        }
+
+        // reads 2 * frames samples from in
+        void down(const float *in, float *__restrict out, int frames)
+        {
+            float *__restrict ext = downExt.get();
+            memcpy(ext + DOWNTAIL, in, 2 * frames * sizeof(float));
+            for (int i = 0; i < frames; ++i)
+            {
+                int centre = 2 * i + 2 * PAIRS;
+                float sum = 0.5f * ext[centre];
+                for (int j = 0; j < PAIRS; ++j)
+                    sum += coeff[j] * (ext[centre - 1 - 2 * j] + ext[centre + 1 + 2 * j]);
+                out[i] = sum;
+            }
+            memmove(ext, ext + 2 * frames, DOWNTAIL * sizeof(float));
+        }
+
+    private:
+        float coeff[PAIRS];
+        Samples upExt;
+        Samples downExt;
+        size_t maxIn;
+};
+
+
+namespace halfband {
+
+// round trip at the top rate of count stages, the first one steep
+constexpr int roundTrip(int count)
+{
+    int delay = HalfBandStage<8>::DOWNTAIL << (count - 1);
+    for (int s = 1; s < count; ++s)
+        delay += HalfBandStage<4>::DOWNTAIL << (count - 1 - s);
+    return delay;
+}
+
+// top rate samples to add so the round trip is whole base rate samples
+constexpr int padding(int count)
+{
+    return count ? ((1 << count) - roundTrip(count) % (1 << count)) % (1 << count) : 0;
+}
+
+constexpr int latency(int count)
+{
+    return count ? (roundTrip(count) + padding(count)) >> count : 0;
+}
+
+} // namespace halfband
+
+
+/*
+ * Runs a mono signal at 2, 4 or 8 times the sample rate through a
+ * cascade of half-band stages. Only the stage next to the base rate
+ * needs a steep filter, harmonics that fold back from the higher
+ * stages land far above the audio band and are removed by the stages
+ * below them, so those get away with far fewer taps.
+ *
+ * Usage: up() returns the oversampled buffer, which is processed in
+ * place, then down() brings it back to the base rate.
+ *
+ * Each stage delays by its DOWNTAIL on the way up and back, counted at
+ * its own higher rate, so the round trip for 4x and 8x doesn't come
+ * to whole base rate samples. A few samples of plain delay at the top
+ * rate make it up, and latency() is then what a dry signal has to be
+ * held back by to line up with the result.
+ */
+class Oversampler
+{
+    public:
+        static constexpr int MAX_STAGES = 3;
+
+        static constexpr int MAX_LATENCY = halfband::latency(MAX_STAGES);
+        static constexpr int MAX_PADDING = 1 << MAX_STAGES;
+
+        Oversampler(size_t maxFrames) :
+            stages{0},
+            first{7.0f},
+            outer{ {5.0f}, {5.0f} },
+            workA{maxFrames << MAX_STAGES},
+            workB{maxFrames << MAX_STAGES},
+            padExt{MAX_PADDING + (maxFrames << MAX_STAGES)},
+            shaped{nullptr},
+            spare{nullptr},
+            maxFrames{maxFrames}
+        {
+            first.allocate(maxFrames);
+            for (int s = 1; s < MAX_STAGES; ++s)
+                outer[s - 1].allocate(maxFrames << s);
+            reset();
+        }
+        // shall not be copied nor moved
+        Oversampler(Oversampler&&)                 = delete;
+        Oversampler(Oversampler const&)            = delete;
+        Oversampler& operator=(Oversampler&&)      = delete;
+        Oversampler& operator=(Oversampler const&) = delete;
+
+        // 0 = off, 1 = 2x, 2 = 4x, 3 = 8x
+        void setStages(int count)
+        {
+            if (count < 0)
+                count = 0;
+            else if (count > MAX_STAGES)
+                count = MAX_STAGES;
+            if (count != stages)
+            {
+                stages = count;
+                reset(); // stale history from another rate would click
+            }
+        }
+        int getStages() const { return stages; }
+        // in base rate samples
+        int latency() const { return halfband::latency(stages); }
+
+        void reset()
+        {
+            first.reset();
+            for (auto& stage : outer)
+                stage.reset();
+            memset(padExt.get(), 0, MAX_PADDING * sizeof(float));
+        }
+
+        size_t prefault()
+        {
+            size_t bytes = prefaultPages(workA, maxFrames << MAX_STAGES)
+                         + prefaultPages(workB, maxFrames << MAX_STAGES)
+                         + prefaultPages(padExt, MAX_PADDING + (maxFrames << MAX_STAGES))
+                         + first.prefault();
+            for (auto& stage : outer)
+                bytes += stage.prefault();
+            return bytes;
+        }
+
+        // returns a buffer of frames << stages samples
+        float *up(const float *in, int frames)
+        {
+            float *cur = workA.get();
+            float *other = workB.get();
+            first.up(in, cur, frames);
+            for (int s = 1; s < stages; ++s)
+            {
+                outer[s - 1].up(cur, other, frames << s);
+                std::swap(cur, other);
+            }
+            shaped = cur;
+            spare = other;
+            return shaped;
+        }
+
+        // frames is at the base rate, as given to up()
+        void down(float *out, int frames)
+        {
+            float *cur = shaped;
+            float *other = spare;
+            int pad = halfband::padding(stages);
+            if (pad)
+            {
+                int high = frames << stages;
+                float *ext = padExt.get();
+                memcpy(ext + pad, cur, high * sizeof(float));
+                memcpy(cur, ext, high * sizeof(float));
+                memmove(ext, ext + high, pad * sizeof(float));
+            }
+            for (int s = stages - 1; s > 0; --s)
+            {
+                outer[s - 1].down(cur, other, frames << s);
+                std::swap(cur, other);
+            }
+            first.down(cur, out, frames);
+        }
+
+    private:
+        int stages;
+        HalfBandStage<8> first;
+        HalfBandStage<4> outer[MAX_STAGES - 1];
+        Samples workA;
+        Samples workB;
+        Samples padExt;
+        float *shaped;
+        float *spare;
+        size_t maxFrames;
+};
+
+#endif /*OVERSAMPLER_H*/
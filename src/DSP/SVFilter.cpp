@@ -27,6 +27,7 @@
 
 #include "Misc/SynthEngine.h"
 #include "DSP/SVFilter.h"
+#include "DSP/Lanes.h"
 #include "Misc/NumericFuncs.h"
 
 
@@ -37,7 +38,6 @@ SVFilter::SVFilter(SynthEngine *_synth, uchar _type, float _freq, float _q, ucha
     q(_q),
     needsinterpolation(0),
     firsttime(1),
-    tmpismp(_synth->buffersize),
     synth(_synth)
 {
     if (stages >= MAX_FILTER_STAGES)
@@ -59,7 +59,6 @@ SVFilter::SVFilter(const SVFilter &orig) :
     oldabovenq(orig.oldabovenq),
     needsinterpolation(orig.needsinterpolation),
     firsttime(orig.firsttime),
-    tmpismp(orig.synth->buffersize),
     synth(orig.synth)
 {
     outgain = orig.outgain;
@@ -145,57 +144,84 @@ void SVFilter::setstages(int stages_)
 }
 
 
-void SVFilter::singlefilterout(float *smp, fstage &x, parameters &par)
+/*
+ * A state variable filter copes well with its coefficients moving under
+ * it, so a fast change is ramped across the buffer rather than running
+ * the buffer through the old and new settings and crossfading.
+ * Left and right run in two lanes, each going through the whole cascade
+ * per sample, which keeps the stages overlapping in the pipeline.
+ * A mono filter is its own twin, so both lanes come out the same.
+ */
+void SVFilter::laneFilterout(SVFilter& right, float* smpl, float* smpr)
 {
-    float *out = NULL;
-    switch (type)
+    using lanes::Four;
+    parameters const& lfrom = needsinterpolation ? ipar : par;
+    parameters const& rfrom = right.needsinterpolation ? right.ipar : right.par;
+    const float step = 1.0f / synth->sent_buffersize_f;
+    Four f{lfrom.f, rfrom.f, 0.0f, 0.0f};
+    Four q{lfrom.q, rfrom.q, 0.0f, 0.0f};
+    Four q_sqrt{lfrom.q_sqrt, rfrom.q_sqrt, 0.0f, 0.0f};
+    const Four df = (Four{par.f, right.par.f, 0.0f, 0.0f} - f) * step;
+    const Four dq = (Four{par.q, right.par.q, 0.0f, 0.0f} - q) * step;
+    const Four dq_sqrt = (Four{par.q_sqrt, right.par.q_sqrt, 0.0f, 0.0f} - q_sqrt) * step;
+
+    const int count = stages + 1;
+    Four low[MAX_FILTER_STAGES + 1], band[MAX_FILTER_STAGES + 1];
+    for (int s = 0; s < count; ++s)
     {
-        case 0:
-            out = &x.low;
-            break;
-        case 1:
-            out = &x.high;
-            break;
-        case 2:
-            out = &x.band;
-            break;
-        case 3:
-            out = &x.notch;
-            break;
+        low[s] = Four{st[s].low, right.st[s].low, 0.0f, 0.0f};
+        band[s] = Four{st[s].band, right.st[s].band, 0.0f, 0.0f};
     }
-
     for (int i = 0; i < synth->sent_buffersize; ++i)
     {
-        x.low = x.low + par.f * x.band;
-        x.high = par.q_sqrt * smp[i] - x.low - par.q * x.band;
-        x.band = par.f * x.high + x.band;
-        x.notch = x.high + x.low;
-        smp[i] = (*out);
+        Four v{smpl[i], smpr[i], 0.0f, 0.0f};
+        for (int s = 0; s < count; ++s)
+        {
+            low[s] = low[s] + f * band[s];
+            Four high = q_sqrt * v - low[s] - q * band[s];
+            band[s] = f * high + band[s];
+            Four notch = high + low[s];
+            switch (type)
+            {
+                case 0: v = low[s]; break;
+                case 1: v = high; break;
+                case 2: v = band[s]; break;
+                default: v = notch; break;
+            }
+        }
+        smpl[i] = v[0] * outgain;
+        smpr[i] = v[1] * right.outgain;
+        f += df;
+        q += dq;
+        q_sqrt += dq_sqrt;
+    }
+
+    // high and notch are worked out afresh every sample, so aren't kept
+    for (int s = 0; s < count; ++s)
+    {
+        st[s].low = low[s][0];
+        st[s].band = band[s][0];
+        right.st[s].low = low[s][1];
+        right.st[s].band = band[s][1];
     }
+    needsinterpolation = 0;
+    right.needsinterpolation = 0;
 }
 
 
 void SVFilter::filterout(float *smp)
 {
-    if (needsinterpolation)
-    {
-        memcpy(tmpismp.get(), smp, synth->sent_bufferbytes);
-        for (int i = 0; i < stages + 1; ++i)
-            singlefilterout(tmpismp.get(), st[i],ipar);
-    }
+    laneFilterout(*this, smp, smp);
+}
 
-    for (int i = 0; i < stages + 1; ++i)
-        singlefilterout(smp, st[i],par);
 
-    if (needsinterpolation)
+void SVFilter::filterStereo(float* smpl, float* smpr, Filter_& right)
+{
+    SVFilter* twin = dynamic_cast<SVFilter*>(&right);
+    if (!twin || twin == this || twin->stages != stages || twin->type != type)
     {
-        for (int i = 0; i < synth->sent_buffersize; ++i)
-        {
-            float x = (float)i / synth->sent_buffersize_f;
-            smp[i] = tmpismp[i] * (1.0f - x) + smp[i] * x;
-        }
-        needsinterpolation = 0;
+        Filter_::filterStereo(smpl, smpr, right);
+        return;
     }
-    for (int i = 0; i < synth->sent_buffersize; ++i)
-        smp[i] *= outgain;
+    laneFilterout(*twin, smpl, smpr);
 }
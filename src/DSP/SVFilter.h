@@ -27,7 +27,6 @@
 #define SV_FILTER_H
 
 #include "DSP/Filter_.h"
-#include "Misc/Alloc.h"
 
 
 class SynthEngine;
@@ -41,6 +40,7 @@ class SVFilter : public Filter_
         Filter_* clone() override { return new SVFilter(*this); };
 
         void filterout(float* smp);
+        void filterStereo(float* smpl, float* smpr, Filter_& right) override;
         void setfreq(float frequency);
         void setfreq_and_q(float frequency, float q_);
         void setq(float q_);
@@ -58,7 +58,7 @@ class SVFilter : public Filter_
             float f, q, q_sqrt;
         } par, ipar;
 
-        void singlefilterout(float* smp, fstage& x, parameters& par);
+        void laneFilterout(SVFilter& right, float* smpl, float* smpr);
         void computefiltercoefs();
         int type;      // The type of the filter (LPF1,HPF1,LPF2,HPF2...)
         int stages;    // how many times the filter is applied (0->1,1->2,etc.)
@@ -68,7 +68,6 @@ class SVFilter : public Filter_
         int abovenq;   // this is 1 if the frequency is above the nyquist
         int oldabovenq;
         int needsinterpolation, firsttime;
-        Samples tmpismp; // used if it needs interpolation in filterout()
 
         SynthEngine *synth;
 };
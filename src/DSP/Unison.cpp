@@ -40,16 +40,24 @@ Unison::Unison(int update_period_samples_, float max_delay_sec_, SynthEngine* _s
     : unison_size{0}
     , base_freq{1.0f}
     , max_delay{std::max(10, int(_synth->samplerate_f * max_delay_sec_) + 1)}
+    , delay_mask{1}
     , delay_k{0}
     , first_time{false}
     , voice{}
-    , delay_buffer{new float[max_delay]{0}}  // zero-init
+    , realpos1{}
+    , realpos2{}
+    , polarity{}
+    , delay_buffer{}
     , update_period_samples{update_period_samples_}
     , update_period_sample_k{0}
     , unison_amplitude_samples{0.0f}
     , unison_bandwidth_cents{10.0f}
     , synth{_synth}
 {
+    while (delay_mask < uint(max_delay))
+        delay_mask <<= 1;
+    delay_buffer.reset(new float[delay_mask]{0}); // zero-init
+    delay_mask -= 1;
     setSize(1);
 }
 
@@ -61,9 +69,13 @@ void Unison::setSize(int new_size)
         new_size = 1;
     unison_size = new_size;
     voice.reset(new UnisonVoice[unison_size]);
+    realpos1.reset(new float[unison_size]{0});
+    realpos2.reset(new float[unison_size]{0});
+    polarity.reset(new float[unison_size]);
     for (int i = 0; i < unison_size; ++i)
     {
         voice [i].setPosition(synth->numRandom() * 1.8f - 0.9f);
+        polarity[i] = (i & 1) ? -1.0f : 1.0f;
     }
     first_time = true;
     updateParameters();
@@ -117,6 +129,18 @@ void Unison::updateParameters()
 }
 
 
+size_t Unison::prefault()
+{
+    return prefaultPages(delay_buffer.get(), (delay_mask + 1) * sizeof(float));
+}
+
+
+/*
+ * The update period is handled between runs of samples, so the loop
+ * over the voices has no branches and no wrapping other than the mask,
+ * and can be vectorised across the voices. Each update is followed by
+ * update_period_samples + 1 samples before the next, as it always has.
+ */
 void Unison::process(int bufsize, float* inbuf, float* outbuf)
 {
     if (!voice)
@@ -127,35 +151,45 @@ void Unison::process(int bufsize, float* inbuf, float* outbuf)
     float volume = 1.0f / sqrtf(unison_size);
     float xpos_step = 1.0f / update_period_samples;
     float xpos = float(update_period_sample_k) * xpos_step;
-    for (int i = 0; i < bufsize; ++i)
+    const float *from = realpos1.get();
+    const float *to = realpos2.get();
+    const float *sign = polarity.get();
+    const float *buffer = delay_buffer.get();
+    const uint mask = delay_mask;
+
+    int i = 0;
+    while (i < bufsize)
     {
-        if (update_period_sample_k++ >= update_period_samples)
+        int run;
+        if (update_period_sample_k >= update_period_samples)
         {
             updateUnisonData();
-            update_period_sample_k = 0;
             xpos = 0.0f;
+            run = std::min(bufsize - i, update_period_samples + 1);
+            update_period_sample_k = run - 1;
         }
-        xpos += xpos_step;
-        float in = inbuf[i];
-        float out = 0.0f;
-        float sign = 1.0f;
-        for (int k = 0; k < unison_size; ++k)
+        else
+        {
+            run = std::min(bufsize - i, update_period_samples - update_period_sample_k);
+            update_period_sample_k += run;
+        }
+
+        for (int end = i + run; i < end; ++i)
         {
-            float vpos = voice[k].realpos1 * (1.0f - xpos) + voice[k].realpos2 * xpos;
-            float pos  = float(delay_k + max_delay) - vpos - 1.0f;
-            int posi = int(pos);
-            int posi_next = posi + 1;
-            if (posi >= max_delay)
-                posi -= max_delay;
-            if (posi_next >= max_delay)
-                posi_next -= max_delay;
-            float posf = pos - floorf(pos);
-            out += ((1.0f - posf) * delay_buffer[posi] + posf * delay_buffer[posi_next]) * sign;
-            sign = -sign;
+            xpos += xpos_step;
+            float out = 0.0f;
+            for (int k = 0; k < unison_size; ++k)
+            {
+                float vpos = from[k] * (1.0f - xpos) + to[k] * xpos;
+                int whole = int(vpos);
+                float frac = vpos - whole;
+                uint posi = delay_k - whole - 1;
+                out += ((1.0f - frac) * buffer[posi & mask] + frac * buffer[(posi - 1) & mask]) * sign[k];
+            }
+            outbuf[i] = out * volume;
+            delay_buffer[delay_k] = inbuf[i];
+            delay_k = (delay_k + 1) & mask;
         }
-        outbuf[i] = out * volume;
-        delay_buffer[delay_k] = in;
-        delay_k = (++delay_k < max_delay) ? delay_k : 0;
     }
 }
 
@@ -194,11 +228,11 @@ void Unison::updateUnisonData()
         newval = 1.0f + 0.5f * (vibratoFactor + 1.0f) * unison_amplitude_samples * voice[k].relative_amplitude;
 
         if (first_time)
-            voice[k].realpos1 = voice[k].realpos2 = newval;
+            realpos1[k] = realpos2[k] = newval;
         else
         {
-            voice[k].realpos1 = voice[k].realpos2;
-            voice[k].realpos2 = newval;
+            realpos1[k] = realpos2[k];
+            realpos2[k] = newval;
         }
         voice[k].position = pos;
         voice[k].step     = step;
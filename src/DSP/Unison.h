@@ -44,6 +44,7 @@ class Unison
         void setBandwidth(float bandwidth_cents);
 
         void process(int bufsize, float* inbuf, float* outbuf = nullptr);
+        size_t prefault();
 
     private:
         void updateParameters();
@@ -52,14 +53,10 @@ class Unison
         struct UnisonVoice {
             float step;     // base LFO
             float position;
-            float realpos1; // the position regarding samples
-            float realpos2;
             float relative_amplitude;
             UnisonVoice()
                 : step{0.0f}
                 , position{}
-                , realpos1{}
-                , realpos2{}
                 , relative_amplitude{1.0f}
             { }
 
@@ -70,10 +67,16 @@ class Unison
         };
         int   unison_size;
         float base_freq;
-        int   max_delay, delay_k;
+        int   max_delay;
+        uint  delay_mask;   // the buffer is a power of two long
+        uint  delay_k;
         bool  first_time;
 
         std::unique_ptr<UnisonVoice[]> voice;
+        // kept apart from the voices so process() can run across them
+        std::unique_ptr<float[]> realpos1; // the positions regarding samples
+        std::unique_ptr<float[]> realpos2;
+        std::unique_ptr<float[]> polarity; // alternate voices are inverted
         std::unique_ptr<float[]> delay_buffer;
 
         int   update_period_samples;
@@ -56,12 +56,8 @@ Alienwah::~Alienwah()
 void Alienwah::out(float *smpsl, float *smpsr)
 {
     outvolume.advanceValue(synth.sent_buffersize);
+    float bias = denormal::bias(1e-20f); // taken into the input, the caller's buffers are left alone
 
-    for (int i = 0; i < synth.sent_buffersize; ++i)
-    {
-            smpsl[i] += float(1e-20); // anti-denormal
-            smpsr[i] += float(1e-20); // anti-denormal
-    }
     float lfol;
     float lfor; // Left/Right LFOs
     complex<float> clfol, clfor, out, tmp;
@@ -79,7 +75,7 @@ void Alienwah::out(float *smpsl, float *smpsr)
         tmp = clfol * x + oldclfol * x1;
 
         out = tmp * oldl[oldk];
-        out += (1 - abs(fb)) * smpsl[i] * pangainL.getAndAdvanceValue();
+        out += (1 - abs(fb)) * (smpsl[i] + bias) * pangainL.getAndAdvanceValue();
 
         oldl[oldk] = out;
         float l = out.real() * 10.0f * (fb + 0.1f);
@@ -88,7 +84,7 @@ void Alienwah::out(float *smpsl, float *smpsr)
         tmp = clfor * x + oldclfor * x1;
 
         out = tmp * oldr[oldk];
-        out += (1 - abs(fb)) * smpsr[i] * pangainR.getAndAdvanceValue();
+        out += (1 - abs(fb)) * (smpsr[i] + bias) * pangainR.getAndAdvanceValue();
 
         oldr[oldk] = out;
         float r = out.real() * 10.0f * (fb + 0.1f);
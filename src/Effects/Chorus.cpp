@@ -38,10 +38,18 @@ Chorus::Chorus(bool insertion_, float *const efxoutl_, float *efxoutr_, SynthEng
     lfo(synth),
     fb(0, synth.samplerate)
 {
-    dlk = drk = 0;
+    writePos = 0;
     maxdelay = (int)(MAX_CHORUS_DELAY / 1000.0f * synth.samplerate_f);
-    delayl = new float[maxdelay];
-    delayr = new float[maxdelay];
+    // room for the longest delay plus a buffer being written
+    uint lineSize = 1;
+    while (lineSize < uint(maxdelay + synth.buffersize + 4))
+        lineSize <<= 1;
+    delayMask = lineSize - 1;
+    delayl.reset(lineSize);
+    delayr.reset(lineSize);
+    inputl.reset(synth.buffersize);
+    inputr.reset(synth.buffersize);
+    ramp.reset(synth.buffersize);
     setpreset(Ppreset);
 
     changepar(1, 64);
@@ -73,7 +81,6 @@ void Chorus::out(float *smpsl, float *smpsr)
 {
     outvolume.advanceValue(synth.sent_buffersize);
 
-    const float one = 1.0f;
     dl1 = dl2;
     dr1 = dr2;
     lfo.effectlfoout(&lfol, &lfor);
@@ -81,48 +88,20 @@ void Chorus::out(float *smpsl, float *smpsr)
     dl2 = getdelay(lfol);
     dr2 = getdelay(lfor);
 
-    float inL, inR, tmpL, tmpR, tmp;
+    // LRcross
+    fillRamp(lrcross, ramp.get());
     for (int i = 0; i < synth.sent_buffersize; ++i)
     {
-        tmpL = smpsl[i];
-        tmpR = smpsr[i];
-        // LRcross
-        inL = tmpL * (1.0f - lrcross.getValue()) + tmpR * lrcross.getValue();
-        inR = tmpR * (1.0f - lrcross.getValue()) + tmpL * lrcross.getValue();
-        lrcross.advanceValue();
-
-        // Left channel
-
-        // compute the delay in samples using linear interpolation between the lfo delays
-        mdel = (dl1 * (synth.sent_buffersize - i) + dl2 * i) / synth.sent_buffersize_f;
-        if (++dlk >= maxdelay)
-            dlk = 0;
-        tmp = dlk - mdel + maxdelay * 2.0f; // where should I get the sample from
-        dlhi = int(tmp);
-        dlhi %= maxdelay;
-
-        dlhi2 = (dlhi - 1 + maxdelay) % maxdelay;
-        dllo = 1.0f - fmodf(tmp, one);
-        efxoutl[i] = delayl[dlhi2] * dllo + delayl[dlhi] * (1.0f - dllo);
-        delayl[dlk] = inL + efxoutl[i] * fb.getValue();
-
-        // Right channel
-
-        // compute the delay in samples using linear interpolation between the lfo delays
-        mdel = (dr1 * (synth.sent_buffersize - i) + dr2 * i) / synth.sent_buffersize_f;
-        if (++drk >= maxdelay)
-            drk = 0;
-        tmp = drk * 1.0f - mdel + maxdelay * 2.0f; // where should I get the sample from
-        dlhi = int(tmp);
-        dlhi %= maxdelay;
-        dlhi2 = (dlhi - 1 + maxdelay) % maxdelay;
-        dllo = 1.0f - fmodf(tmp, one);
-        efxoutr[i] = delayr[dlhi2] * dllo + delayr[dlhi] * (1.0f - dllo);
-        delayr[dlk] = inR + efxoutr[i] * fb.getValue();
-
-        fb.advanceValue();
+        float cross = ramp[i];
+        inputl[i] = smpsl[i] * (1.0f - cross) + smpsr[i] * cross;
+        inputr[i] = smpsr[i] * (1.0f - cross) + smpsl[i] * cross;
     }
 
+    fillRamp(fb, ramp.get());
+    delayLine(delayl.get(), inputl.get(), efxoutl, dl1, dl2);
+    delayLine(delayr.get(), inputr.get(), efxoutr, dr1, dr2);
+    writePos += synth.sent_buffersize;
+
     if (Poutsub)
         for (int i = 0; i < synth.sent_buffersize; ++i)
         {
@@ -138,17 +117,105 @@ void Chorus::out(float *smpsl, float *smpsr)
 }
 
 
+// Per sample values of an interpolated parameter for this buffer
+void Chorus::fillRamp(synth::InterpolatedValue<float>& value, float *values)
+{
+    if (!value.isInterpolating())
+    {
+        float steady = value.getValue();
+        for (int i = 0; i < synth.sent_buffersize; ++i)
+            values[i] = steady;
+        return;
+    }
+    for (int i = 0; i < synth.sent_buffersize; ++i)
+        values[i] = value.getAndAdvanceValue();
+}
+
+
+/*
+ * Reads and feeds one delay line for the whole buffer, the delay moving
+ * linearly from one lfo value to the next. A sample written to the line
+ * can't be read back until the shortest delay has passed, so the buffer
+ * is worked in runs of that length: all the reads of a run then all its
+ * writes, with no loop depending on its own results and no wrapping
+ * other than the mask. Chorus delays are usually longer than a buffer
+ * so there is only one run, flange delays may come down to single
+ * samples. Cubic interpolation reads one sample further ahead so it
+ * needs at least one whole sample of delay, below that it falls back
+ * to linear.
+ */
+void Chorus::delayLine(float *line, const float *input, float *output, float from, float to)
+{
+    const int frames = synth.sent_buffersize;
+    const float step = (to - from) / synth.sent_buffersize_f;
+    const uint mask = delayMask;
+    const uint start = writePos + 1;
+    const float *feedback = ramp.get();
+
+    int shortest = int(std::min(from, to));
+    bool cubic = Pcubic && shortest >= 1;
+    int run = std::min(cubic ? shortest : shortest + 1, frames);
+
+    for (int first = 0; first < frames; first += run)
+    {
+        int last = std::min(first + run, frames);
+        if (cubic)
+        {
+            for (int i = first; i < last; ++i)
+            {
+                float delay = from + step * i + 1.0f;
+                int whole = int(delay);
+                float frac = delay - whole;
+                uint pos = start + i - whole;
+                float newer = line[(pos + 1) & mask];
+                float y0 = line[pos & mask];
+                float y1 = line[(pos - 1) & mask];
+                float older = line[(pos - 2) & mask];
+                // Catmull-Rom, from y0 towards y1
+                float c1 = 0.5f * (y1 - newer);
+                float c2 = newer - 2.5f * y0 + 2.0f * y1 - 0.5f * older;
+                float c3 = 0.5f * (older - newer) + 1.5f * (y0 - y1);
+                output[i] = ((c3 * frac + c2) * frac + c1) * frac + y0;
+            }
+        }
+        else
+        {
+            for (int i = first; i < last; ++i)
+            {
+                float delay = from + step * i + 1.0f;
+                int whole = int(delay);
+                float frac = delay - whole;
+                uint pos = start + i - whole;
+                output[i] = line[pos & mask] * (1.0f - frac) + line[(pos - 1) & mask] * frac;
+            }
+        }
+        for (int i = first; i < last; ++i)
+            line[(start + i) & mask] = input[i] + output[i] * feedback[i];
+    }
+}
+
+
 // Cleanup the effect
 void Chorus::cleanup()
 {
     Effect::cleanup();
     fb.pushToTarget();
-    for (int i = 0; i < maxdelay; ++i)
-        delayl[i] = delayr[i] = 0.0f;
+    memset(delayl.get(), 0, (delayMask + 1) * sizeof(float));
+    memset(delayr.get(), 0, (delayMask + 1) * sizeof(float));
     lfo.resetState();
 }
 
 
+size_t Chorus::prefault()
+{
+    return prefaultPages(delayl, delayMask + 1)
+         + prefaultPages(delayr, delayMask + 1)
+         + prefaultPages(inputl, synth.buffersize)
+         + prefaultPages(inputr, synth.buffersize)
+         + prefaultPages(ramp, synth.buffersize);
+}
+
+
 // Parameter control
 void Chorus::setdepth(unsigned char Pdepth_)
 {
@@ -255,6 +322,9 @@ void Chorus::changepar(int npar, unsigned char value)
         case 11:
             Poutsub = (value > 1) ? 1 : value;
             break;
+        case 12:
+            Pcubic = (value > 1) ? 1 : value;
+            break;
         case EFFECT::control::bpm:
             lfo.Pbpm = value;
             break;
@@ -285,6 +355,7 @@ unsigned char Chorus::getpar(int npar) const
         case 9:  return Plrcross;
         case 10: return Pflangemode;
         case 11: return Poutsub;
+        case 12: return Pcubic;
         case EFFECT::control::bpm: return lfo.Pbpm;
         case EFFECT::control::bpmStart: return lfo.PbpmStart;
         default: return 0;
@@ -329,6 +400,7 @@ float Choruslimit::getlimits(CommandBlock *getData)
         case 9:
             break;
         case 11:
+        case 12:
             max = 1;
             canLearn = 0;
             break;
@@ -28,32 +28,33 @@
 #ifndef CHORUS_H
 #define CHORUS_H
 
+#include "Misc/Alloc.h"
 #include "Effects/Effect.h"
 #include "Effects/EffectLFO.h"
 
-static const int chorusPRESET_SIZE = 12;
+static const int chorusPRESET_SIZE = 13;
 static const int chorusNUM_PRESETS = 10;
 static const unsigned char chorusPresets[chorusNUM_PRESETS][chorusPRESET_SIZE] = {
         // Chorus1
-        { 64, 64, 50, 0, 0, 90, 40, 85, 64, 119, 0, 0 },
+        { 64, 64, 50, 0, 0, 90, 40, 85, 64, 119, 0, 0, 0 },
         // Chorus2
-        {64, 64, 45, 0, 0, 98, 56, 90, 64, 19, 0, 0 },
+        {64, 64, 45, 0, 0, 98, 56, 90, 64, 19, 0, 0, 0 },
         // Chorus3
-        {64, 64, 29, 0, 1, 42, 97, 95, 90, 127, 0, 0 },
+        {64, 64, 29, 0, 1, 42, 97, 95, 90, 127, 0, 0, 0 },
         // Celeste1
-        {64, 64, 26, 0, 0, 42, 115, 18, 90, 127, 0, 0 },
+        {64, 64, 26, 0, 0, 42, 115, 18, 90, 127, 0, 0, 0 },
         // Celeste2
-        {64, 64, 29, 117, 0, 50, 115, 9, 31, 127, 0, 1 },
+        {64, 64, 29, 117, 0, 50, 115, 9, 31, 127, 0, 1, 0 },
         // Flange1
-        {64, 64, 57, 0, 0, 60, 23, 3, 62, 0, 0, 0 },
+        {64, 64, 57, 0, 0, 60, 23, 3, 62, 0, 0, 0, 0 },
         // Flange2
-        {64, 64, 33, 34, 1, 40, 35, 3, 109, 0, 0, 0 },
+        {64, 64, 33, 34, 1, 40, 35, 3, 109, 0, 0, 0, 0 },
         // Flange3
-        {64, 64, 53, 34, 1, 94, 35, 3, 54, 0, 0, 1 },
+        {64, 64, 53, 34, 1, 94, 35, 3, 54, 0, 0, 1, 0 },
         // Flange4
-        {64, 64, 40, 0, 1, 62, 12, 19, 97, 0, 0, 0 },
+        {64, 64, 40, 0, 1, 62, 12, 19, 97, 0, 0, 0, 0 },
         // Flange5
-        {64, 64, 55, 105, 0, 24, 39, 19, 17, 0, 0, 1 }
+        {64, 64, 55, 105, 0, 24, 39, 19, 17, 0, 0, 1, 0 }
 };
 
 class SynthEngine;
@@ -69,6 +70,8 @@ class Chorus : public Effect
         void changepar(int npar, unsigned char value) override;
         unsigned char getpar(int npar) const override;
         void cleanup() override;
+        size_t prefault() override;
+        int quietHold() const override { return maxdelay; }
 
     private:
         // Chorus Parameters
@@ -79,6 +82,7 @@ class Chorus : public Effect
         unsigned char Pfb;         // feedback
         unsigned char Pflangemode; // how the LFO is scaled, to result chorus or flange
         unsigned char Poutsub;     // if I wish to subtract the output instead of the adding it
+        unsigned char Pcubic;      // cubic rather than linear delay interpolation
         EffectLFO lfo;             // lfo-ul chorus
 
 
@@ -88,6 +92,8 @@ class Chorus : public Effect
         void setdelay(unsigned char Pdelay_);
         void setfb(unsigned char Pfb_);
         float getdelay(float xlfo);
+        void fillRamp(synth::InterpolatedValue<float>& value, float *values);
+        void delayLine(float *line, const float *input, float *output, float from, float to);
 
         // Internal Values
         float depth;
@@ -100,15 +106,14 @@ class Chorus : public Effect
         float lfol;
         float lfor;
 
-        float *delayl;
-        float *delayr;
-        int maxdelay;
-        int dlk;
-        int drk;
-        int dlhi;
-        int dlhi2;
-        float dllo;
-        float mdel;
+        int maxdelay;     // the longest delay allowed, in samples
+        uint delayMask;   // the lines are a power of two long
+        uint writePos;
+        Samples delayl;
+        Samples delayr;
+        Samples inputl;   // the inputs after L/R crossing
+        Samples inputr;
+        Samples ramp;     // per sample values of an interpolated parameter
 };
 class Choruslimit
 {
@@ -44,9 +44,12 @@ Distorsion::Distorsion(bool insertion_, float *efxoutl_, float *efxoutr_, SynthE
     Phpf(0),
     Pstereo(1),
     Pprefiltering(0),
+    Poversample(0),
     level(0, synth.samplerate),
     lpffr(0, synth.samplerate),
-    hpffr(0, synth.samplerate)
+    hpffr(0, synth.samplerate),
+    oversampleL(synth.buffersize),
+    oversampleR(synth.buffersize)
 {
     level.setTargetValue(Plevel / 127.0f);
     lpfl = new AnalogFilter(synth, TOPLEVEL::filter::Low2, 22000, 1, 0);
@@ -80,6 +83,14 @@ void Distorsion::cleanup()
     hpfl->cleanup();
     lpfr->cleanup();
     hpfr->cleanup();
+    oversampleL.reset();
+    oversampleR.reset();
+}
+
+
+size_t Distorsion::prefault()
+{
+    return oversampleL.prefault() + oversampleR.prefault();
 }
 
 
@@ -97,8 +108,7 @@ void Distorsion::applyfilters(float *efxoutl, float *efxoutr)
         lpfr->interpolatenextbuffer();
         lpfr->setfreq(lpffr.getValue());
     }
-    lpfl->filterout(efxoutl);
-    lpfr->filterout(efxoutr);
+    lpfl->filterStereo(efxoutl, efxoutr, *lpfr);
 
     fr = hpffr.getValue();
     hpffr.advanceValue(synth.sent_buffersize);
@@ -109,8 +119,7 @@ void Distorsion::applyfilters(float *efxoutl, float *efxoutr)
         hpfr->interpolatenextbuffer();
         hpfr->setfreq(hpffr.getValue());
     }
-    hpfl->filterout(efxoutl);
-    hpfr->filterout(efxoutr);
+    hpfl->filterStereo(efxoutl, efxoutr, *hpfr);
 }
 
 
@@ -140,9 +149,10 @@ void Distorsion::out(float *smpsl, float *smpsr)
     if (Pprefiltering)
         applyfilters(efxoutl, efxoutr);
 
-    waveShapeSmps(synth.sent_buffersize, efxoutl, Ptype + 1, Pdrive);
+    bool fast = synth.getRuntime().fastWaveshaping;
+    shape(efxoutl, oversampleL, fast);
     if (Pstereo)
-        waveShapeSmps(synth.sent_buffersize, efxoutr, Ptype + 1, Pdrive);
+        shape(efxoutr, oversampleR, fast);
 
     if (!Pprefiltering)
         applyfilters(efxoutl, efxoutr);
@@ -165,6 +175,25 @@ void Distorsion::out(float *smpsl, float *smpsr)
 }
 
 
+/*
+ * The waveshapers create harmonics well above Nyquist, which fold back
+ * as inharmonic aliases. Running just the shaper at a higher rate lets
+ * the half-band filters remove most of them before they can fold.
+ */
+void Distorsion::shape(float *smps, Oversampler& oversampler, bool fast)
+{
+    int frames = synth.sent_buffersize;
+    if (!Poversample)
+    {
+        waveShapeSmps(frames, smps, Ptype + 1, Pdrive, fast);
+        return;
+    }
+    float *high = oversampler.up(smps, frames);
+    waveShapeSmps(frames << Poversample, high, Ptype + 1, Pdrive, fast);
+    oversampler.down(smps, frames);
+}
+
+
 // Parameter control
 void Distorsion::setvolume(unsigned char Pvolume_)
 {
@@ -285,6 +314,12 @@ void Distorsion::changepar(int npar, unsigned char value)
         case 10:
             Pprefiltering = value;
             break;
+
+        case 11:
+            Poversample = (value > Oversampler::MAX_STAGES) ? Oversampler::MAX_STAGES : value;
+            oversampleL.setStages(Poversample);
+            oversampleR.setStages(Poversample);
+            break;
     }
     Pchanged = true;
 }
@@ -306,6 +341,7 @@ unsigned char Distorsion::getpar(int npar) const
         case 8:  return Phpf;
         case 9:  return Pstereo;
         case 10: return Pprefiltering;
+        case 11: return Poversample;
         default: break;
     }
     return 0; // in case of bogus parameter number
@@ -356,6 +392,10 @@ float Distlimit::getlimits(CommandBlock *getData)
             max = 1;
             canLearn = 0;
             break;
+        case 11:
+            max = Oversampler::MAX_STAGES;
+            canLearn = 0;
+            break;
         case 16:
             max = 5;
             canLearn = 0;
@@ -31,23 +31,24 @@
 #include "globals.h"
 #include "Misc/WaveShapeSamples.h"
 #include "DSP/AnalogFilter.h"
+#include "DSP/Oversampler.h"
 #include "Effects/Effect.h"
 
-    const int distPRESET_SIZE = 11;
+    const int distPRESET_SIZE = 12;
     const int distNUM_PRESETS = 6;
     const int distPresets[distNUM_PRESETS][distPRESET_SIZE] = {
         // Overdrive 1
-        { 127, 64, 35, 56, 70, 0, 0, 96, 0, 0, 0 },
+        { 127, 64, 35, 56, 70, 0, 0, 96, 0, 0, 0, 0 },
         // Overdrive 2
-        { 127, 64, 35, 29, 75, 1, 0, 127, 0, 0, 0 },
+        { 127, 64, 35, 29, 75, 1, 0, 127, 0, 0, 0, 0 },
         // A. Exciter 1
-        { 64, 64, 35, 75, 80, 5, 0, 127, 105, 1, 0 },
+        { 64, 64, 35, 75, 80, 5, 0, 127, 105, 1, 0, 0 },
         // A. Exciter 2
-        { 64, 64, 35, 85, 62, 1, 0, 127, 118, 1, 0 },
+        { 64, 64, 35, 85, 62, 1, 0, 127, 118, 1, 0, 0 },
         // Guitar Amp
-        { 127, 64, 35, 63, 75, 2, 0, 55, 0, 0, 0 },
+        { 127, 64, 35, 63, 75, 2, 0, 55, 0, 0, 0, 0 },
         // Quantise
-        { 127, 64, 35, 88, 75, 4, 0, 127, 0, 1, 0 }
+        { 127, 64, 35, 88, 75, 4, 0, 127, 0, 1, 0, 0 }
     };
 
 class SynthEngine;
@@ -63,6 +64,8 @@ class Distorsion : public Effect, WaveShapeSamples
         void changepar(int npar, uchar value) override;
         uchar getpar(int npar)          const override;
         void cleanup()                        override;
+        size_t prefault()                     override;
+        int latency()                   const override { return oversampleL.latency(); }
 
         void applyfilters(float* efxoutl, float* efxoutr);
 
@@ -78,10 +81,12 @@ class Distorsion : public Effect, WaveShapeSamples
         uchar Phpf;          // Highpass filter
         uchar Pstereo;       // 0 = mono, 1 = stereo
         uchar Pprefiltering; // if you want to do the filtering before the distortion
+        uchar Poversample;   // 0 = off, 1 = 2x, 2 = 4x, 3 = 8x
 
         void setvolume(uchar Pvolume_);
         void setlpf(uchar Plpf_);
         void sethpf(uchar Phpf_);
+        void shape(float* smps, Oversampler& oversampler, bool fast);
 
         synth::InterpolatedValue<float> level;
 
@@ -92,6 +97,8 @@ class Distorsion : public Effect, WaveShapeSamples
         AnalogFilter* hpfr;
         synth::InterpolatedValue<float> lpffr;
         synth::InterpolatedValue<float> hpffr;
+        Oversampler oversampleL;
+        Oversampler oversampleR;
 };
 
 class Distlimit
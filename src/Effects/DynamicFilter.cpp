@@ -91,8 +91,7 @@ void DynamicFilter::out(float *smpsl, float *smpsr)
     filterl->setfreq_and_q(frl, q);
     filterr->setfreq_and_q(frr, q);
 
-    filterl->filterout(efxoutl);
-    filterr->filterout(efxoutr);
+    filterl->filterStereo(efxoutl, efxoutr, *filterr);
 
     // panning
     for (int i = 0; i < synth.sent_buffersize; ++i)
@@ -119,8 +119,7 @@ void EQ::out(float *smpsl, float *smpsr)
             filter[i].r->setq(newval);
         }
 
-        filter[i].l->filterout(efxoutl);
-        filter[i].r->filterout(efxoutr);
+        filter[i].l->filterStereo(efxoutl, efxoutr, *filter[i].r);
     }
 }
 
@@ -82,6 +82,13 @@ void Echo::cleanup()
 }
 
 
+size_t Echo::prefault()
+{
+    return prefaultPages(ldelay, maxdelay * sizeof(float))
+         + prefaultPages(rdelay, maxdelay * sizeof(float));
+}
+
+
 // Initialize the delays
 void Echo::initdelays()
 {
@@ -173,6 +180,7 @@ void Echo::out(float* smpsl, float* smpsr)
     outvolume.advanceValue(synth.sent_buffersize);
 
     initdelays();
+    float bias = denormal::bias(1e-20f);
 
     for (int i = 0; i < synth.sent_buffersize; ++i)
     {
@@ -209,8 +217,8 @@ void Echo::out(float* smpsl, float* smpsr)
             rdl = rdelay[targetpos] * (1.0f - rxfade.factor()) + rdl * rxfade.factor();
         }
 
-        ldl += float(1e-20); // anti-denormal included
-        rdl += float(1e-20); // anti-denormal included
+        ldl += bias; // anti-denormal included
+        rdl += bias;
 
         l = ldl * (1.0 - lrcross.getValue()) + rdl * lrcross.getValue();
         r = rdl * (1.0 - lrcross.getValue()) + ldl * lrcross.getValue();
@@ -218,8 +226,8 @@ void Echo::out(float* smpsl, float* smpsr)
         ldl = l;
         rdl = r;
 
-        efxoutl[i] = ldl * 2.0f - 1e-20f; // anti-denormal - a very, very, very
-        efxoutr[i] = rdl * 2.0f - 1e-20f; // small dc bias
+        efxoutl[i] = ldl * 2.0f - bias; // a very, very, very small dc bias
+        efxoutr[i] = rdl * 2.0f - bias;
 
         ldl = smpsl[i] * pangainL.getAndAdvanceValue() - ldl * feedback.getValue();
         rdl = smpsr[i] * pangainR.getAndAdvanceValue() - rdl * feedback.getValue();
@@ -29,6 +29,8 @@
 #ifndef ECHO_H
 #define ECHO_H
 
+#include <algorithm>
+
 #include "Effects/Effect.h"
 
 // The ratio which, when exceeded, causes the echo effect to update its internal
@@ -64,6 +66,8 @@ class Echo : public Effect
         void changepar(int npar, uchar value) override;
         uchar getpar(int npar)          const override;
         void cleanup()                        override;
+        size_t prefault()                     override;
+        int quietHold()                 const override { return std::max(dl, dr); }
 
         void setdryonly();
 
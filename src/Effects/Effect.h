@@ -66,6 +66,11 @@ class Effect
 
         virtual void out(float *smpsl, float *smpsr) = 0;
         virtual void cleanup();
+        virtual size_t prefault() { return 0; } // touch delay lines ahead of real-time use
+        // how long the output can stay silent while sound is still held inside
+        virtual int quietHold() const { return 0; }
+        // samples the wet output lags behind the input, at most Oversampler::MAX_LATENCY
+        virtual int latency() const { return 0; }
 
         uchar Ppreset; // Current preset
         float *const efxoutl;
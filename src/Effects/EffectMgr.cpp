@@ -38,6 +38,11 @@ EffectMgr::EffectMgr(const bool insertion_, SynthEngine& _synth) :
     filterpars{NULL},
     effectType{0}, // type none resolves to zero internally
     dryonly{false},
+    asleep{false},
+    quietFrames{0},
+    dryDelay{0},
+    dryl{size_t(Oversampler::MAX_LATENCY + _synth.buffersize)},
+    dryr{size_t(Oversampler::MAX_LATENCY + _synth.buffersize)},
     efx{}
 {
     defaults();
@@ -114,13 +119,28 @@ int EffectMgr::geteffect()
 // Cleanup the current effect
 void EffectMgr::cleanup()
 {
+    asleep = false;
+    quietFrames = 0;
     memset(efxoutl.get(), 0, synth.bufferbytes);
     memset(efxoutr.get(), 0, synth.bufferbytes);
+    dryDelay = 0;
     if (efx)
         efx->cleanup();
 }
 
 
+size_t EffectMgr::prefault()
+{
+    size_t bytes = prefaultPages(efxoutl, synth.buffersize)
+                 + prefaultPages(efxoutr, synth.buffersize)
+                 + prefaultPages(dryl, Oversampler::MAX_LATENCY + synth.buffersize)
+                 + prefaultPages(dryr, Oversampler::MAX_LATENCY + synth.buffersize);
+    if (efx)
+        bytes += efx->prefault();
+    return bytes;
+}
+
+
 // Get the preset of the current effect
 uchar EffectMgr::getpreset()
 {
@@ -180,7 +200,30 @@ void EffectMgr::out(float *smpsl, float *smpsr)
     }
     memset(efxoutl.get(), 0, synth.sent_bufferbytes);
     memset(efxoutr.get(), 0, synth.sent_bufferbytes);
+
+    bool silent = silentInput(smpsl, smpsr);
+    if (asleep)
+    {
+        if (silent)
+        {   // the dry signal of an insertion effect is already as good as silent
+            if (!insertion)
+            {
+                memset(smpsl, 0, synth.sent_bufferbytes);
+                memset(smpsr, 0, synth.sent_bufferbytes);
+            }
+            return;
+        }
+        asleep = false;
+        quietFrames = 0;
+    }
+
     efx->out(smpsl, smpsr);
+    if (silent)
+        checkTail();
+    else
+        quietFrames = 0;
+    if (synth.getRuntime().denormalCheck)
+        synth.denormals.scanEffect(effectType, efxoutl.get(), efxoutr.get(), synth.sent_buffersize);
 
     if (effectType == (EFFECT::type::eq - EFFECT::type::none))
     {   // this is need only for the EQ effect
@@ -192,6 +235,7 @@ void EffectMgr::out(float *smpsl, float *smpsr)
     // Insertion effect
     if (insertion != 0)
     {
+        delayDry(smpsl, smpsr);
         for (int i = 0; i < synth.sent_buffersize; ++i)
         {
             float volume = efx->volume.getAndAdvanceValue();
@@ -228,6 +272,9 @@ void EffectMgr::out(float *smpsl, float *smpsr)
     }
     else
     { // System effect
+        // only the wet signal is returned here; the dry one is mixed by the
+        // engine and is NOT held back, so an oversampled system effect
+        // still lands its latency later than the dry parts
         for (int i = 0; i < synth.sent_buffersize; ++i)
         {
             float volume = efx->volume.getAndAdvanceValue();
@@ -240,6 +287,71 @@ void EffectMgr::out(float *smpsl, float *smpsr)
 }
 
 
+/*
+ * Holds the dry signal back by the effect's latency, so mixing it with
+ * the wet signal doesn't comb filter. The history restarts from silence
+ * whenever the latency changes, as the effect itself does.
+ * This covers insertion (and part) effects only, as they mix their own
+ * dry signal; see the system effect branch of out().
+ */
+void EffectMgr::delayDry(float *smpsl, float *smpsr)
+{
+    int delay = efx->latency();
+    if (delay != dryDelay)
+    {
+        memset(dryl.get(), 0, Oversampler::MAX_LATENCY * sizeof(float));
+        memset(dryr.get(), 0, Oversampler::MAX_LATENCY * sizeof(float));
+        dryDelay = delay;
+    }
+    if (delay == 0)
+        return;
+    float *histl = dryl.get();
+    float *histr = dryr.get();
+    memcpy(histl + delay, smpsl, synth.sent_bufferbytes);
+    memcpy(histr + delay, smpsr, synth.sent_bufferbytes);
+    memcpy(smpsl, histl, synth.sent_bufferbytes);
+    memcpy(smpsr, histr, synth.sent_bufferbytes);
+    memmove(histl, histl + synth.sent_buffersize, delay * sizeof(float));
+    memmove(histr, histr + synth.sent_buffersize, delay * sizeof(float));
+}
+
+
+/*
+ * Anything below about -120dB is taken as silence. Effects with delay
+ * lines can go quiet between repeats, so the output has to stay below
+ * this for longer than the effect's own hold time before it sleeps.
+ */
+namespace {
+    constexpr float SILENCE_THRESHOLD = 1e-6f;
+}
+
+
+bool EffectMgr::silentInput(const float *smpsl, const float *smpsr) const
+{
+    int frames = synth.sent_buffersize;
+    float peak = meter::blockPeak(smpsl, frames, 0.0f);
+    peak = meter::blockPeak(smpsr, frames, peak);
+    return peak < SILENCE_THRESHOLD;
+}
+
+
+void EffectMgr::checkTail()
+{
+    int frames = synth.sent_buffersize;
+    float peak = meter::blockPeak(efxoutl.get(), frames, 0.0f);
+    peak = meter::blockPeak(efxoutr.get(), frames, peak);
+    if (peak >= SILENCE_THRESHOLD)
+    {
+        quietFrames = 0;
+        return;
+    }
+    quietFrames += frames;
+    // at least 50mS so feedback filters have properly settled
+    if (quietFrames > std::max(efx->quietHold(), int(synth.samplerate / 20)))
+        asleep = true;
+}
+
+
 // Get the effect volume for the system effect
 float EffectMgr::sysefxgetvolume()
 {
@@ -58,6 +58,10 @@ class EffectMgr : public ParamBase
         float sysefxgetvolume();
 
         void cleanup();
+        size_t prefault();
+
+        // nothing to do until some input arrives, an empty slot counts too
+        bool isAsleep() const { return !efx || asleep; }
 
         void changeeffect(int nefx_);
         int  geteffect();
@@ -79,8 +83,17 @@ class EffectMgr : public ParamBase
         FilterParams* filterpars;
 
     private:
+        bool silentInput(const float *smpsl, const float *smpsr) const;
+        void checkTail();
+        void delayDry(float *smpsl, float *smpsr);
+
         int effectType;
         bool dryonly;
+        bool asleep;
+        int quietFrames; // since the input was silent and the output below threshold
+        int dryDelay;    // what the dry history below was last kept for
+        Samples dryl;    // input history, so an insertion's dry signal lines up with its wet one
+        Samples dryr;
         unique_ptr<Effect> efx;
 };
 
@@ -47,7 +47,8 @@ Phaser::Phaser(bool insertion_, float *efxoutl_, float *efxoutr_, SynthEngine& _
     xn1l(NULL),
     xn1r(NULL),
     yn1l(NULL),
-    yn1r(NULL)
+    yn1r(NULL),
+    bias(0.0f)
 {
     analog_setup();
     setpreset(Ppreset);
@@ -107,6 +108,7 @@ Phaser::~Phaser()
 void Phaser::out(float *smpsl, float *smpsr)
 {
     outvolume.advanceValue(synth.sent_buffersize);
+    bias = denormal::bias(1e-12f);
 
     if (Panalog)
         AnalogPhase(smpsl, smpsr);
@@ -202,7 +204,7 @@ float Phaser::applyPhase(float x, float g, float fb,
         // This is 1/R. R is being modulated to control filter fc.
         float b    = (Rconst - g) / (d * Rmin);
         float gain = (CFs - b) / (CFs + b);
-        yn1[j] = (gain * (x + yn1[j]) - xn1[j]) + 1e-12; // anti-denormal
+        yn1[j] = gain * (x + yn1[j]) - xn1[j] + bias;
 
         // high pass filter:
         // Distortion depends on the high-pass part of the AP stage.
@@ -249,11 +251,11 @@ void Phaser::NormalPhase(float *smpsl, float *smpsr)
             // Left channel
             tmp = oldl[j];
             oldl[j] = gl * tmp + inl;
-            inl = (tmp - gl * oldl[j]) + 1e-12; // anti-denormal
+            inl = tmp - gl * oldl[j] + bias;
             // Right channel
             tmp = oldr[j];
             oldr[j] = gr * tmp + inr;
-            inr = (tmp - gr * oldr[j]) + 1e-12; // anti-denormal
+            inr = tmp - gr * oldr[j] + bias;
         }
 
         // Left/Right crossing
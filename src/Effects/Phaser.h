@@ -129,6 +129,7 @@ class Phaser : public Effect
         float Rconst;   // Handle parallel resistor relationship
         float C;        // Capacitor
         float CFs;      // A constant derived from capacitor and resistor relationships
+        float bias;     // anti-denormal, when the FPU doesn't flush
         void analog_setup();
         void AnalogPhase(float *smpsl, float *smpsr);
         //analog case
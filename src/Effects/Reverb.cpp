@@ -28,6 +28,7 @@
 
 #include "DSP/Unison.h"
 #include "DSP/AnalogFilter.h"
+#include "DSP/Lanes.h"
 #include "Misc/SynthEngine.h"
 #include "Misc/SynthHelper.h"
 #include "Effects/Reverb.h"
@@ -60,24 +61,25 @@ Reverb::Reverb(bool insertion_, float *efxoutl_, float *efxoutr_, SynthEngine& _
     hpf(NULL), // no filter
     lpffr(0, synth.samplerate),
     hpffr(0, synth.samplerate),
-    inputbuf(_synth.buffersize)
+    inputbuf(_synth.buffersize),
+    lanebuf(_synth.buffersize * REV_COMBS * 2)
 {
     setvolume(48);
+    combk = 0;
     for (int i = 0; i < REV_COMBS * 2; ++i)
     {
 
         comblen[i] = 800 + synth.randomINT() / (INT32_MAX/1400);
-        combk[i] = 0;
+        combmask[i] = 0;
         lpcomb[i] = 0;
         combfb[i] = -0.97f;
-        comb[i] = NULL;
     }
 
+    apk = 0;
     for (int i = 0; i < REV_APS * 2; ++i)
     {
         aplen[i] = 500 + synth.randomINT() / (INT32_MAX/500);
-        apk[i] = 0;
-        ap[i] = NULL;
+        apmask[i] = 0;
     }
     setpreset(Ppreset);
     Pchanged = false;
@@ -87,17 +89,12 @@ Reverb::Reverb(bool insertion_, float *efxoutl_, float *efxoutr_, SynthEngine& _
 
 Reverb::~Reverb()
 {
-    int i;
     if (idelay)
         delete [] idelay;
     if (hpf)
         delete hpf;
     if (lpf)
         delete lpf;
-    for (i = 0; i < REV_APS * 2; ++i)
-        delete [] ap[i];
-    for (i = 0; i < REV_COMBS * 2; ++i)
-        delete [] comb[i];
 
     if (bandwidth)
         delete bandwidth;
@@ -106,66 +103,201 @@ Reverb::~Reverb()
 
 void Reverb::clearBuffers()
 {
+    combk = 0;
     for (size_t j = 0; j < REV_COMBS * 2; ++j)
     {
-        combk[j] = 0;
         lpcomb[j] = 0.0;
-        for (size_t smp = 0; smp < comblen[j]; ++smp)
-            comb[j][smp] = 0.0f;
+        memset(comb[j].get(), 0, (combmask[j] + 1) * sizeof(float));
     }
+    apk = 0;
     for (size_t j = 0; j < REV_APS * 2; ++j)
-    {
-        apk[j] = 0;
-        for (size_t smp = 0; smp < aplen[j]; ++smp)
-            ap[j][smp] = 0.0f;
-    }
+        memset(ap[j].get(), 0, (apmask[j] + 1) * sizeof(float));
 
     if (idelay)
         memset(idelay, 0, sizeof(float) * idelaylen);
 }
 
 
+/*
+ * The combs (or FDN lines) are run side by side as lanes, with the
+ * samples of a run copied out of the delay lines into lanebuf, one
+ * lane per line, and back again afterwards. The per sample work then
+ * reads and writes contiguous memory across the lanes, and the copies
+ * are plain masked loops along each line. A run can be no longer than
+ * the shortest line, so everything it reads was written before it.
+ */
+size_t Reverb::laneRun(size_t first, size_t lanes, size_t done)
+{
+    size_t run = size_t(synth.sent_buffersize) - done;
+    for (size_t j = first; j < first + lanes; ++j)
+        run = std::min(run, comblen[j]);
+    return run;
+}
+
+
+void Reverb::readLanes(size_t first, size_t lanes, size_t done, size_t run)
+{
+    float *lane = lanebuf.get();
+    for (size_t j = 0; j < lanes; ++j)
+    {
+        const float *line = comb[first + j].get();
+        const uint mask = combmask[first + j];
+        const uint from = combk + uint(done) - uint(comblen[first + j]);
+        for (size_t smp = 0; smp < run; ++smp)
+            lane[smp * lanes + j] = line[(from + smp) & mask];
+    }
+}
+
+
+void Reverb::writeLanes(size_t first, size_t lanes, size_t done, size_t run)
+{
+    const float *lane = lanebuf.get();
+    for (size_t j = 0; j < lanes; ++j)
+    {
+        float *line = comb[first + j].get();
+        const uint mask = combmask[first + j];
+        const uint to = combk + uint(done);
+        for (size_t smp = 0; smp < run; ++smp)
+            line[(to + smp) & mask] = lane[smp * lanes + j];
+    }
+}
+
+
 // Process one channel; 0 = left, 1 = right
 void Reverb::calculateReverb(size_t ch, Samples& inputFeed, float *output)
 {
     ////TODO: implement the high part from lohidamp    (comment probably from original author, before 2010)
 
-    for (size_t j = REV_COMBS * ch; j < REV_COMBS * (ch + 1); ++j)
+    using lanes::Four;
+    const size_t first = REV_COMBS * ch;
+    const size_t GROUPS = REV_COMBS / lanes::WIDTH;
+    Four fb[GROUPS];
+    Four lowpass[GROUPS];
+    for (size_t g = 0; g < GROUPS; ++g)
     {
-        size_t offset = combk[j];
-        size_t combLen = comblen[j];
-        float lowpassj = lpcomb[j];
-        for (size_t smp = 0; smp < size_t(synth.sent_buffersize); ++smp)
+        // the damping split is folded into the feedback
+        fb[g] = lanes::load(combfb + first + g * lanes::WIDTH) * (1.0f - lohifb);
+        lowpass[g] = lanes::load(lpcomb + first + g * lanes::WIDTH);
+    }
+    const Four damp = lanes::splat(lohifb);
+    float *lane = lanebuf.get();
+
+    size_t done = 0;
+    while (done < size_t(synth.sent_buffersize))
+    {
+        size_t run = laneRun(first, REV_COMBS, done);
+        readLanes(first, REV_COMBS, done, run);
+        for (size_t smp = 0; smp < run; ++smp)
         {
-            float feedback = comb[j][offset] * combfb[j];
-            feedback = feedback * (1.0f - lohifb) + lowpassj * lohifb;
-            lowpassj = feedback;
+            float *combs = lane + smp * REV_COMBS;
+            const Four in = lanes::splat(inputFeed[done + smp]);
+            Four sum = lanes::splat(0.0f);
+            for (size_t g = 0; g < GROUPS; ++g)
+            {
+                Four feedback = lanes::load(combs + g * lanes::WIDTH) * fb[g] + lowpass[g] * damp;
+                lowpass[g] = feedback;
+                lanes::store(combs + g * lanes::WIDTH, in + feedback);
+                sum += feedback;
+            }
+            output[done + smp] += lanes::sum(sum);
+        }
+        writeLanes(first, REV_COMBS, done, run);
+        done += run;
+    }
+
+    for (size_t g = 0; g < GROUPS; ++g)
+        lanes::store(lpcomb + first + g * lanes::WIDTH, lowpass[g]);
+
+    allPasses(ch, output);
+}
 
-            comb[j][offset] = inputFeed[smp] + feedback;
-            output[smp] += feedback;
 
-            if ((++offset) >= combLen)
-                offset = 0;
+/*
+ * Feedback delay network, using all the comb pipelines of both channels
+ * as one set of lines mixed through a Householder matrix, which costs
+ * no more than the combs themselves. Every line feeds every other, so
+ * the echo density builds up far faster than with parallel combs. The
+ * even lines are tapped for the left output and the odd ones for the
+ * right, with alternating signs to keep the two sides uncorrelated.
+ */
+void Reverb::feedbackNetwork(Samples& inputFeed, float *outL, float *outR)
+{
+    using lanes::Four;
+    const size_t LINES = REV_COMBS * 2;
+    const size_t GROUPS = LINES / lanes::WIDTH;
+    Four gain[GROUPS];
+    Four lowpass[GROUPS];
+    Four tapL[GROUPS];
+    Four tapR[GROUPS];
+    for (size_t g = 0; g < GROUPS; ++g)
+    {
+        for (int k = 0; k < lanes::WIDTH; ++k)
+        {
+            size_t j = g * lanes::WIDTH + k;
+            gain[g][k] = fabsf(combfb[j]) * (1.0f - lohifb);
+            float sign = ((j >> 1) & 1) ? -1.0f : 1.0f;
+            tapL[g][k] = (j & 1) ? 0.0f : sign;
+            tapR[g][k] = (j & 1) ? sign : 0.0f;
         }
+        lowpass[g] = lanes::load(lpcomb + g * lanes::WIDTH);
+    }
+    const Four damp = lanes::splat(lohifb);
+    const float householder = 2.0f / LINES;
+    float *lane = lanebuf.get();
 
-        combk[j] = offset;
-        lpcomb[j] = lowpassj;
+    size_t done = 0;
+    while (done < size_t(synth.sent_buffersize))
+    {
+        size_t run = laneRun(0, LINES, done);
+        readLanes(0, LINES, done, run);
+        for (size_t smp = 0; smp < run; ++smp)
+        {
+            float *lines = lane + smp * LINES;
+            Four sum = lanes::splat(0.0f);
+            Four left = sum;
+            Four right = sum;
+            for (size_t g = 0; g < GROUPS; ++g)
+            {
+                Four feedback = lanes::load(lines + g * lanes::WIDTH) * gain[g] + lowpass[g] * damp;
+                lowpass[g] = feedback;
+                sum += feedback;
+                left += feedback * tapL[g];
+                right += feedback * tapR[g];
+            }
+            const Four reflect = lanes::splat(inputFeed[done + smp] - lanes::sum(sum) * householder);
+            for (size_t g = 0; g < GROUPS; ++g)
+                lanes::store(lines + g * lanes::WIDTH, lowpass[g] + reflect);
+            outL[done + smp] += lanes::sum(left);
+            outR[done + smp] += lanes::sum(right);
+        }
+        writeLanes(0, LINES, done, run);
+        done += run;
     }
 
-    // feed result of comb filters into AllPass filters
+    for (size_t g = 0; g < GROUPS; ++g)
+        lanes::store(lpcomb + g * lanes::WIDTH, lowpass[g]);
+
+    allPasses(0, outL);
+    allPasses(1, outR);
+}
+
+
+// feed result of comb filters into AllPass filters
+void Reverb::allPasses(size_t ch, float *output)
+{
+    float bias = denormal::bias(1e-20f);
     for (size_t j = REV_APS * ch; j < REV_APS * (1 + ch); ++j)
     {
-        size_t offset = apk[j];
-        size_t allpassLen = aplen[j];
+        float *line = ap[j].get();
+        const uint mask = apmask[j];
+        const uint from = apk - uint(aplen[j]);
         for (size_t smp = 0; smp < size_t(synth.sent_buffersize); ++smp)
         {
-            float feedback = ap[j][offset];
-            ap[j][offset] = 0.7f * feedback + output[smp];
-            output[smp] = feedback - 0.7f * ap[j][offset] + 1e-20f; // anti-denormal - a very, very, very small dc bias
-            if ((++offset) >= allpassLen)
-                offset = 0;
+            float feedback = line[(from + smp) & mask];
+            float stored = 0.7f * feedback + output[smp];
+            line[(apk + smp) & mask] = stored;
+            output[smp] = feedback - 0.7f * stored + bias; // anti-denormal - a very, very, very small dc bias
         }
-        apk[j] = offset;
     }
 }
 
@@ -183,9 +315,10 @@ namespace { //Helper: detect change above rounding errors for frequency interpol
 
 void Reverb::preprocessInput(float *rawL, float *rawR, Samples& inputFeed)
 {
+    float bias = denormal::bias(1e-20f);
     for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
     {
-        inputFeed[i] = float(1e-20) + ((rawL[i] + rawR[i]) / 2.0f); // includes anti-denormal
+        inputFeed[i] = bias + ((rawL[i] + rawR[i]) / 2.0f); // includes anti-denormal
 
         if (idelay)
         {// shift input by pre-delay
@@ -237,8 +370,15 @@ void Reverb::out(float *rawL, float *rawR)
 
     preprocessInput(rawL,rawR, inputbuf);
 
-    calculateReverb(0, inputbuf, efxoutl); // inputbuf -> left
-    calculateReverb(1, inputbuf, efxoutr); // inputbuf -> right
+    if (Ptype == TYPE_FDN)
+        feedbackNetwork(inputbuf, efxoutl, efxoutr);
+    else
+    {
+        calculateReverb(0, inputbuf, efxoutl); // inputbuf -> left
+        calculateReverb(1, inputbuf, efxoutr); // inputbuf -> right
+    }
+    combk += synth.sent_buffersize;
+    apk += synth.sent_buffersize;
 
     float lvol = rs / REV_COMBS * pangainL.getAndAdvanceValue();
     float rvol = rs / REV_COMBS * pangainR.getAndAdvanceValue();
@@ -271,6 +411,37 @@ void Reverb::cleanup()
 }
 
 
+// Touch all delay lines so none of them faults in the audio thread
+// sound entering the predelay can take a whole pass of the network to emerge
+int Reverb::quietHold() const
+{
+    size_t hold = idelay ? idelaylen : 0;
+    size_t longest = 0;
+    for (int i = 0; i < REV_COMBS * 2; ++i)
+        longest = std::max(longest, comblen[i]);
+    hold += longest;
+    for (int i = 0; i < REV_APS; ++i)
+        hold += std::max(aplen[i], aplen[i + REV_APS]);
+    return int(hold);
+}
+
+
+size_t Reverb::prefault()
+{
+    size_t bytes = 0;
+    for (int i = 0; i < REV_COMBS * 2; ++i)
+        bytes += prefaultPages(comb[i], combmask[i] + 1);
+    for (int i = 0; i < REV_APS * 2; ++i)
+        bytes += prefaultPages(ap[i], apmask[i] + 1);
+    bytes += prefaultPages(lanebuf, synth.buffersize * REV_COMBS * 2);
+    if (idelay)
+        bytes += prefaultPages(idelay, idelaylen * sizeof(float));
+    if (bandwidth)
+        bytes += bandwidth->prefault();
+    return bytes;
+}
+
+
 // Parameter control
 void Reverb::setvolume(uchar Pvolume_)
 {
@@ -401,15 +572,31 @@ void Reverb::setupPipelines()
 
         // Freeverb by Jezar at Dreampoint
         { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 },
-        { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }
+        { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 },
+        { 0, 0, 0, 0, 0, 0, 0, 0 }  // FDN has its own, below
+    };
+
+    // all different primes, so the lines never share a period
+    int fdntunings[REV_COMBS * 2] = {
+        1009, 1039, 1087, 1129, 1171, 1217, 1277, 1319,
+        1373, 1423, 1481, 1543, 1601, 1667, 1733, 1801
     };
 
     int aptunings[NUM_TYPES][REV_APS] = {
         { 0, 0, 0, 0 },         // this is unused (for random)
         { 225, 341, 441, 556 }, // Freeverb by Jezar at Dreampoint
+        { 225, 341, 441, 556 },
         { 225, 341, 441, 556 }
     };
 
+    auto lineMask = [](size_t len)
+    {
+        uint size = 1;
+        while (size < len)
+            size <<= 1;
+        return size - 1;
+    };
+
     float samplerate_adjust = synth.samplerate_f / 44100.0f;
 
     // adjust the combs according to samplerate and room size
@@ -418,22 +605,22 @@ void Reverb::setupPipelines()
         float tmp;
         if (Ptype == 0)
             tmp = 800.0f + synth.numRandom() * 1400.0f;
+        else if (Ptype == TYPE_FDN)
+            tmp = fdntunings[i];
         else
             tmp = combtunings[Ptype][i % REV_COMBS];
         tmp *= roomsize;
-        if (i > REV_COMBS)
+        if (i > REV_COMBS && Ptype != TYPE_FDN)
             tmp += 23.0f;
         tmp *= samplerate_adjust; // adjust the combs according to the samplerate
         comblen[i] = size_t(tmp);
         if (comblen[i] < 10)
             comblen[i] = 10;
-        combk[i] = 0;
         lpcomb[i] = 0;
-        if (comb[i])
-            delete [] comb[i];
-        comb[i] = new float[comblen[i]];
-        memset(comb[i], 0, comblen[i] * sizeof(float));
+        combmask[i] = lineMask(comblen[i]);
+        comb[i].reset(combmask[i] + 1);
     }
+    combk = 0;
 
     for (int i = 0; i < REV_APS * 2; ++i)
     {
@@ -451,12 +638,10 @@ void Reverb::setupPipelines()
         aplen[i] = size_t(tmp);
         if (aplen[i] < 10)
             aplen[i] = 10;
-        apk[i] = 0;
-        if (ap[i])
-            delete [] ap[i];
-        ap[i] = new float[aplen[i]];
-        memset(ap[i], 0, aplen[i] * sizeof(float));
+        apmask[i] = lineMask(aplen[i]);
+        ap[i].reset(apmask[i] + 1);
     }
+    apk = 0;
     if (NULL != bandwidth)
         delete bandwidth;
     bandwidth = NULL;
@@ -637,7 +822,7 @@ float Revlimit::getlimits(CommandBlock *getData)
             min = 64;
             break;
         case 10:
-            max = 2;
+            max = 3;
             canLearn = 0;
             break;
         case 11:
@@ -32,7 +32,7 @@
 #include "Misc/Alloc.h"
 #include "Effects/Effect.h"
 
-#define REV_COMBS 8
+#define REV_COMBS 8 // must be a multiple of 4, they are processed in groups
 #define REV_APS 4
 
 static const int reverbPRESET_SIZE = 13;
@@ -78,6 +78,8 @@ class Reverb : public Effect
         Reverb(bool insertion_, float *efxoutl_, float *efxoutr_, SynthEngine&);
         void out(float* rawL, float* rawR) override;
         void cleanup() override;
+        size_t prefault() override;
+        int quietHold() const override;
 
         void setpreset(uchar npreset) override;
         void changepar(int npar, uchar value) override;
@@ -85,7 +87,8 @@ class Reverb : public Effect
 
 
     private:
-        static constexpr size_t NUM_TYPES = 3;
+        static constexpr size_t NUM_TYPES = 4;
+        static constexpr uchar TYPE_FDN = 3;
 
         // Parameters
         bool Pchanged;
@@ -130,21 +133,29 @@ class Reverb : public Effect
         Unison *bandwidth;
 
         // Internal Variables
-        float *comb[REV_COMBS * 2];   // N CombFilter pipelines for each channel
-        size_t combk[REV_COMBS * 2];  // current offset of the comb insertion point (cycling)
+        Samples comb[REV_COMBS * 2];  // N CombFilter pipelines for each channel (or the FDN lines)
+        uint combmask[REV_COMBS * 2]; // each pipeline is a power of two long
+        uint combk;                   // current insertion point, shared by all combs (cycling)
         float combfb[REV_COMBS * 2];  // feedback coefficient of each Comb-filter
         float lpcomb[REV_COMBS * 2];  // LowPass filtered output feedback from Comb
-        float *ap[REV_APS * 2];       // AllPass-filter
-        size_t apk[REV_APS * 2];      // current offset of the AllPass insertion point (cycling)
+        Samples ap[REV_APS * 2];      // AllPass-filter
+        uint apmask[REV_APS * 2];
+        uint apk;                     // current insertion point, shared by all AllPasses (cycling)
         float *idelay;                // Input delay line
         AnalogFilter *lpf;            // LowPass-filter on the input
         AnalogFilter *hpf;            // HighPass-filter on the input
         synth::InterpolatedValue<float> lpffr;
         synth::InterpolatedValue<float> hpffr;
         Samples inputbuf;
+        Samples lanebuf;              // delay line samples for a run, one lane per line
 
         void preprocessInput(float *rawL, float *rawR, Samples& inputFeed);
         void calculateReverb(size_t ch, Samples& inputFeed, float *output);
+        void feedbackNetwork(Samples& inputFeed, float *outL, float *outR);
+        void allPasses(size_t ch, float *output);
+        size_t laneRun(size_t first, size_t lanes, size_t done);
+        void readLanes(size_t first, size_t lanes, size_t done, size_t run);
+        void writeLanes(size_t first, size_t lanes, size_t done, size_t run);
         void setupPipelines();
         void clearBuffers();
 };
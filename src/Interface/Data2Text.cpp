@@ -1549,6 +1549,12 @@ string DataText::resolvePart(CommandBlock& cmd, bool addValue)
             contstr = "Full Key Range";
             showValue = false;
             break;
+        case PART::control::mpeChannels:
+            contstr = "MPE Channels";
+            break;
+        case PART::control::mpeBendRange:
+            contstr = "MPE Bend Range";
+            break;
 
         case PART::control::kitEffectNum:
             if (value_int == 0)
@@ -3392,6 +3398,9 @@ string DataText::resolveEffects(CommandBlock& cmd, bool addValue)
                     case 2:
                         contstr = " Bandwidth ";
                         break;
+                    case 3:
+                        contstr = " FDN ";
+                        break;
                 }
             }
             break;
@@ -3431,7 +3440,7 @@ string DataText::resolveEffects(CommandBlock& cmd, bool addValue)
                     showValue = false;
                     contstr += (" " + bpm2text(float(value) / 127.0f));
                 }
-                if (control == 11 || control == 17)
+                if (control == 11 || control == 12 || control == 17)
                 {
                     yesno = true;
                 }
@@ -3508,6 +3517,10 @@ string DataText::resolveEffects(CommandBlock& cmd, bool addValue)
                         yesno = true;
                         break;
                     }
+                    case 12:
+                        contstr = value ? (" " + to_string(1 << value) + "x") : " Off";
+                        showValue = false;
+                        break;
                     case 7:
                     case 10:
                     {
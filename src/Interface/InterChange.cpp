@@ -24,6 +24,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <sstream>
 #include <string>
 #include <cfloat>
 #include <bitset>
@@ -117,7 +118,15 @@ InterChange::InterChange(SynthEngine& synthInstance)
     swapInstrument1(UNUSED),
     searchInst(0),
     searchBank(0),
-    searchRoot(0)
+    searchRoot(0),
+    midiBatch{},
+    midiSkip{},
+    midiCount(0),
+    midiNext(0),
+    mergeSlots{},
+    mergeBatch(0),
+    mergeOrdered(),
+    mergedCount(0)
 {
     noteSeen = false;
     undoLoopBack = false;
@@ -144,6 +153,7 @@ bool InterChange::Init()
     fromMIDI.init ();
     returnsBuffer.init ();
     muteQueue.init ();
+    setMergeExceptions(synth.getRuntime().mergeExceptions);
     if (!synth.getRuntime().startThread(&sortResultsThreadHandle, _sortResultsThread, this, false, 0, "CLI"))
     {
         synth.getRuntime().Log("Failed to start CLI resolve thread");
@@ -1894,6 +1904,8 @@ void InterChange::mediate()
         }
     }
 
+    synth.mididecode.tuning.apply(); // MIDI Tuning Standard changes
+
     bool more;
     do
     {
@@ -1919,7 +1931,7 @@ void InterChange::mediate()
             returns(cmd);
         }
 #endif
-        if (fromMIDI.read(cmd.bytes))
+        if (nextFromMIDI(cmd))
         {
             more = true;
             cameFrom = envControl::input;
@@ -1953,6 +1965,131 @@ void InterChange::mediate()
 
 
 
+// the next command from MIDI still wanted, taking a new batch when needed
+bool InterChange::nextFromMIDI(CommandBlock& cmd)
+{
+    while (true)
+    {
+        if (midiNext == midiCount)
+        {
+            takeFromMIDI();
+            if (midiCount == 0)
+                return false;
+        }
+        uint index = midiNext++;
+        if (!midiSkip[index])
+        {
+            cmd = midiBatch[index];
+            return true;
+        }
+    }
+}
+
+
+void InterChange::takeFromMIDI()
+{
+    midiCount = 0;
+    midiNext = 0;
+    while (midiCount < MIDI_BATCH && fromMIDI.read(midiBatch[midiCount].bytes))
+    {
+        midiSkip[midiCount] = false;
+        ++ midiCount;
+    }
+    if (midiCount < 2)
+        return;
+
+    if (++ mergeBatch == 0)
+    {   // wrapped round, so old slots could look current
+        std::fill(mergeSlots, mergeSlots + MERGE_SLOTS, MergeSlot{0, 0});
+        mergeBatch = 1;
+    }
+    // from the newest back, so it's the last write to each control that stays
+    uint merged = 0;
+    for (uint i = midiCount; i-- > 0;)
+    {
+        uint64_t key;
+        if (!mergeKey(midiBatch[i], key))
+            continue;
+        uint slot = uint((key * 0x9e3779b97f4a7c15ull) >> 53); // 11 bits for MERGE_SLOTS
+        while (true)
+        {
+            MergeSlot& seen = mergeSlots[slot];
+            if (seen.batch != mergeBatch)
+            {
+                seen.key = key;
+                seen.batch = mergeBatch;
+                break;
+            }
+            if (seen.key == key)
+            {
+                midiSkip[i] = true;
+                ++ merged;
+                break;
+            }
+            slot = (slot + 1) & (MERGE_SLOTS - 1);
+        }
+    }
+    if (merged > 0)
+        mergedCount.fetch_add(merged, std::memory_order_relaxed);
+}
+
+
+// false for anything that has to be applied every time, in order
+bool InterChange::mergeKey(CommandBlock const& cmd, uint64_t& key) const
+{
+    if (!(cmd.data.type & TOPLEVEL::type::Write)
+        || (cmd.data.source & TOPLEVEL::action::noAction) != TOPLEVEL::action::fromMIDI
+        || (cmd.data.source & TOPLEVEL::action::muteAndLoop) != 0
+        || cmd.data.miscmsg != NO_MSG)
+        return false;
+
+    uint64_t note = 0;
+    switch (cmd.data.part)
+    {
+        case TOPLEVEL::section::main: // file loads and instance control
+        case TOPLEVEL::section::midiLearn: // activity reports
+            return false;
+
+        case TOPLEVEL::section::midiIn:
+            if (cmd.data.control != MIDI::control::controller || mergeOrdered.test(cmd.data.engine))
+                return false;
+            if (cmd.data.engine == (MIDI::CC::keyPressure & 0xff))
+                note = int(cmd.data.value) & 0x7f; // every key has its own
+            break;
+    }
+    key = uint64_t(cmd.data.control)
+        | uint64_t(cmd.data.part)      << 8
+        | uint64_t(cmd.data.kit)       << 16
+        | uint64_t(cmd.data.engine)    << 24
+        | uint64_t(cmd.data.insert)    << 32
+        | uint64_t(cmd.data.parameter) << 40
+        | uint64_t(cmd.data.offset)    << 48
+        | note                         << 56;
+    return true;
+}
+
+
+// controller numbers and ranges such as "64-69 120-127", or "none"
+void InterChange::setMergeExceptions(string const& list)
+{
+    mergeOrdered.reset();
+    string spaced = list;
+    std::replace(spaced.begin(), spaced.end(), ',', ' ');
+    std::istringstream items(spaced);
+    string item;
+    while (items >> item)
+    {
+        if (item[0] < '0' || item[0] > '9')
+            continue;
+        size_t dash = item.find('-');
+        int first = func::string2int(item.substr(0, dash));
+        int last = (dash == string::npos) ? first : func::string2int(item.substr(dash + 1));
+        for (int ctl = first; ctl <= last && ctl < int(mergeOrdered.size()); ++ ctl)
+            mergeOrdered.set(ctl);
+    }
+}
+
+
 /*
  * Currently this is only used by MIDI NRPNs but eventually
  * be used as a unified way of catching all list loads.
@@ -2039,7 +2176,7 @@ void InterChange::returns(CommandBlock& cmd)
 #endif
     }
     if (!decodeLoopback.write(cmd.bytes))
-        synth.getRuntime().Log("Unable to write to decodeLoopback buffer");
+        synth.getRuntime().rtLog.post(rtlog::returnsFull);
     spinSortResultsThread();
 }
 
@@ -2247,7 +2384,7 @@ bool InterChange::processAdd(CommandBlock& cmd, SynthEngine& synth)
     {
         case UNUSED:
             commandAdd(cmd);
-            part.kit[kititem].adpars->paramsChanged();
+            part.kit[kititem].adpars->paramsChanged(ADnoteParameters::globalChange(cmd.data.control));
             break;
         case TOPLEVEL::insert::LFOgroup:
             commandLFO(cmd);
@@ -2264,7 +2401,7 @@ bool InterChange::processAdd(CommandBlock& cmd, SynthEngine& synth)
         case TOPLEVEL::insert::resonanceGroup:
         case TOPLEVEL::insert::resonanceGraphInsert:
             commandResonance(cmd, part.kit[kititem].adpars->GlobalPar.Reson);
-            part.kit[kititem].adpars->paramsChanged();
+            part.kit[kititem].adpars->paramsChanged(ADnoteParameters::waveChange);
             break;
         }
     return true;
@@ -2281,7 +2418,7 @@ bool InterChange::processVoice(CommandBlock& cmd, SynthEngine& synth)
     {
         case UNUSED:
             commandAddVoice(cmd);
-            part.kit[kititem].adpars->paramsChanged();
+            part.kit[kititem].adpars->paramsChanged(ADnoteParameters::voiceChange(control));
             break;
         case TOPLEVEL::insert::LFOgroup:
             commandLFO(cmd);
@@ -2298,8 +2435,11 @@ bool InterChange::processVoice(CommandBlock& cmd, SynthEngine& synth)
         case TOPLEVEL::insert::oscillatorGroup:
         case TOPLEVEL::insert::harmonicAmplitude:
         case TOPLEVEL::insert::harmonicPhase:
+        {
+            uint change = ADnoteParameters::waveChange;
             if (engine >= PART::engine::addMod1)
             {
+                change = ADnoteParameters::fmChange;
                 engine -= PART::engine::addMod1;
                 if (control != ADDVOICE::control::modulatorOscillatorSource)
                 {
@@ -2327,8 +2467,9 @@ bool InterChange::processVoice(CommandBlock& cmd, SynthEngine& synth)
                 }
                 commandOscillator(cmd,  part.kit[kititem].adpars->VoicePar[engine].POscil);
             }
-            part.kit[kititem].adpars->paramsChanged();
+            part.kit[kititem].adpars->paramsChanged(change);
             break;
+        }
     }
     return true;
 }
@@ -4123,6 +4264,19 @@ void InterChange::commandPart(CommandBlock& cmd)
             }
             break;
 
+        case PART::control::mpeChannels:
+            if (write)
+                part.PmpeChannels = value_int;
+            else
+                value = part.PmpeChannels;
+            break;
+        case PART::control::mpeBendRange:
+            if (write)
+                part.PmpeBendRange = value_int;
+            else
+                value = part.PmpeBendRange;
+            break;
+
         case PART::control::kitEffectNum:
             if (kitType)
             {
@@ -36,6 +36,8 @@
 
 #include <semaphore.h>
 
+#include <atomic>
+#include <bitset>
 #include <list>
 #include <memory>
 #include <string>
@@ -120,6 +122,7 @@ class InterChange : private DataText
         void testLimits(CommandBlock&);
         float returnLimits(CommandBlock&);
         void Log(std::string const& msg);
+        uint64_t midiMerged() const { return mergedCount.load(std::memory_order_relaxed); }
 
         std::atomic<bool> syncWrite;
         std::atomic<bool> lowPrioWrite;
@@ -205,6 +208,34 @@ class InterChange : private DataText
         int searchInst;
         int searchBank;
         int searchRoot;
+
+        /*
+         * Everything waiting in fromMIDI is taken in one go at the start of
+         * a period, and of several writes to the same control only the last
+         * is applied, so a fast fader or pitch bend costs one command per
+         * period rather than one per message. Commands carrying text, ones
+         * for the background thread and the controllers listed in
+         * Config::mergeExceptions are all kept, in order.
+         */
+        static constexpr uint MIDI_BATCH = 1024; // all that fromMIDI can hold
+        static constexpr uint MERGE_SLOTS = 2 * MIDI_BATCH;
+        struct MergeSlot {
+            uint64_t key;
+            uint batch; // stale unless it's the current one
+        };
+        bool nextFromMIDI(CommandBlock&);
+        void takeFromMIDI();
+        bool mergeKey(CommandBlock const&, uint64_t& key) const;
+        void setMergeExceptions(std::string const& list);
+
+        CommandBlock midiBatch[MIDI_BATCH];
+        bool midiSkip[MIDI_BATCH];
+        uint midiCount;
+        uint midiNext;
+        MergeSlot mergeSlots[MERGE_SLOTS];
+        uint mergeBatch;
+        std::bitset<256> mergeOrdered; // by controller number
+        std::atomic<uint64_t> mergedCount;
 };
 
 #endif
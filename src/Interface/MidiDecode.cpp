@@ -38,7 +38,7 @@ using func::asString;
 using func::asHexString;
 
 
-MidiDecode::MidiDecode(SynthEngine *_synth) : synth(_synth){ }
+MidiDecode::MidiDecode(SynthEngine *_synth) : tuning{*_synth}, synth(_synth){ }
 
 
 
@@ -84,7 +84,7 @@ void MidiDecode::midiProcess(uchar par0, uchar par1, uchar par2, bool in_place,
 
         default: // wot, more?
             if (synth->getRuntime().monitorCCin)
-                synth->getRuntime().Log("Unsupported event: 0x" + asHexString(int(par0)), _SYS_::LogNotSerious);
+                synth->getRuntime().rtLog.post(rtlog::midiUnsupported, long(par0));
             break;
     }
 }
@@ -24,6 +24,7 @@
 
 
 #include "Interface/InterChange.h"
+#include "Interface/MidiTuning.h"
 
 #include <list>
 
@@ -37,6 +38,10 @@ class MidiDecode
         void midiProcess(uchar par0, uchar par1, uchar par2, bool in_place, bool inSync = false);
         void setMidiBankOrRootDir(uint bank_or_root_num, bool in_place = false, bool setRootDir = false);
         void setMidiProgram(uchar ch, int prg, bool in_place = false);
+        // a whole or part SysEx message, only tuning is acted on
+        void sysexProcess(const uchar *data, size_t size) { tuning.queue(data, size); }
+
+        MidiTuning tuning;
 
     private:
         void setMidiController(uchar ch, int ctrl, int param, bool in_place = false, bool inSync = false);
@@ -33,6 +33,7 @@
 #include <list>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <thread>
 #include <iostream>
 
@@ -54,8 +55,6 @@ using std::string;
 using std::vector;
 using std::list;
 
-enum scan : int { noList = -3, listEnd, listBlocked};
-
 
 namespace { // Implementation details...
 
@@ -76,7 +75,10 @@ MidiLearn::MidiLearn(SynthEngine& synthInstance)
     : synth(synthInstance)
     , data{}
     , learning{false}
+    , discardOutput{false}
     , midi_list{}
+    , dispatch{}
+    , published{0}
     , learnedName{}
     , learnTransferBlock{}
     { }
@@ -101,20 +103,28 @@ bool MidiLearn::runMidiLearn(int intVal, ushort CC, uchar chan, bool in_place)
         return true; // block while learning
     }
 
-    if (findSize() == 0)
+    Dispatch const& table = dispatch[published.load(std::memory_order_acquire)];
+    if (table.size == 0)
         return false; // don't bother if there's no list!
 
-    int lastpos = scan::listBlocked;
-    LearnBlock foundEntry;
+    // lines for this channel and for all channels, merged back into list order
+    const Dispatch::Slot *own = (chan < 16) ? table.find(Dispatch::key(CC, chan)) : nullptr;
+    const Dispatch::Slot *all = table.find(Dispatch::key(CC, 16));
+    const ushort *ownNext = own ? table.routes + own->first : nullptr;
+    const ushort *ownEnd  = own ? ownNext + own->count : nullptr;
+    const ushort *allNext = all ? table.routes + all->first : nullptr;
+    const ushort *allEnd  = all ? allNext + all->count : nullptr;
+
     bool firstLine = true;
-    while (lastpos != scan::listEnd)
+    while (ownNext != ownEnd || allNext != allEnd)
     {
-        lastpos = findEntry(midi_list, lastpos, CC, chan, foundEntry, false);
-        if (lastpos == scan::noList)
-            return false;
+        ushort line;
+        if (allNext == allEnd || (ownNext != ownEnd && *ownNext < *allNext))
+            line = *ownNext++;
+        else
+            line = *allNext++;
+        LearnBlock const& foundEntry = table.lines[line];
         int status = foundEntry.status;
-        if (status & 4) // it's muted
-            continue;
 /*
  * Some of the following conversions seem strange but are
  * needed to ensure a control range that is an exact
@@ -186,7 +196,7 @@ bool MidiLearn::runMidiLearn(int intVal, ushort CC, uchar chan, bool in_place)
                 writeMidi(resultCmd, in_place);
             }
         }
-        if (lastpos == scan::listBlocked) // blocking all of this CC/chan pair
+        if (status & 1) // blocking all of this CC/chan pair
             return true;
     }
     return false;
@@ -195,6 +205,8 @@ bool MidiLearn::runMidiLearn(int intVal, ushort CC, uchar chan, bool in_place)
 
 bool MidiLearn::writeMidi(CommandBlock& cmd, bool in_place)
 {
+    if (discardOutput)
+        return true;
     cmd.data.source |= TOPLEVEL::action::fromMIDI;
     uint tries{0};
     bool ok{true};
@@ -209,66 +221,84 @@ bool MidiLearn::writeMidi(CommandBlock& cmd, bool in_place)
         {
             ++ tries;
             ok = synth.interchange.fromMIDI.write(cmd.bytes);
-            if (not ok)
+            if (not ok and not rtlog::audioThread)
                 sleep_for(1us);
-        // we can afford a short delay for buffer to clear
+        // off the audio thread we can afford a short delay for buffer to clear
         }
-        while (not ok and tries < 3);
+        while (not ok and not rtlog::audioThread and tries < 3);
 
         if (not ok)
-            synth.getRuntime().Log("MidiLearn: congestion on MIDI->Engine");
+        {
+            if (rtlog::audioThread)
+                synth.getRuntime().rtLog.post(rtlog::midiLearnCongestion);
+            else
+                synth.getRuntime().Log("MidiLearn: congestion on MIDI->Engine");
+        }
     }
     return ok;
 }
 
 
-/*
- * This will only be called by incoming midi. It is the only function that
- * needs to be really quick
- */
-int MidiLearn::findEntry(list<LearnBlock>& midi_list, int lastpos, ushort CC, uchar chan, LearnBlock& block, bool show)
+// runMidiLearn() only, which may be on the audio thread
+MidiLearn::Dispatch::Slot const *MidiLearn::Dispatch::find(uint key) const
 {
-    int newpos = 0; // 'last' comes in at listBlocked for the first call
-    list<LearnBlock>::iterator it = midi_list.begin();
-
-    while (newpos <= lastpos && it != midi_list.end())
+    for (uint i = hash(key); ; i = (i + 1) & (SLOTS - 1))
     {
-        ++ it;
-        ++ newpos;
+        Slot const& slot = slots[i];
+        if (slot.count == 0)
+            return nullptr;
+        if (slot.key == key)
+            return &slot;
     }
-    if (it == midi_list.end())
-        return scan::noList;
+}
+
 
-    while ((CC != it->CC || (it->chan != 16 && chan != it->chan)) &&  it != midi_list.end())
+/*
+ * Called after every change to the list, from whichever thread made it.
+ * Lines past the learn limit, which only a hand edited file can have,
+ * are left out.
+ */
+void MidiLearn::compile()
+{
+    uint next = (published.load(std::memory_order_relaxed) + 1) % DISPATCH_RING;
+    Dispatch& table = dispatch[next];
+    table.size = 0;
+    for (LearnBlock const& entry : midi_list)
     {
-        ++ it;
-        ++ newpos;
+        if (entry.status & 4) // muted
+            continue;
+        if (table.size == MIDI_LEARN_BLOCK)
+            break;
+        table.lines[table.size++] = entry;
     }
-    if (it == midi_list.end())
-        return scan::noList;
 
-    while (CC == it->CC && it != midi_list.end())
+    ushort order[MIDI_LEARN_BLOCK];
+    for (ushort line = 0; line < table.size; ++line)
+        order[line] = line;
+    std::stable_sort(order, order + table.size, [&table](ushort a, ushort b)
+                     {
+                         return Dispatch::key(table.lines[a].CC, table.lines[a].chan)
+                              < Dispatch::key(table.lines[b].CC, table.lines[b].chan);
+                     });
+    std::copy(order, order + table.size, table.routes);
+
+    std::fill(table.slots, table.slots + Dispatch::SLOTS, Dispatch::Slot{0, 0, 0});
+    uint first = 0;
+    while (first < table.size)
     {
-        if ((it->chan >= 16 || chan == it->chan) && CC == it->CC)
-        {
-            if (show)
-                synth.getRuntime().Log("Found line " + findName(it) + "  at " + to_string(newpos)); // a test!
-            block.chan    = it->chan;
-            block.CC      = it->CC;
-            block.min_in  = it->min_in;
-            block.max_in  = it->max_in;
-            block.status  = it->status;
-            block.min_out = it->min_out;
-            block.max_out = it->max_out;
-            block.frame.data = it->frame.data;
-            if ((it->status & 5) == 1) // blocked, not muted
-                return scan::listBlocked; // don't allow any more of this CC and channel;
-            return newpos;
-        }
-        ++ it;
-        ++ newpos;
+        LearnBlock const& line = table.lines[table.routes[first]];
+        uint key = Dispatch::key(line.CC, line.chan);
+        uint last = first + 1;
+        while (last < table.size && Dispatch::key(table.lines[table.routes[last]].CC,
+                                                  table.lines[table.routes[last]].chan) == key)
+            ++last;
+        uint i = Dispatch::hash(key);
+        while (table.slots[i].count != 0)
+            i = (i + 1) & (Dispatch::SLOTS - 1);
+        table.slots[i] = Dispatch::Slot{key, ushort(first), ushort(last - first)};
+        first = last;
     }
-    return scan::listEnd;
+    published.store(next, std::memory_order_release);
 }
 
 
@@ -382,6 +412,7 @@ bool MidiLearn::remove(int itemNumber)
     if (it != midi_list.end())
     {
         midi_list.erase(it);
+        compile();
         return true;
     }
     return false;
@@ -410,6 +441,7 @@ void MidiLearn::generalOperations(CommandBlock& cmd)
     if (control == MIDILEARN::control::clearAll)
     {
         midi_list.clear();
+        compile();
         updateGui();
         synth.getRuntime().Log("List cleared");
         return;
@@ -617,6 +649,7 @@ void MidiLearn::generalOperations(CommandBlock& cmd)
         it->min_in = insert;
         it->max_in = parameter;
         it->status = type;
+        compile();
         writeToGui(response);
         return;
     }
@@ -656,6 +689,7 @@ void MidiLearn::generalOperations(CommandBlock& cmd)
             midi_list.push_back(entry);
         else
             midi_list.insert(it, entry);
+        compile();
 
         synth.getRuntime().Log("Moved line to " + to_string(lineNo + 1) + " " + lineName);
         updateGui();
@@ -697,6 +731,23 @@ void MidiLearn::insertLine(ushort CC, uchar chan)
         return;
     }
 
+    addLine(CC, chan);
+
+    uint CCh = CC;
+    string CCtype;
+    if (CCh < 0xff)
+        CCtype = "CC " + to_string(CCh);
+    else
+        CCtype = "NRPN " + asHexString((CCh >> 7) & 0x7f) + " " + asHexString(CCh & 0x7f);
+    synth.getRuntime().Log("Learned " + CCtype + "  Chan " + to_string((int)chan + 1) + "  " + learnedName);
+    updateGui(MIDILEARN::control::limit);
+    learning = false;
+}
+
+
+// the line for learnTransferBlock, in CC then channel order
+void MidiLearn::addLine(ushort CC, uchar chan)
+{
     uchar status{0};
     if (CC >= MIDI::CC::channelPressureAdjusted)
         status |= 1; // set 'block'
@@ -737,16 +788,16 @@ void MidiLearn::insertLine(ushort CC, uchar chan)
         midi_list.push_back(entry);
     else
         midi_list.insert(it, entry);
+    compile();
+}
 
-    uint CCh = entry.CC;
-    string CCtype;
-    if (CCh < 0xff)
-        CCtype = "CC " + to_string(CCh);
-    else
-        CCtype = "NRPN " + asHexString((CCh >> 7) & 0x7f) + " " + asHexString(CCh & 0x7f);
-    synth.getRuntime().Log("Learned " + CCtype + "  Chan " + to_string((int)entry.chan + 1) + "  " + learnedName);
-    updateGui(MIDILEARN::control::limit);
-    learning = false;
+
+void MidiLearn::insertTestLine(ushort CC, uchar chan, CommandBlock const& frame)
+{
+    if (midi_list.size() >= MIDI_LEARN_BLOCK)
+        return;
+    memcpy(learnTransferBlock.bytes, frame.bytes, sizeof(learnTransferBlock));
+    addLine(CC, chan);
 }
 
 
@@ -959,6 +1010,7 @@ bool MidiLearn::extractMidiListData(bool full,  XMLwrapper& xml)
     midi_list.clear();
     if (!xml.enterbranch("MIDILEARN"))
     {
+        compile();
         if (full)
             synth.getRuntime().Log("Extract Data, no MIDILEARN branch");
         return false;
@@ -1083,6 +1135,7 @@ if (DECODE_MODE & 1)
         }
     }
     xml.exitbranch(); // MIDILEARN
+    compile();
     return true;
 }
 
@@ -26,6 +26,7 @@
 
 #include <list>
 #include <string>
+#include <atomic>
 
 #include "Interface/InterChange.h"
 #include "Interface/Data2Text.h"
@@ -83,15 +84,50 @@ class MidiLearn : private DataText, TextData
         bool extractMidiListData(bool full, XMLwrapper&);
         void updateGui(int opp = 0);
 
+        // benchmark only: lines go straight in, without GUI or logging,
+        // and what they send is thrown away rather than reaching the engine
+        void insertTestLine(ushort CC, uchar chan, CommandBlock const& frame);
+        bool discardOutput;
+
 
     private:
+        /*
+         * The list as runMidiLearn() wants it: the unmuted lines in list
+         * order, and a hash table from each CC and channel pair to the
+         * lines for it, so an incoming CC only looks at the lines that
+         * match. Lines for all channels have their own pair, channel 16,
+         * and are merged in by line number. Rebuilt by compile() whenever
+         * the list changes, into the next of a small ring, then published
+         * by index, the same as the tuning tables.
+         */
+        struct Dispatch {
+            static constexpr uint SLOTS = 1024; // keeps it under half full, see hash()
+            struct Slot {
+                uint key;     // CC << 5 | channel
+                ushort first; // into routes
+                ushort count; // 0 when the slot is empty
+            };
+            uint size;
+            LearnBlock lines[MIDI_LEARN_BLOCK];
+            ushort routes[MIDI_LEARN_BLOCK];
+            Slot slots[SLOTS];
+
+            static uint key(ushort CC, uchar chan) { return uint(CC) << 5 | (chan < 16 ? chan : 16); }
+            static uint hash(uint key) { return (key * 0x9e3779b1u) >> 22; }
+            Slot const *find(uint key) const;
+        };
+        static constexpr uint DISPATCH_RING = 4;
+
         list<LearnBlock> midi_list;
+        Dispatch dispatch[DISPATCH_RING];
+        std::atomic<uint> published;
         string       learnedName;
         CommandBlock learnTransferBlock;
 
-        int findEntry(list<LearnBlock>&, int lastpos, ushort CC, uchar chan, LearnBlock& block, bool show);
+        void compile();
         string findName(list<LearnBlock>::iterator it);
         void insertLine(ushort CC, uchar chan);
+        void addLine(ushort CC, uchar chan);
         bool saveList(string const& name);
         void writeToGui(CommandBlock& putData);
 };
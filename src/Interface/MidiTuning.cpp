@@ -0,0 +1,294 @@
+/*
+    MidiTuning.cpp - MIDI Tuning Standard messages applied off the MIDI thread
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Interface/MidiTuning.h"
+#include "Misc/SynthEngine.h"
+#include "Misc/Config.h"
+#include "Misc/NumericFuncs.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+using func::power;
+
+namespace { // MTS message layout
+
+    constexpr uchar SYSEX_START = 0xf0;
+    constexpr uchar SYSEX_END   = 0xf7;
+    constexpr uchar NON_REALTIME = 0x7e;
+    constexpr uchar REALTIME     = 0x7f;
+    constexpr uchar TUNING       = 0x08;
+
+    enum Form : uchar {
+        BulkDump = 0x01,     // prog, name[16], 128 * (xx yy zz), checksum
+        NoteChange = 0x02,   // prog, count, count * (key xx yy zz)
+        BankNoteChange = 0x07, // bank, prog, count, count * (key xx yy zz)
+        OctaveCents = 0x08,  // 3 byte channel mask, 12 * cents + 64
+        OctaveFine = 0x09    // 3 byte channel mask, 12 * 14 bit, 0x2000 is none
+    };
+
+    constexpr uint BULK_DATA = 22;
+    constexpr uint BULK_SIZE = BULK_DATA + 3 * MAX_OCTAVE_SIZE + 2;
+    constexpr uint OCTAVE_DATA = 8;
+
+    // semitone, then the 14 bit fraction of one; 7f 7f 7f leaves the key alone
+    inline float keyFreq(const uchar *entry)
+    {
+        if (entry[0] == 0x7f && entry[1] == 0x7f && entry[2] == 0x7f)
+            return 0.0f;
+        float note = entry[0] + float((entry[1] << 7) | entry[2]) / 16384.0f;
+        return 440.0f * power<2>((note - 69.0f) / 12.0f);
+    }
+
+    inline void semWait(sem_t *sem)
+    {
+        while (sem_wait(sem) < 0 && errno == EINTR)
+        { }
+    }
+}
+
+
+MidiTuning::MidiTuning(SynthEngine& _synth)
+    : synth{_synth}
+    , ring{}
+    , writeCount{0}
+    , readCount{0}
+    , assembling{false}
+    , retuned{}
+    , retunedResets{0}
+    , builtCount{0}
+    , usedCount{0}
+    , thread{}
+    , running{false}
+    , quit{false}
+    , wake{}
+    , appliedCount{0}
+    , droppedCount{0}
+{
+    sem_init(&wake, 0, 0);
+}
+
+
+MidiTuning::~MidiTuning()
+{
+    stop();
+    sem_destroy(&wake);
+}
+
+
+bool MidiTuning::start()
+{
+    if (running)
+        return true;
+    quit.store(false);
+    Config& runtime = synth.getRuntime();
+    running = runtime.startThread(&thread, _worker, this, false, 0, "Tuning");
+    if (!running)
+        runtime.Log("Failed to start MIDI tuning thread", _SYS_::LogError);
+    return running;
+}
+
+
+void MidiTuning::stop()
+{
+    if (!running)
+        return;
+    quit.store(true);
+    sem_post(&wake);
+    pthread_join(thread, nullptr);
+    running = false;
+}
+
+
+void MidiTuning::queue(const uchar *data, size_t size)
+{
+    if (size == 0)
+        return;
+    uint write = writeCount.load(std::memory_order_relaxed);
+    Message& msg = ring[write % MESSAGES];
+    if (data[0] == SYSEX_START)
+    {
+        if (write - readCount.load(std::memory_order_acquire) >= MESSAGES)
+        {
+            assembling = false;
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        msg.size = 0;
+        assembling = true;
+    }
+    else if (!assembling)
+        return;
+
+    if (msg.size + size > MESSAGE_SIZE)
+    {   // not a tuning message, or not one we know
+        assembling = false;
+        return;
+    }
+    memcpy(msg.data + msg.size, data, size);
+    msg.size += size;
+    if (msg.data[msg.size - 1] != SYSEX_END)
+        return;
+
+    assembling = false;
+    if (!isTuning(msg.data, msg.size) || !running)
+        return;
+    writeCount.store(write + 1, std::memory_order_release);
+    sem_post(&wake);
+}
+
+
+bool MidiTuning::isTuning(const uchar *data, uint size)
+{
+    return size > 5
+        && (data[1] == NON_REALTIME || data[1] == REALTIME)
+        && data[3] == TUNING;
+}
+
+
+void *MidiTuning::_worker(void *arg)
+{
+    static_cast<MidiTuning*>(arg)->worker();
+    return nullptr;
+}
+
+
+void MidiTuning::worker()
+{
+    float freq[MAX_OCTAVE_SIZE];
+    while (true)
+    {
+        semWait(&wake);
+        if (quit.load(std::memory_order_relaxed))
+            break;
+
+        // everything waiting goes into one table, later keys win
+        std::fill(freq, freq + MAX_OCTAVE_SIZE, 0.0f);
+        uint count = 0;
+        uint read = readCount.load(std::memory_order_relaxed);
+        while (read != writeCount.load(std::memory_order_acquire))
+        {
+            Message const& msg = ring[read % MESSAGES];
+            if (decode(msg.data, msg.size, freq))
+                ++count;
+            readCount.store(++read, std::memory_order_release);
+        }
+        if (count == 0)
+            continue;
+
+        // the table just before the oldest one not yet taken up may be
+        // the one in use, so one slot always stays out of reach
+        uint built = builtCount.load(std::memory_order_relaxed);
+        if (built - usedCount.load(std::memory_order_acquire) >= Microtonal::RETUNE_RING - 1)
+        {   // the synth thread hasn't caught up
+            droppedCount.fetch_add(count, std::memory_order_relaxed);
+            continue;
+        }
+        uint resets = synth.microtonal.resetCount();
+        if (resets != retunedResets)
+        {   // the tuning was reset since, so start afresh
+            std::fill(retuned, retuned + MAX_OCTAVE_SIZE, 0.0f);
+            retunedResets = resets;
+        }
+        for (int key = 0; key < MAX_OCTAVE_SIZE; ++key)
+            if (freq[key] > 0.0f)
+                retuned[key] = freq[key];
+        Microtonal::Retune& table = synth.microtonal.retuneSlot(built);
+        std::copy(retuned, retuned + MAX_OCTAVE_SIZE, table.freq);
+        table.resets = resets;
+        builtCount.store(built + 1, std::memory_order_release);
+        appliedCount.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+
+void MidiTuning::apply()
+{
+    uint built = builtCount.load(std::memory_order_acquire);
+    if (built == usedCount.load(std::memory_order_relaxed))
+        return;
+    synth.microtonal.publishRetune(built - 1);
+    usedCount.store(built, std::memory_order_release);
+}
+
+
+bool MidiTuning::decode(const uchar *data, uint size, float *freq)
+{
+    const uchar *end = data + size - 1; // the closing f7
+    switch (data[4])
+    {
+        case BulkDump:
+        {   // the checksum is too often wrong to be worth checking
+            if (size < BULK_SIZE)
+                return false;
+            for (int key = 0; key < MAX_OCTAVE_SIZE; ++key)
+            {
+                float value = keyFreq(data + BULK_DATA + 3 * key);
+                if (value > 0.0f)
+                    freq[key] = value;
+            }
+            return true;
+        }
+
+        case NoteChange:
+        case BankNoteChange:
+        {
+            const uchar *entry = data + (data[4] == NoteChange ? 6 : 7);
+            if (entry >= end)
+                return false;
+            uint count = *entry++;
+            bool changed = false;
+            for (; count > 0 && entry + 4 <= end; --count, entry += 4)
+            {
+                float value = keyFreq(entry + 1);
+                if (entry[0] < MAX_OCTAVE_SIZE && value > 0.0f)
+                {
+                    freq[entry[0]] = value;
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+
+        case OctaveCents:
+        case OctaveFine:
+        {
+            uint width = (data[4] == OctaveCents) ? 1 : 2;
+            if (data + OCTAVE_DATA + 12 * width > end)
+                return false;
+            float cents[12];
+            for (int degree = 0; degree < 12; ++degree)
+            {
+                const uchar *value = data + OCTAVE_DATA + degree * width;
+                if (width == 1)
+                    cents[degree] = float(value[0]) - 64.0f;
+                else
+                    cents[degree] = float(((value[0] << 7) | value[1]) - 0x2000) * 100.0f / 8192.0f;
+            }
+            for (int key = 0; key < MAX_OCTAVE_SIZE; ++key)
+                freq[key] = 440.0f * power<2>((key - 69 + cents[key % 12] / 100.0f) / 12.0f);
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,106 @@
+/*
+    MidiTuning.h - MIDI Tuning Standard messages applied off the MIDI thread
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef MIDI_TUNING_H
+#define MIDI_TUNING_H
+
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "globals.h"
+
+class SynthEngine;
+
+
+/*
+ * Tuning SysEx can arrive on the audio thread (jack and LV2) so all the
+ * MIDI side does is copy a complete message into a free slot and wake
+ * the tuning thread. That works out the key frequencies, adds them to
+ * those it already has and writes the whole lot into the next of the
+ * Microtonal retune tables. The synth thread just publishes the newest
+ * of them by index between commands, so nothing is worked out there and
+ * no thread ever waits for another.
+ *
+ * Understood are the bulk dump, single note changes, with and without a
+ * bank, and the one and two byte scale/octave forms. There is only the
+ * one tuning, so program, bank and channel mask are all ignored.
+ */
+class MidiTuning
+{
+    public:
+        static constexpr uint MESSAGE_SIZE = 512; // a bulk dump is 408
+        static constexpr uint MESSAGES = 16;
+
+        MidiTuning(SynthEngine& _synth);
+       ~MidiTuning();
+        // shall not be copied nor moved
+        MidiTuning(MidiTuning&&)                 = delete;
+        MidiTuning(MidiTuning const&)            = delete;
+        MidiTuning& operator=(MidiTuning&&)      = delete;
+        MidiTuning& operator=(MidiTuning const&) = delete;
+
+        bool start();
+        void stop();
+
+        // from one MIDI thread only, which may hand over a long message
+        // in several pieces; anything other than tuning is ignored
+        void queue(const uchar *data, size_t size);
+
+        // synth thread only, publishes the newest table built
+        void apply();
+
+        uint64_t applied() const { return appliedCount.load(std::memory_order_relaxed); }
+        uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    private:
+        static void *_worker(void *arg);
+        void worker();
+        bool decode(const uchar *data, uint size, float *freq);
+        static bool isTuning(const uchar *data, uint size);
+
+        struct Message {
+            uint size;
+            uchar data[MESSAGE_SIZE];
+        };
+
+        SynthEngine& synth;
+        Message ring[MESSAGES];
+        std::atomic<uint> writeCount;
+        std::atomic<uint> readCount;
+        bool assembling; // MIDI thread only
+        float retuned[MAX_OCTAVE_SIZE]; // tuning thread only, all keys so far
+        uint retunedResets;             // the Microtonal reset count retuned is for
+        std::atomic<uint> builtCount;   // retune tables written
+        std::atomic<uint> usedCount;    // and taken up by the synth thread
+
+        pthread_t thread;
+        bool running;
+        std::atomic<bool> quit;
+        sem_t wake;
+
+        std::atomic<uint64_t> appliedCount;
+        std::atomic<uint64_t> droppedCount;
+};
+
+#endif /*MIDI_TUNING_H*/
@@ -676,7 +676,7 @@ std::string reverblist [] = {
     "LOW <n>",          "low pass filter",
     "HIGh <n>",         "high pass filter",
     "DAMp <n>",         "feedback damping",
-    "TYPe <s>",         "reverb type (Random, Freeverb, Bandwidth)",
+    "TYPe <s>",         "reverb type (Random, Freeverb, Bandwidth, Fdn)",
     "ROOm <n>",         "room size",
     "BANdwidth <n>",    "actual bandwidth (only for bandwidth type)",
     "@end","@end"
@@ -735,6 +735,7 @@ std::string choruslist [] = {
     "FEEdback <n>",     "chorus feedback",
     "CROssover <n>",    "left-right routing",
     "SUBtract <s>",     "invert output (ON {other})",
+    "CUBic <s>",        "cubic delay interpolation (ON {other})",
     "BPM <s>",          "LFO BPM sync (ON {other})",
     "STArt <n>",        "LFO BPM phase start",
     "@end","@end"
@@ -753,6 +754,7 @@ int choruslistmap[] = {
     9,
     // 10, Pflangemode is defined in Chorus.cpp, but appears to be unused.
     11,
+    12,
     EFFECT::control::bpm,
     EFFECT::control::bpmStart,
     -1
@@ -847,6 +849,7 @@ std::string distortionlist [] = {
     "HIGh <n>",         "high pass filter",
     "STEreo <s>",       "stereo (ON {other})",
     "FILter <s>",       "filter before distortion",
+    "OVErsample <n>",   "waveshaper oversampling (0 off, 1 2x, 2 4x, 3 8x)",
     "@end","@end"
 };
 
@@ -863,6 +866,7 @@ int distortionlistmap[] = {
     8,
     9,
     10,
+    11,
     -1
 };
 
@@ -1037,6 +1041,8 @@ std::string listlist [] = {
     "Tuning",           "microtonal scale tunings",
     "Keymap",           "microtonal scale keyboard map",
     "Config",           "current configuration",
+    "STats",            "audio period timing and engine statistics",
+    "METers",           "current output and part levels",
     "MLearn [s <n>]",   "midi learned controls ('@' n for full details on one line)",
     "SECtion [s]",      "copy/paste section presets",
     "History [s]",      "recent files (Patchsets, SCales, STates, Vectors, MLearn)",
@@ -1171,10 +1177,10 @@ std::string fx_presets [] = {
 // effect controls
 std::string effreverb [] = {"LEV", "PAN", "TIM", "DEL", "FEE", "none5", "none6", "LOW", "HIG", "DAM", "TYP", "ROO", "BAN", "@end"};
 std::string effecho [] = {"LEV", "PAN", "DEL", "LRD", "CRO", "FEE", "DAM", "SEP", "none8", "none9", "none10", "none11", "none12", "none13", "none14", "none15", "none16", "BPM", "@end"};
-std::string effchorus [] = {"LEV", "PAN", "FRE", "RAN", "WAV", "SHI", "DEP", "DEL", "FEE", "CRO", "none10", "SUB", "none12", "none13", "none14", "none15", "none16", "BPM", "@end"};
+std::string effchorus [] = {"LEV", "PAN", "FRE", "RAN", "WAV", "SHI", "DEP", "DEL", "FEE", "CRO", "none10", "SUB", "CUB", "none13", "none14", "none15", "none16", "BPM", "@end"};
 std::string effphaser [] = {"LEV", "PAN", "FRE", "RAN", "WAV", "SHI", "DEP", "FEE", "STA", "CRO", "SUB", "REL", "HYP", "OVE", "ANA", "none15", "none16", "BPM", "@end"};
 std::string effalienwah [] = {"LEV", "PAN", "FRE", "RAN", "WAV", "SHI", "DEP", "FEE", "DEL", "CRO", "REL", "none11", "none12", "none13", "none14", "none15", "none16", "BPM", "@end"};
-std::string effdistortion [] = {"LEV", "PAN", "MIX", "DRI", "OUT", "WAV", "INV", "LOW", "HIG", "STE", "FIL", "@end"};
+std::string effdistortion [] = {"LEV", "PAN", "MIX", "DRI", "OUT", "WAV", "INV", "LOW", "HIG", "STE", "FIL", "OVE", "@end"};
 std::string effdistypes [] = {"ATAn", "ASYm1", "POWer", "SINe", "QNTs", "ZIGzag", "LMT", "ULMt", "LLMt", "ILMt", "CLIp", "AS2", "PO2", "SGM", "@end"};
 std::string effeq [] = {"LEV", "EQB", "FIL", "FRE", "GAI", "Q", "STA"};
 std::string eqtypes [] = {"OFF", "LP1", "HP1", "LP2", "HP2", "BP2", "NOT", "PEAk", "LOW shelf", "HIGh shelf", "@end"};
@@ -115,6 +115,11 @@ void YoshimiLV2Plugin::process(uint32_t sample_count)
 {
     if (sample_count == 0) return;  // explicitly allowed by LV2 standard
 
+    // the thread is the host's, so its own mode is put back on return
+    denormal::ScopedFlushToZero ftz{runtime().flushDenormals};
+    synth.flushingDenormals.store(denormal::flushingToZero(), std::memory_order_relaxed);
+    rtlog::audioThread = true; // the host's thread, but MIDI arrives on it too
+
     /*
      * Our implementation of LV2 has a problem with envelopes. In general
      * the bigger the buffer size the shorter the envelope, and whichever
@@ -175,11 +180,16 @@ void YoshimiLV2Plugin::process(uint32_t sample_count)
 
         if (event->body.type == _midi_event_id)
         {
+            const uint8_t *msg = (const uint8_t*)(event + 1);
+            if (event->body.size > 4 && msg[0] == 0xf0)
+            {   // tuning, anything else is ignored
+                handleSysex(msg, event->body.size);
+                continue;
+            }
             if (event->body.size > sizeof(intMidiEvent.data))
                 continue;
 
             //process this midi event
-            const uint8_t *msg = (const uint8_t*)(event + 1);
             if (param_freeWheel)
                 processMidiMessage(msg);
         }
@@ -428,6 +438,7 @@ void YoshimiLV2Plugin::run(LV2_Handle h, uint32_t sample_count)
 
 void YoshimiLV2Plugin::deactivate(LV2_Handle h)
 {
+    self(h).runtime().drainRTLog();
     self(h).runtime().Log("Yoshimi LV2 plugin deactivated");
 }
 
@@ -22,6 +22,8 @@
 #define MISC_ALLOC_H
 
 #include <memory>
+#include <cstring>
+#include <unistd.h>
 
 
 /* ===== Managing Sample Buffers with unique ownership ===== */
@@ -74,4 +76,46 @@ public:
 };
 
 
+
+/* ===== Prefaulting for real-time use ===== */
+
+/* Locking memory only pins pages that are already mapped; a buffer that was
+ * allocated but never written may still be backed by the shared zero page
+ * and will fault on first use in the audio thread. Writing back one value
+ * per page forces the kernel to provide real pages now, without changing
+ * the contents. Returns the number of bytes covered, for reporting.
+ */
+inline size_t prefaultPages(void* mem, size_t bytes)
+{
+    if (!mem || bytes == 0)
+        return 0;
+    static const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    volatile char* p = static_cast<volatile char*>(mem);
+    for (size_t i = 0; i < bytes; i += pageSize)
+        p[i] = p[i];
+    p[bytes - 1] = p[bytes - 1];
+    return bytes;
+}
+
+inline size_t prefaultPages(Samples& buff, size_t elemCnt)
+{
+    return prefaultPages(buff.get(), elemCnt * sizeof(float));
+}
+
+
+/* Grow the calling thread's stack to the given depth while it is
+ * not yet time critical, so later deep calls don't fault.
+ * Must be called from the thread concerned, typically as the first
+ * thing the audio thread does.
+ */
+constexpr size_t PREFAULT_STACK = 64 * 1024;
+
+__attribute__((noinline)) inline void prefaultStack()
+{
+    char stack[PREFAULT_STACK];
+    memset(stack, 0, PREFAULT_STACK);
+    asm volatile("" : : "r"(stack) : "memory"); // don't let the writes be optimised out
+}
+
+
 #endif /*MISC_ALLOC_H*/
@@ -67,6 +67,8 @@ namespace { // constants used in the implementation
         {"state",             'S',  "<file>",   0                  , "load .state complete machine setup file", 2},
         {"load-guitheme",     'T',  "<file>",   0                  , "load .clr GUI theme file",                2},
         {"null",               13,  NULL,       0                  , "use Null-backend without audio/midi",     0},
+        {"lock-memory",        14,  NULL,       0                  , "lock memory and prefault buffers for real-time use", 1},
+        {"denormal-check",     15,  NULL,       0                  , "count denormals leaving effects and filters", 1},
 #if defined(JACK_SESSION)
         {"jack-session-uuid", 'U',  "<uuid>",   0                  , "jack session uuid",            2},
         {"jack-session-file", 'u',  "<file>",   0                  , "load named jack session file", 2},
@@ -111,6 +113,8 @@ namespace { // constants used in the implementation
             case 'S': recordOption(); break;     // load complete state file
 
             case 13:  recordToggle(); break;     // NULL backend (no audio and MIDI)
+            case 14:  recordToggle(); break;     // lock memory
+            case 15:  recordToggle(); break;     // denormal diagnostics
 
 #if defined(JACK_SESSION)
             case 'u': recordOption(); break;     // load Jack session file
@@ -297,6 +301,14 @@ void CmdOptions::applyTo (Config& config)  const
                 config.audioEngine = no_audio;
                 config.midiEngine  = no_midi;
                 break;
+
+            case 14:
+                config.memoryLockCmd = true;
+                break;
+
+            case 15:
+                config.denormalCheck = true;
+                break;
         }
     }
     if (config.jackSessionUuid.size() and config.jackSessionFile.size())
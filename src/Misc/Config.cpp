@@ -25,6 +25,8 @@
 */
 
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
 #include <iostream>
 #include <fenv.h>
 #include <errno.h>
@@ -35,6 +37,7 @@
 #include <unistd.h>
 #include <cassert>
 #include <memory>
+#include <fstream>
 
 #if defined(JACK_SESSION)
 #include <jack/session.h>
@@ -110,8 +113,21 @@ Config::Config(SynthEngine& synthInstance)
     , startJack{false}
     , connectJackaudio{true}
     , connectJackChanged{false}
+    , jackDirectOutput{true}
     , alsaAudioDevice{"default"}
     , alsaMidiDevice{"default"}
+    , alsaChannels{2}
+    , alsaDither{false}
+    , alsaAdaptive{false}
+    , memoryLock{false}
+    , memoryLockCmd{false}
+    , fastWaveshaping{true}
+    , flushDenormals{true}
+    , denormalCheck{false}
+    , voiceLimit{0}
+    , loadCeiling{0}
+    , renderThreads{0}
+    , mergeExceptions{"64-69 120-127"}
     , loadDefaultState{false}
     , defaultStateName{}
     , defaultSession{}
@@ -285,7 +301,20 @@ void Config::populateFromPrimary()
     audioEngine         = primary.audioEngine;
     midiEngine          = primary.midiEngine;
     alsaMidiType        = primary.alsaMidiType;
+    alsaChannels        = primary.alsaChannels;
+    alsaDither          = primary.alsaDither;
+    alsaAdaptive        = primary.alsaAdaptive;
+    memoryLock          = primary.memoryLock;
+    memoryLockCmd       = primary.memoryLockCmd;
+    fastWaveshaping     = primary.fastWaveshaping;
+    flushDenormals      = primary.flushDenormals;
+    denormalCheck       = primary.denormalCheck;
+    voiceLimit          = primary.voiceLimit;
+    loadCeiling         = primary.loadCeiling;
+    renderThreads       = primary.renderThreads;
+    mergeExceptions     = primary.mergeExceptions;
     connectJackaudio    = primary.connectJackaudio;
+    jackDirectOutput    = primary.jackDirectOutput;
     loadDefaultState    = primary.loadDefaultState;
     Interpolation       = primary.Interpolation;
 //presetsDirlist                                        /////TODO shouldn't we populate these too? if yes -> use a STL container (e.g. std::array), which can be bulk copied
@@ -316,8 +345,18 @@ void Config::populateFromPrimary()
 }
 
 
+void Config::drainRTLog()
+{
+    RTLog::Entry entry;
+    uint repeated;
+    while (rtLog.fetch(entry, repeated))
+        Log(RTLog::format(entry, repeated), rtlog::describe(entry.id).severity);
+}
+
+
 void Config::flushLog()
 {
+    drainRTLog();
     for (auto& line : logList)
         cout << line << endl;
     logList.clear();
@@ -875,6 +914,10 @@ bool Config::extractConfigData(XMLwrapper& xml)
         // alsa settings
         alsaAudioDevice = xml.getparstr("linux_alsa_audio_dev");
         alsaMidiDevice = xml.getparstr("linux_alsa_midi_dev");
+        alsaChannels = xml.getpar("linux_alsa_audio_channels", alsaChannels, 2, 2 + 2 * NUM_MIDI_PARTS);
+        alsaChannels -= alsaChannels % 2; // the main mix then a pair for each part
+        alsaDither = xml.getparbool("linux_alsa_audio_dither", alsaDither);
+        alsaAdaptive = xml.getparbool("linux_alsa_adaptive_latency", alsaAdaptive);
         if (!rateChanged)
             samplerate = xml.getpar("sample_rate", samplerate, 44100, 192000);
 
@@ -883,6 +926,17 @@ bool Config::extractConfigData(XMLwrapper& xml)
         jackMidiDevice = xml.getparstr("linux_jack_midi_dev");
         if (!connectJackChanged)
             connectJackaudio = xml.getpar("connect_jack_audio", connectJackaudio, 0, 1);
+        jackDirectOutput = xml.getparbool("jack_direct_output", jackDirectOutput);
+
+        memoryLock = xml.getparbool("lock_memory", memoryLock);
+        fastWaveshaping = xml.getparbool("fast_waveshaping", fastWaveshaping);
+        flushDenormals = xml.getparbool("flush_denormals", flushDenormals);
+        voiceLimit = xml.getpar("voice_limit", voiceLimit, 0, NUM_MIDI_PARTS * POLYPHONY);
+        loadCeiling = xml.getpar("load_ceiling", loadCeiling, 0, 100);
+        renderThreads = xml.getpar("render_threads", renderThreads, 0, RenderPool::MAX_THREADS);
+        string merge = xml.getparstr("merge_exceptions");
+        if (!merge.empty()) // missing in older files, "none" for no exceptions
+            mergeExceptions = merge;
 
         // midi options
         midi_bank_root = xml.getpar("midi_bank_root", midi_bank_root, 0, 128);
@@ -961,11 +1015,22 @@ void Config::addConfigXML(XMLwrapper& xml)
     xml.addparstr("linux_jack_server", jackServer);
     xml.addparstr("linux_jack_midi_dev", jackMidiDevice);
     xml.addpar("connect_jack_audio", connectJackaudio);
+    xml.addparbool("jack_direct_output", jackDirectOutput);
 
     xml.addpar("alsa_midi_type", alsaMidiType);
     xml.addparstr("linux_alsa_audio_dev", alsaAudioDevice);
     xml.addparstr("linux_alsa_midi_dev", alsaMidiDevice);
+    xml.addpar("linux_alsa_audio_channels", alsaChannels);
+    xml.addparbool("linux_alsa_audio_dither", alsaDither);
+    xml.addparbool("linux_alsa_adaptive_latency", alsaAdaptive);
     xml.addpar("sample_rate", samplerate);
+    xml.addparbool("lock_memory", memoryLock);
+    xml.addparbool("fast_waveshaping", fastWaveshaping);
+    xml.addparbool("flush_denormals", flushDenormals);
+    xml.addpar("voice_limit", voiceLimit);
+    xml.addpar("load_ceiling", loadCeiling);
+    xml.addpar("render_threads", renderThreads);
+    xml.addparstr("merge_exceptions", mergeExceptions);
 
     xml.addpar("presetsCurrentRootID", presetsRootID);
     xml.addpar("midi_bank_root", midi_bank_root);
@@ -1300,6 +1365,47 @@ bool Config::startThread(pthread_t *pth, ThreadFun* threadFun, void *arg,
 }
 
 
+/*
+ * Pin the process in RAM so the audio thread never waits on a page fault.
+ * MCL_FUTURE also covers later allocations (notes, effects, PAD tables)
+ * but with a limited RLIMIT_MEMLOCK it would make those allocations fail
+ * once the limit is reached, so then we only lock what is mapped now.
+ */
+bool Config::lockMemory()
+{
+    int flags = MCL_CURRENT;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY)
+        flags |= MCL_FUTURE;
+    else
+        Log("Memory lock limit is finite, later allocations will not be locked");
+
+    if (mlockall(flags) != 0)
+    {
+        Log("Failed to lock memory " + string(strerror(errno)), _SYS_::LogError);
+        return false;
+    }
+    return true;
+}
+
+
+// as reported by the kernel, so includes everything not just our buffers
+string Config::lockedFootprint()
+{
+    std::ifstream status("/proc/self/status");
+    string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmLck:") == 0)
+        {
+            size_t pos = line.find_first_not_of(" \t", 6);
+            return pos == string::npos ? "unknown" : line.substr(pos);
+        }
+    }
+    return "unknown";
+}
+
+
 void Config::signalCheck()
 {
     #if defined(JACK_SESSION)
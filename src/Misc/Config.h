@@ -35,6 +35,7 @@
 
 #include "Misc/Alloc.h"
 #include "Misc/InstanceManager.h"
+#include "Misc/RTLog.h"
 #include "MusicIO/MusicClient.h"
 #ifdef GUI_FLTK
 #include "FL/Fl.H"
@@ -76,6 +77,7 @@ class Config
         void Log(string const& msg, char tostderr = _SYS_::LogNormal);
         void LogError(string const& msg);
         void flushLog();
+        void drainRTLog();
         bool loadPresetsList();
         bool savePresetsList();
         bool saveMasterConfig();
@@ -101,6 +103,8 @@ class Config
         using ThreadFun = void*(void*);
         bool startThread(pthread_t*, ThreadFun*, void* arg,
                          bool schedfifo, char lowprio, string const& name = "");
+        bool lockMemory();
+        string lockedFootprint();
         string const& programCmd()     { return programcommand; }
 
         bool    isLV2;
@@ -134,12 +138,25 @@ class Config
         bool          startJack;
         bool          connectJackaudio;
         bool          connectJackChanged;
+        bool          jackDirectOutput;   // render straight into jack port buffers
         string        jackSessionUuid;
         static string globalJackSessionUuid;
 
         string        alsaAudioDevice;
         string        alsaMidiDevice;
+        uint          alsaChannels;       // beyond 2 carry the part direct outs
+        bool          alsaDither;
+        bool          alsaAdaptive;       // add periods when xruns cluster
         string        nameTag;
+        bool          memoryLock;         // mlockall and prefault before audio starts
+        bool          memoryLockCmd;      // the same asked for on the command line, not saved
+        bool          fastWaveshaping;    // approximations in the distortion effect
+        bool          flushDenormals;     // FTZ/DAZ in every thread that renders audio
+        bool          denormalCheck;      // count denormals leaving effects and filters
+        uint          voiceLimit;         // notes over all parts, 0 for no limit
+        uint          loadCeiling;        // percent of the period, 0 for no ceiling
+        uint          renderThreads;      // helpers for the notes of busy parts, 0 for none
+        string        mergeExceptions;    // controllers never merged within a period, eg "64-69 120-127"
 
         bool          loadDefaultState;
         string        defaultStateName;
@@ -246,6 +263,7 @@ class Config
         Vectordata vectordata;
 
         list<string> logList;
+        RTLog rtLog; // for the audio threads, see drainRTLog()
         string manualFile;
         int exitType;
 
@@ -0,0 +1,226 @@
+/*
+    Denormals.h - Flush-to-zero floating point mode and denormal diagnostics
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DENORMALS_H
+#define DENORMALS_H
+
+#include <sys/types.h>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#include "globals.h"
+
+
+/*
+ * Feedback paths (reverb, echo, phaser, filters) decay towards zero on
+ * quiet tails and pass through the denormal range on the way. On most
+ * CPUs arithmetic on those values takes a slow path that can cost a
+ * hundred times more, which is why the CPU load jumps just as notes are
+ * released. Rather than adding tiny DC offsets all over the DSP code
+ * we tell the FPU to treat them as zero. The offsets are only kept for
+ * when it doesn't, see bias() below.
+ *
+ * The mode is a property of the thread, so every thread that renders
+ * audio has to set it for itself before it starts.
+ */
+namespace denormal {
+
+#if defined(__SSE__)
+constexpr uint MXCSR_FTZ = 0x8000; // flush results to zero
+#if defined(__SSE2__)
+constexpr uint MXCSR_DAZ = 0x0040; // read denormal inputs as zero
+#else
+constexpr uint MXCSR_DAZ = 0;      // the first SSE CPUs fault on setting it
+#endif
+#elif defined(__aarch64__) || defined(__arm__)
+constexpr uint64_t FPCR_FZ = 1 << 24; // same bit in FPCR and in the old FPSCR
+#endif
+
+// returns true if the calling thread now flushes denormals
+inline bool enableFlushToZero()
+{
+#if defined(__SSE__)
+    _mm_setcsr(_mm_getcsr() | MXCSR_FTZ | MXCSR_DAZ);
+    return (_mm_getcsr() & MXCSR_FTZ) != 0;
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    asm volatile("msr fpcr, %0" : : "r"(fpcr | FPCR_FZ));
+    return true;
+#elif defined(__arm__) && defined(__ARM_FP)
+    uint32_t fpscr;
+    asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    asm volatile("vmsr fpscr, %0" : : "r"(fpscr | uint32_t(FPCR_FZ)));
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline bool flushingToZero()
+{
+#if defined(__SSE__)
+    return (_mm_getcsr() & MXCSR_FTZ) != 0;
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+    return (fpcr & FPCR_FZ) != 0;
+#elif defined(__arm__) && defined(__ARM_FP)
+    uint32_t fpscr;
+    asm volatile("vmrs %0, fpscr" : "=r"(fpscr));
+    return (fpscr & uint32_t(FPCR_FZ)) != 0;
+#else
+    return false;
+#endif
+}
+
+
+/*
+ * The DC offset for a feedback path, or nothing when the calling thread
+ * flushes anyway (flush_denormals off, or a CPU we can't set). Take it
+ * once per block rather than per sample.
+ */
+inline float bias(float amount)
+{
+    return flushingToZero() ? 0.0f : amount;
+}
+
+
+/*
+ * For a plugin, where the thread belongs to the host, the mode is set
+ * around our own processing and the host's setting put back after.
+ */
+class ScopedFlushToZero
+{
+    public:
+        ScopedFlushToZero(bool wanted)
+        {
+#if defined(__SSE__)
+            saved = _mm_getcsr();
+#elif defined(__aarch64__)
+            asm volatile("mrs %0, fpcr" : "=r"(saved));
+#elif defined(__arm__) && defined(__ARM_FP)
+            asm volatile("vmrs %0, fpscr" : "=r"(saved));
+#endif
+            if (wanted)
+                enableFlushToZero();
+        }
+
+        ~ScopedFlushToZero()
+        {
+#if defined(__SSE__)
+            _mm_setcsr(saved);
+#elif defined(__aarch64__)
+            asm volatile("msr fpcr, %0" : : "r"(saved));
+#elif defined(__arm__) && defined(__ARM_FP)
+            asm volatile("vmsr fpscr, %0" : : "r"(saved));
+#endif
+        }
+        // shall not be copied nor moved
+        ScopedFlushToZero(ScopedFlushToZero&&)                 = delete;
+        ScopedFlushToZero(ScopedFlushToZero const&)            = delete;
+        ScopedFlushToZero& operator=(ScopedFlushToZero&&)      = delete;
+        ScopedFlushToZero& operator=(ScopedFlushToZero const&) = delete;
+
+    private:
+#if defined(__aarch64__)
+        uint64_t saved{0};
+#else
+        uint32_t saved{0};
+#endif
+};
+
+
+/*
+ * Tested on the bit pattern, so it still works when DAZ is set and the
+ * FPU would compare a denormal as equal to zero.
+ */
+inline uint countInBlock(const float *buf, int frames)
+{
+    uint found = 0;
+    for (int i = 0; i < frames; ++i)
+    {
+        uint32_t bits;
+        memcpy(&bits, buf + i, sizeof(bits));
+        found += ((bits & 0x7f800000) == 0) & ((bits & 0x007fffff) != 0);
+    }
+    return found;
+}
+
+} // namespace denormal
+
+
+/*
+ * Diagnostic tally of denormal samples leaving each kind of component,
+ * only filled in when started with --denormal-check. Slots are the
+ * effect types followed by the three filter categories. Notes may be
+ * rendered on more than one thread so the counts are atomic.
+ */
+class DenormalCounter
+{
+    public:
+        static constexpr uint EFFECTS = EFFECT::type::count - EFFECT::type::none;
+        static constexpr uint FILTERS = 3; // analog, formant, state variable
+        static constexpr uint SLOTS = EFFECTS + FILTERS;
+
+        DenormalCounter() { reset(); }
+        // shall not be copied nor moved
+        DenormalCounter(DenormalCounter&&)                 = delete;
+        DenormalCounter(DenormalCounter const&)            = delete;
+        DenormalCounter& operator=(DenormalCounter&&)      = delete;
+        DenormalCounter& operator=(DenormalCounter const&) = delete;
+
+        void reset()
+        {
+            for (auto& slot : counts)
+                slot.store(0, std::memory_order_relaxed);
+        }
+
+        void scanEffect(uint effectType, const float *left, const float *right, int frames)
+        {
+            if (effectType < EFFECTS)
+                add(effectType, denormal::countInBlock(left, frames) + denormal::countInBlock(right, frames));
+        }
+
+        void scanFilter(uint category, const float *buf, int frames)
+        {
+            if (category < FILTERS)
+                add(EFFECTS + category, denormal::countInBlock(buf, frames));
+        }
+
+        uint64_t effect(uint effectType) const { return counts[effectType].load(std::memory_order_relaxed); }
+        uint64_t filter(uint category)   const { return counts[EFFECTS + category].load(std::memory_order_relaxed); }
+
+    private:
+        void add(uint slot, uint found)
+        {
+            if (found)
+                counts[slot].fetch_add(found, std::memory_order_relaxed);
+        }
+
+        std::atomic<uint64_t> counts[SLOTS];
+};
+
+#endif /*DENORMALS_H*/
@@ -54,6 +54,14 @@ inline std::string asString(unsigned long n)
 }
 
 
+inline std::string asString(unsigned long long n)
+{
+    std::ostringstream oss;
+    oss << n;
+    return std::string(oss.str());
+}
+
+
 inline std::string asString(long n)
 {
    std::ostringstream oss;
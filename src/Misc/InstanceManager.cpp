@@ -346,6 +346,8 @@ bool InstanceManager::Instance::startUp(PluginCreator pluginCreator)
                 synth->loadHistory();
             // discover persistent bank file structure
             synth->installBanks();
+            if (not isLV2)
+                synth->prepareRealtime();
             //
             // Note: the following launches or connects to the processing threads
             if (not client->start())
@@ -528,8 +530,11 @@ void InstanceManager::SynthGroom::dutyCycle(function<void(SynthEngine&)>& handle
             break;
             case RUNNING:
                 if (instance.runtime().runSynth.load(std::memory_order_acquire))
+                {
+                    instance.runtime().drainRTLog();
                      // perform GUI and command returns for this instance
                     handleEvents(instance.getSynth());
+                }
                 else
                     instance.shutDown();
             break;
@@ -0,0 +1,226 @@
+/*
+    Meters.h - VU meter accumulation and wait-free publication
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef METERS_H
+#define METERS_H
+
+#include <sys/types.h>
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <cmath>
+
+#include "globals.h"
+
+
+/*
+ * One block of meter readings, covering roughly 50mS of audio.
+ * While it is being accumulated in the audio thread the rms fields
+ * hold the sum of squares, they are only converted on publication.
+ * A part that isn't running shows -1 in all its fields.
+ */
+struct MeterBlock
+{
+    float peakL;
+    float peakR;
+    float rmsL;
+    float rmsR;
+    float truePeakL;
+    float truePeakR;
+    float partPeakL[NUM_MIDI_PARTS];
+    float partPeakR[NUM_MIDI_PARTS];
+    float partRmsL[NUM_MIDI_PARTS];
+    float partRmsR[NUM_MIDI_PARTS];
+    float partTrueL[NUM_MIDI_PARTS];
+    float partTrueR[NUM_MIDI_PARTS];
+    uint frames;
+    uint64_t number; // counts up from zero, set by the publisher
+
+    void clear()
+    {
+        peakL = peakR = rmsL = rmsR = truePeakL = truePeakR = 0.0f;
+        for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+            clearPart(npart, -1.0f);
+        frames = 0;
+        number = 0;
+    }
+
+    void clearPart(int npart, float value)
+    {
+        partPeakL[npart] = partPeakR[npart] = value;
+        partRmsL[npart] = partRmsR[npart] = value;
+        partTrueL[npart] = partTrueR[npart] = value;
+    }
+};
+
+
+namespace meter {
+
+// plain loops without branches so the compiler can vectorise them
+inline float blockPeak(const float *__restrict buf, int frames, float peak)
+{
+    for (int i = 0; i < frames; ++i)
+        peak = std::max(peak, fabsf(buf[i]));
+    return peak;
+}
+
+inline float blockSquares(const float *__restrict buf, int frames, float sum)
+{
+    for (int i = 0; i < frames; ++i)
+        sum += buf[i] * buf[i];
+    return sum;
+}
+
+} // namespace meter
+
+
+/*
+ * Approximate inter-sample (true) peak, using cubic interpolation at
+ * 4x oversampling rather than the long filter of ITU BS.1770, which
+ * would be far too costly on every part. The interpolated value can't
+ * exceed 1.25 times the largest of the four samples it is made from,
+ * so blocks that can't raise the held value are not scanned at all.
+ */
+class TruePeak
+{
+    public:
+        TruePeak() : x0{0}, x1{0}, x2{0} {}
+
+        // samplePeak is the plain peak of this block, already folded into held
+        float process(const float *buf, int frames, float samplePeak, float held)
+        {
+            if (frames < 1)
+                return held;
+            float edge = std::max(fabsf(x0), std::max(fabsf(x1), fabsf(x2)));
+            if (std::max(samplePeak, edge) * 1.25f <= held)
+            {
+                follow(buf, frames);
+                return held;
+            }
+            float a = x0, b = x1, c = x2;
+            for (int i = 0; i < frames; ++i)
+            {
+                float d = buf[i];
+                float q1 = -0.0703125f * a + 0.8671875f * b + 0.2265625f * c - 0.0234375f * d;
+                float q2 = -0.0625f * (a + d) + 0.5625f * (b + c);
+                float q3 = -0.0234375f * a + 0.2265625f * b + 0.8671875f * c - 0.0703125f * d;
+                held = std::max(held, std::max(fabsf(q1), std::max(fabsf(q2), fabsf(q3))));
+                a = b;
+                b = c;
+                c = d;
+            }
+            x0 = a;
+            x1 = b;
+            x2 = c;
+            return held;
+        }
+
+    private:
+        void follow(const float *buf, int frames)
+        {
+            if (frames >= 3)
+            {
+                x0 = buf[frames - 3];
+                x1 = buf[frames - 2];
+                x2 = buf[frames - 1];
+                return;
+            }
+            for (int i = 0; i < frames; ++i)
+            {
+                x0 = x1;
+                x1 = x2;
+                x2 = buf[i];
+            }
+        }
+
+        float x0, x1, x2; // the last three samples of the previous block
+};
+
+
+/*
+ * Hands meter blocks from the audio thread to any number of readers
+ * (GUI, CLI, remote monitoring) through a short history ring. Each slot
+ * is a seqlock: the writer never waits, a reader that catches a slot
+ * mid-write simply tries again. Readers only fail if they are so slow
+ * that the slot has been reused by then.
+ */
+class MeterPublisher
+{
+    public:
+        static constexpr uint HISTORY = 16; // nearly a second at the usual rate
+
+        MeterPublisher()
+            : published{0}
+        {
+            for (auto& s : seq)
+                s.store(0, std::memory_order_relaxed);
+        }
+        // shall not be copied nor moved
+        MeterPublisher(MeterPublisher&&)                 = delete;
+        MeterPublisher(MeterPublisher const&)            = delete;
+        MeterPublisher& operator=(MeterPublisher&&)      = delete;
+        MeterPublisher& operator=(MeterPublisher const&) = delete;
+
+        // audio thread only
+        void publish(MeterBlock const& block)
+        {
+            uint64_t number = published.load(std::memory_order_relaxed);
+            uint slot = number % HISTORY;
+            seq[slot].store(number * 2 + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            ring[slot] = block;
+            ring[slot].number = number;
+            seq[slot].store(number * 2 + 2, std::memory_order_release);
+            published.store(number + 1, std::memory_order_release);
+        }
+
+        // number of blocks published so far
+        uint64_t count() const { return published.load(std::memory_order_acquire); }
+
+        // age 0 is the most recent block
+        bool read(MeterBlock& out, uint age = 0) const
+        {
+            uint64_t total = count();
+            if (age >= HISTORY || age >= total)
+                return false;
+            uint64_t number = total - 1 - age;
+            uint slot = number % HISTORY;
+            for (int tries = 0; tries < 4; ++tries)
+            {
+                uint64_t before = seq[slot].load(std::memory_order_acquire);
+                if (before > number * 2 + 2)
+                    return false; // already overwritten
+                if (before != number * 2 + 2)
+                    continue;
+                out = ring[slot];
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq[slot].load(std::memory_order_relaxed) == before)
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        std::atomic<uint64_t> published;
+        std::atomic<uint64_t> seq[HISTORY];
+        MeterBlock ring[HISTORY];
+};
+
+#endif /*METERS_H*/
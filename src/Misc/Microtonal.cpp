@@ -135,6 +135,8 @@ void Microtonal::defaults(int type)
         Pname = string("12tET");
         Pcomment = string("Default Tuning");
 
+        // drop any MIDI Tuning Standard changes too
+        resets.fetch_add(1, std::memory_order_release);
     }
     if (type != 1) // not tuning
     {
@@ -184,6 +186,36 @@ void Microtonal::setglobalfinedetune(float control)
     // was float globalfinedetunerap = powf(2.0f, (Pglobalfinedetune - 64.0f) / 1200.0f);
 }
 
+// Frequency ratio of a keyshift in scale steps, when the scale is enabled
+float Microtonal::keyshiftRatio(int keyshift)
+{
+    if (!keyshift)
+        return 1.0f;
+    int kskey = (keyshift + octavesize * 100) % octavesize;
+    int ksoct = (keyshift + octavesize * 100) / octavesize - 100;
+    float rap_keyshift = (!kskey) ? 1.0f : (octave[kskey - 1].tuning);
+    rap_keyshift *= powf(octave[octavesize - 1].tuning, ksoct);
+    return rap_keyshift;
+}
+
+
+// Rebuild the note-on table, see noteFreq()
+void Microtonal::compile()
+{
+    uint next = (published.load(std::memory_order_relaxed) + 1) % TUNING_RING;
+    Tuning& table = tunings[next];
+    for (int note = 0; note < MAX_OCTAVE_SIZE; ++note)
+    {
+        table.freq[note] = getNoteFreq(note, 0);
+        table.fixed[note] = getFixedNoteFreq(note);
+    }
+    for (int keyshift = MIN_KEYSHIFT; keyshift <= MAX_KEYSHIFT; ++keyshift)
+        table.shift[keyshift - MIN_KEYSHIFT] = Penabled ? keyshiftRatio(keyshift)
+                                                        : power<2>(keyshift / 12.0f);
+    published.store(next, std::memory_order_release);
+}
+
+
 // Get the frequency according to the note number
 float Microtonal::getNoteFreq(int note, int keyshift)
 {
@@ -199,16 +231,7 @@ float Microtonal::getNoteFreq(int note, int keyshift)
         return getFixedNoteFreq(note + keyshift) * globalfinedetunerap;
 
     int scaleshift = (Pscaleshift - 64 + octavesize * 100) % octavesize;
-
-    // compute the keyshift
-    float rap_keyshift = 1.0f;
-    if (keyshift)
-    {
-        int kskey = (keyshift + octavesize * 100) % octavesize;
-        int ksoct = (keyshift + octavesize * 100) / octavesize - 100;
-        rap_keyshift  = (!kskey) ? 1.0f : (octave[kskey - 1].tuning);
-        rap_keyshift *= powf(octave[octavesize - 1].tuning, ksoct);
-    }
+    float rap_keyshift = keyshiftRatio(keyshift);
 
     float freq;
     if (Pmappingenabled && Pmapsize > 0) // added check to stop crash till it's sorted properly
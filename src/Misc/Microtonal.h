@@ -28,6 +28,7 @@
 
 #include <cmath>
 #include <string>
+#include <atomic>
 #include "globals.h"
 #include "Misc/NumericFuncs.h"
 
@@ -41,10 +42,32 @@ class Microtonal
 {
     public:
        ~Microtonal() = default;
-        Microtonal(SynthEngine *_synth): synth(_synth) { defaults(); }
+        Microtonal(SynthEngine *_synth): published{0}, retunes{}, retunePublished{0}, resets{0}, synth(_synth) { defaults(); compile(); }
         void  defaults(int type = 0);
         float getNoteFreq(int note, int keyshift);
         float getFixedNoteFreq(int note);
+
+        static constexpr int MIN_KEYSHIFT = -128; // part and master keyshift together
+        static constexpr int MAX_KEYSHIFT = 127;
+
+        void  compile();
+        float noteFreq(int note, int keyshift, bool fixed) const;
+
+        /*
+         * Absolute key frequencies from MIDI Tuning Standard messages,
+         * taking precedence over the scale. MidiTuning builds each table
+         * on its own thread and the synth thread only publishes it by
+         * index. A table made before the last reset of the tuning is
+         * ignored, so defaults() drops them without touching the ring.
+         */
+        struct Retune {
+            float freq[MAX_OCTAVE_SIZE]; // 0 leaves a key as it is
+            uint resets;                 // the count this was made for
+        };
+        static constexpr uint RETUNE_RING = 4;
+        Retune& retuneSlot(uint n) { return retunes[n % RETUNE_RING]; } // tuning thread
+        void publishRetune(uint n) { retunePublished.store(n % RETUNE_RING, std::memory_order_release); } // synth thread
+        uint resetCount() const { return resets.load(std::memory_order_acquire); }
         float getLimits(CommandBlock *getData);
 
         // Parameters
@@ -96,6 +119,26 @@ class Microtonal
         int  loadXML(string const& filename);
 
     private:
+        /*
+         * The scale and keymap worked out for every key, so a note-on only
+         * has to look up its frequency. Rebuilt by compile() whenever any of
+         * them change, into the next of a small ring, then published by
+         * index; a reader would have to stall through several rebuilds to
+         * see a table change under it.
+         */
+        struct Tuning {
+            float freq[MAX_OCTAVE_SIZE];  // with no keyshift, -1 when not mapped
+            float fixed[MAX_OCTAVE_SIZE]; // for drum mode
+            float shift[MAX_KEYSHIFT - MIN_KEYSHIFT + 1];
+        };
+        static constexpr uint TUNING_RING = 4;
+        Tuning tunings[TUNING_RING];
+        std::atomic<uint> published;
+        Retune retunes[RETUNE_RING];
+        std::atomic<uint> retunePublished;
+        std::atomic<uint> resets;
+
+        float keyshiftRatio(int keyshift);
         int getLineFromText(string& page, string& line);
         string reformatline(string text);
         int linetotunings(uint nline, string text);
@@ -128,5 +171,24 @@ inline float Microtonal::getFixedNoteFreq(int note)
     return power<2>(float(note - PrefNote) / 12.0f) * PrefFreq;
 }
 
+// audio thread, note is 0 to 127
+inline float Microtonal::noteFreq(int note, int keyshift, bool fixed) const
+{
+    Tuning const& table = tunings[published.load(std::memory_order_acquire)];
+    if (fixed)
+        return table.fixed[note];
+    Retune const& retune = retunes[retunePublished.load(std::memory_order_acquire)];
+    float freq = table.freq[note];
+    if (retune.resets == resets.load(std::memory_order_relaxed) && retune.freq[note] > 0.0f)
+        freq = retune.freq[note];
+    if (freq < 0.0f)
+        return freq;
+    if (keyshift < MIN_KEYSHIFT)
+        keyshift = MIN_KEYSHIFT;
+    else if (keyshift > MAX_KEYSHIFT)
+        keyshift = MAX_KEYSHIFT;
+    return freq * table.shift[keyshift - MIN_KEYSHIFT];
+}
+
 
 #endif
@@ -46,6 +46,9 @@
 #include "Interface/TextLists.h"
 #include "Synth/Resonance.h"
 #include "Misc/Part.h"
+#include "Misc/Meters.h"
+#include "Misc/VoiceManager.h"
+#include "Misc/RenderPool.h"
 
 #include <cassert>
 
@@ -56,10 +59,12 @@ using file::findLeafName;
 using func::findSplitPoint;
 using func::setAllPan;
 using func::decibel;
+using func::power;
 using std::string;
 
 Part::Part(uchar id, Microtonal* microtonal_, fft::Calc& fft_, SynthEngine& _synth) :
     ctl{new Controller(&_synth)},
+    noteShift{0},
     partID{id},
     partoutl(_synth.buffersize),
     partoutr(_synth.buffersize),
@@ -67,11 +72,16 @@ Part::Part(uchar id, Microtonal* microtonal_, fft::Calc& fft_, SynthEngine& _syn
     tmpoutr(_synth.getRuntime().genMixr),
     microtonal(microtonal_),
     fft(fft_),
+    spreadNotes{false},
+    jobNs{0},
     prevNote{-1},
     prevPos{0},
     prevFreq{-1.0f},
     prevLegatoMode{false},
     killallnotes(false),
+    idle{false},
+    carried{0},
+    voiceCostNs{0.0f},
     oldFilterState{-1},
     oldFilterQstate{-1},
     oldBendState{-1},
@@ -99,8 +109,8 @@ Part::Part(uchar id, Microtonal* microtonal_, fft::Calc& fft_, SynthEngine& _syn
 
     for (int n = 0; n < NUM_PART_EFX + 1; ++n)
     {
-        partfxinputl[n].reset(synth->buffersize);
-        partfxinputr[n].reset(synth->buffersize);
+        partfxinputl[n].reset(synth->buffersize + synth->controlsize);
+        partfxinputr[n].reset(synth->buffersize + synth->controlsize);
         Pefxbypass[n] = false;
     }
 
@@ -117,6 +127,22 @@ Part::Part(uchar id, Microtonal* microtonal_, fft::Calc& fft_, SynthEngine& _syn
             partnote[i].kitItem[j].padnote = NULL;
         }
         partnote[i].time = 0;
+        partnote[i].stolen = false;
+        partnote[i].level = 0.0f;
+        partnote[i].mpeChannel = -1;
+        partnote[i].expr.reset(new NoteExpression{1.0f, 0.0f, 1.0f, 1.0f});
+        partnote[i].prev = -1;
+        partnote[i].next = (i + 1 < POLYPHONY) ? i + 1 : -1;
+        partnote[i].keyPrev = -1;
+        partnote[i].keyNext = -1;
+    }
+    activeHead = -1;
+    activeTail = -1;
+    freeHead = 0;
+    for (int key = 0; key < 128; ++key)
+    {
+        keyHead[key] = -1;
+        keyTail[key] = -1;
     }
     cleanup();
     /*
@@ -146,6 +172,9 @@ void Part::defaults(int npart)
     Pkeymode = PART_NORMAL;
     PchannelATchoice = 0;
     PkeyATchoice = 0;
+    PmpeChannels = 0;
+    PmpeBendRange = 48;
+    resetMpeChannels();
     setVolume(96);
     TransVolume = 128; // ensure it always gets set
     Pkeyshift = 64;
@@ -171,17 +200,10 @@ void Part::defaults(int npart)
     setNoteMap(0);
 }
 
+// the frequencies themselves are looked up at NoteOn, see Microtonal::noteFreq()
 void Part::setNoteMap(int keyshift)
 {
-    for (int i = 0; i < MAX_OCTAVE_SIZE; ++i)
-    {
-        if (Pdrummode)
-            PnoteMap[i] = microtonal->getFixedNoteFreq(i);
-        else
-        {
-            PnoteMap[i] = microtonal->getNoteFreq(i, keyshift + synth->Pkeyshift - 64);
-        }
-    }
+    noteShift = keyshift + synth->Pkeyshift - 64;
 }
 
 
@@ -234,8 +256,8 @@ void Part::cleanup()
 {
     int enablepart = Penabled;
     Penabled = 0;
-    for (int k = 0; k < POLYPHONY; ++k)
-        KillNotePos(k);
+    while (activeHead >= 0)
+        KillNotePos(activeHead);
     memset(partoutl.get(), 0, synth->bufferbytes);
     memset(partoutr.get(), 0, synth->bufferbytes);
 
@@ -243,14 +265,34 @@ void Part::cleanup()
         partefx[nefx]->cleanup();
     for (int n = 0; n < NUM_PART_EFX + 1; ++n)
     {
-        memset(partfxinputl[n].get(), 0, synth->bufferbytes);
-        memset(partfxinputr[n].get(), 0, synth->bufferbytes);
+        memset(partfxinputl[n].get(), 0, (synth->buffersize + synth->controlsize) * sizeof(float));
+        memset(partfxinputr[n].get(), 0, (synth->buffersize + synth->controlsize) * sizeof(float));
 
     }
+    carried = 0;
     Penabled = enablepart;
 }
 
 
+// Touch every buffer this part owns, so the audio thread won't fault on them
+size_t Part::prefault()
+{
+    size_t bytes = prefaultPages(partoutl, synth->buffersize)
+                 + prefaultPages(partoutr, synth->buffersize);
+    for (int n = 0; n < NUM_PART_EFX + 1; ++n)
+    {
+        bytes += prefaultPages(partfxinputl[n], synth->buffersize + synth->controlsize);
+        bytes += prefaultPages(partfxinputr[n], synth->buffersize + synth->controlsize);
+    }
+    for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+        bytes += partefx[nefx]->prefault();
+    for (int n = 0; n < NUM_KIT_ITEMS; ++n)
+        if (kit[n].padpars)
+            bytes += kit[n].padpars->waveTable.prefault();
+    return bytes;
+}
+
+
 Part::~Part()
 {
     cleanup();
@@ -371,13 +413,54 @@ void Part::setKeyAT(int note, int type, int value)
 {
     if (note < Pminkey || note > Pmaxkey)
         return;
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (int i = keyHead[note]; i >= 0; i = partnote[i].keyNext)
     {
-        if (partnote[i].status != KEY_OFF && partnote[i].note == note)
-        {
-            partnote[i].keyATtype = type;
-            partnote[i].keyATvalue = value;
-        }
+        partnote[i].keyATtype = type;
+        partnote[i].keyATvalue = value;
+    }
+}
+
+
+/*
+ * MPE lower zone: the part channel is the manager, and the members are
+ * the channels above it. A part on channel 16 gets the upper zone, with
+ * the members below it. Manager controllers go to the whole part as ever.
+ */
+bool Part::mpeMember(uint chan, uint manager) const
+{
+    if (PmpeChannels == 0 || manager >= NUM_MIDI_CHANNELS || chan >= NUM_MIDI_CHANNELS)
+        return false;
+    if (manager == NUM_MIDI_CHANNELS - 1)
+        return chan < manager && chan + PmpeChannels >= manager;
+    return chan > manager && chan <= manager + PmpeChannels;
+}
+
+
+// only what the notes on the member channel read, see refreshNoteExpr()
+void Part::setMpeController(uint chan, uint type, int par)
+{
+    switch (type)
+    {
+        case MIDI::CC::pitchWheel:
+            mpe[chan].bend = par;
+            break;
+        case MIDI::CC::channelPressure:
+            mpe[chan].pressure = par;
+            break;
+        case MIDI::CC::filterCutoff: // MPE timbre, CC 74
+            mpe[chan].timbre = par;
+            break;
+    }
+}
+
+
+void Part::resetMpeChannels()
+{
+    for (int chan = 0; chan < NUM_MIDI_CHANNELS; ++chan)
+    {
+        mpe[chan].bend = 0;
+        mpe[chan].pressure = 0;
+        mpe[chan].timbre = 64;
     }
 }
 
@@ -413,15 +496,15 @@ void Part::startNewNotes(int pos, size_t item, size_t currItem, Note note, bool
 {
     if (kit[item].adpars && kit[item].Padenabled)
         partnote[pos].kitItem[currItem].adnote =
-            new ADnote(*kit[item].adpars, *ctl, note, portamento);
+            new ADnote(*kit[item].adpars, *ctl, *partnote[pos].expr, note, portamento);
 
     if (kit[item].subpars && kit[item].Psubenabled)
         partnote[pos].kitItem[currItem].subnote =
-            new SUBnote(*kit[item].subpars, *ctl, note, portamento);
+            new SUBnote(*kit[item].subpars, *ctl, *partnote[pos].expr, note, portamento);
 
     if (kit[item].padpars && kit[item].Ppadenabled)
         partnote[pos].kitItem[currItem].padnote =
-            new PADnote(*kit[item].padpars, *ctl, note, portamento);
+            new PADnote(*kit[item].padpars, *ctl, *partnote[pos].expr, note, portamento);
 
     // Each Kit-item can send to any Part(Insert) effect, or just directly to Part-output (encoded as Psendtoparteffect==127)
     // The part effects in turn can send to the next one (default) or to some effect downstream or to output.
@@ -520,7 +603,7 @@ float Part::computeKitItemCrossfade(size_t item, int midiNote)
 
 
 // Handle "Note ON" event : create new sounding note instances
-void Part::NoteOn(int note, int velocity, bool renote)
+void Part::NoteOn(int note, int velocity, bool renote, int mpeChannel)
 {
     if (note < Pminkey || note > Pmaxkey)
         return;
@@ -543,28 +626,20 @@ void Part::NoteOn(int note, int velocity, bool renote)
     }
     else
     {// Polyphony is off -- possibly re-activate a still held/sustained previous note
-        if (!renote)
-            monoNoteHistory.push_back(note);       //  add note to the stack of held notes.
-        monoNote[note].velocity = velocity;       // store this note's velocity.
+        if (!renote) // add note to the stack of held notes.
+            monoNoteHistory.push_back(HeldNote{uchar(note), velocity, mpeChannel});
         if (partnote[prevPos].status != KEY_PLAYING
             && partnote[prevPos].status != KEY_RELEASED_AND_SUSTAINED)
         {
             isMonoFirstNote = true; // No other keys are held or sustained.
         }
     }
-    //--Find-new-free-Note-position------
-    int pos = -1;
-    for (int i = 0; i < POLYPHONY; ++i)
-    {
-        if (partnote[i].status == KEY_OFF)
-        {
-            pos = i;
-            break;
-        }
-    }
+    //--Check-for-a-free-Note-position------
+    int pos = freeHead;
     if (pos == -1)
     {
-        synth->getRuntime().Log("Too many notes - notes > polyphony");
+        synth->getRuntime().rtLog.post(rtlog::tooManyNotes);
+        synth->voices.noteDropped();
         return; // unable to start note -- no state changed
     }
     if (Pkeymode > PART_MONO && !Pdrummode)
@@ -579,7 +654,7 @@ void Part::NoteOn(int note, int velocity, bool renote)
     }
     else if ((Pkeymode & MIDI_NOT_LEGATO) == PART_MONO)
     {// if the mode is 'mono' turn off all other notes
-        for (int i = 0; i < POLYPHONY; ++i)
+        for (int i = activeHead; i >= 0; i = partnote[i].next)
         {
             if (partnote[i].status == KEY_PLAYING)
                 ReleaseNotePos(i);
@@ -601,7 +676,7 @@ void Part::NoteOn(int note, int velocity, bool renote)
 
         // initialise note frequency
         float noteFreq;
-        if ((noteFreq = PnoteMap[note]) < 0.0f)
+        if ((noteFreq = microtonal->noteFreq(note, noteShift, Pdrummode)) < 0.0f)
             return; // the key is not mapped
 
         // Humanise
@@ -620,21 +695,35 @@ void Part::NoteOn(int note, int velocity, bool renote)
             portamento = ctl->initportamento(prevFreq, noteFreq, performLegato);
 
         if (portamento and performLegato)
-            // actually perform a Legato-Portamento,
+        {   // actually perform a Legato-Portamento,
             // thereby re-using the same note position without spawning a new note
             // Note: NoteOff for the old midiNote will be ignored, since we update partnote[pos].note
             pos = prevPos;
+            setNoteKey(pos, note);
+        }
+        else if ((pos = claimNotePos(note)) == -1)
+        {   // the last one was taken by a note recalled on the way here
+            synth->getRuntime().rtLog.post(rtlog::tooManyNotes);
+            synth->voices.noteDropped();
+            return;
+        }
 
         if (portamento)
             ctl->portamento.noteusing = pos;
 
         // allocate or update the note position
         partnote[pos].status = KEY_PLAYING;
-        partnote[pos].note = note;
         partnote[pos].keyATtype = PART::aftertouchType::off;
         partnote[pos].keyATvalue = 0;
+        partnote[pos].mpeChannel = mpeChannel;
         partnote[pos].itemsplaying = 0;
 
+        // the notes only see the controllers as they were at the start of the block,
+        // and legato clones keep the values of the notes they came from
+        refreshNoteExpr(performLegato ? prevPos : pos);
+        if (synth->renderPool.size() > 0)
+            partnote[pos].rng.init(synth->randomINT());
+
         if (performLegato)
         {
             if (Pkitmode == 0)
@@ -716,6 +805,9 @@ void Part::NoteOn(int note, int velocity, bool renote)
                 }
             }
         }
+        if (performLegato && pos != prevPos && partnote[pos].itemsplaying > 0)
+            partnote[pos].expr.swap(partnote[prevPos].expr); // the new notes own it now
+
         // recall note and pos for portamento and legato
         prevFreq = noteFreq;
         prevNote = note;
@@ -725,19 +817,24 @@ void Part::NoteOn(int note, int velocity, bool renote)
 
 
 // Note Off Messages
-void Part::NoteOff(int note) //release the key
+void Part::NoteOff(int note, int mpeChannel) //release the key
 {
     // releasing the last key, while previous keys are still sustained...
-    bool reactivate = Pkeymode > PART_NORMAL  && !Pdrummode
-                   && (monoNoteHistory.back() == note);
+    bool reactivate = Pkeymode > PART_NORMAL  && !Pdrummode && !monoNoteHistory.empty()
+                   && monoNoteHistory.back().note == note
+                   && monoNoteHistory.back().mpeChannel == mpeChannel;
 
     // This note is released, thus remove it from the list of held Mono-Note keys.
-    monoNoteHistory.remove(note);
+    monoNoteHistory.remove_if([note, mpeChannel](HeldNote const& held)
+                              { return held.note == note && held.mpeChannel == mpeChannel; });
     reactivate = reactivate && !monoNoteHistory.empty();
 
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (int i = keyHead[note], next; i >= 0; i = next)
     {   //first note in, is first out if there are same note multiple times
-        if (partnote[i].status == KEY_PLAYING && partnote[i].note == note)
+        next = partnote[i].keyNext; // a recalled note may take this one to another key
+        if (partnote[i].mpeChannel != mpeChannel)
+            continue; // the same key on another member channel
+        if (partnote[i].status == KEY_PLAYING)
         {
             if (ctl->sustain.sustain)
                 partnote[i].status = KEY_RELEASED_AND_SUSTAINED;
@@ -816,6 +913,7 @@ void Part::SetController(unsigned int type, int par)
 
         case MIDI::CC::resetAllControllers:
             ctl->resetall();
+            resetMpeChannels();
             ReleaseSustainedKeys();
             setVolume(Pvolume);
             setPan(Ppanning);
@@ -873,11 +971,11 @@ void Part::ReleaseSustainedKeys()
 {
     //in non-Polyphony mode, reactivate previous active keys when last one is released
     if ((Pkeymode < PART_MONO || Pkeymode > PART_LEGATO) && (!monoNoteHistory.empty()))
-        if (monoNoteHistory.back() != prevNote)
+        if (monoNoteHistory.back().note != prevNote)
             // Sustain controller manipulation would respawn same note repeatedly without this check.
             monoNoteHistoryRecall(); // To play most recent still held note.
 
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (int i = activeHead; i >= 0; i = partnote[i].next)
         if (partnote[i].status == KEY_RELEASED_AND_SUSTAINED)
             ReleaseNotePos(i);
 }
@@ -886,10 +984,9 @@ void Part::ReleaseSustainedKeys()
 // Release all keys
 void Part::ReleaseAllKeys()
 {
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (int i = activeHead; i >= 0; i = partnote[i].next)
     {
-        if (partnote[i].status != KEY_RELEASED
-            && partnote[i].status != KEY_OFF) //thanks to Frank Neumann
+        if (partnote[i].status != KEY_RELEASED) //thanks to Frank Neumann
             ReleaseNotePos(i);
     }
     // Clear legato notes, if any.
@@ -901,8 +998,8 @@ void Part::ReleaseAllKeys()
 // (Made for Mono/Legato).
 void Part::monoNoteHistoryRecall()
 {
-    unsigned char mmrtempnote = monoNoteHistory.back(); // Last list element.
-    NoteOn(mmrtempnote, monoNote[mmrtempnote].velocity, true);
+    HeldNote const& held = monoNoteHistory.back(); // Last list element.
+    NoteOn(held.note, held.velocity, true, held.mpeChannel);
 }
 
 
@@ -928,9 +1025,27 @@ void Part::ReleaseNotePos(int pos)
 // Kill note at position
 void Part::KillNotePos(int pos)
 {
+    if (partnote[pos].status != KEY_OFF)
+    {   // back on the free list
+        unlinkNoteKey(pos);
+        int prev = partnote[pos].prev;
+        int next = partnote[pos].next;
+        if (prev >= 0)
+            partnote[prev].next = next;
+        else
+            activeHead = next;
+        if (next >= 0)
+            partnote[next].prev = prev;
+        else
+            activeTail = prev;
+        partnote[pos].prev = -1;
+        partnote[pos].next = freeHead;
+        freeHead = pos;
+    }
     partnote[pos].status = KEY_OFF;
     partnote[pos].note = -1;
     partnote[pos].time = 0;
+    partnote[pos].stolen = false;
     partnote[pos].itemsplaying = 0;
 
     for (int j = 0; j < NUM_KIT_ITEMS; ++j)
@@ -959,33 +1074,126 @@ void Part::KillNotePos(int pos)
 }
 
 
+// Take a free position for a new note on key, returns -1 if there are none
+int Part::claimNotePos(int note)
+{
+    int pos = freeHead;
+    if (pos == -1)
+        return -1;
+    freeHead = partnote[pos].next;
+    partnote[pos].prev = activeTail;
+    partnote[pos].next = -1;
+    if (activeTail >= 0)
+        partnote[activeTail].next = pos;
+    else
+        activeHead = pos;
+    activeTail = pos;
+    partnote[pos].keyPrev = -1;
+    partnote[pos].keyNext = -1;
+    partnote[pos].note = -1;
+    setNoteKey(pos, note);
+    return pos;
+}
+
+
+// Move the note at position to the end of the list for key
+void Part::setNoteKey(int pos, int note)
+{
+    unlinkNoteKey(pos);
+    partnote[pos].note = note;
+    partnote[pos].keyPrev = keyTail[note];
+    partnote[pos].keyNext = -1;
+    if (keyTail[note] >= 0)
+        partnote[keyTail[note]].keyNext = pos;
+    else
+        keyHead[note] = pos;
+    keyTail[note] = pos;
+}
+
+
+void Part::unlinkNoteKey(int pos)
+{
+    int note = partnote[pos].note;
+    if (note < 0)
+        return;
+    int prev = partnote[pos].keyPrev;
+    int next = partnote[pos].keyNext;
+    if (prev >= 0)
+        partnote[prev].keyNext = next;
+    else
+        keyHead[note] = next;
+    if (next >= 0)
+        partnote[next].keyPrev = prev;
+    else
+        keyTail[note] = prev;
+    partnote[pos].keyPrev = -1;
+    partnote[pos].keyNext = -1;
+    partnote[pos].note = -1;
+}
+
+
+// Fade out every kit item of the note at position, for the voice manager
+void Part::stealNote(int pos)
+{
+    for (int j = 0; j < NUM_KIT_ITEMS; ++j)
+    {
+        if (partnote[pos].kitItem[j].adnote)
+            partnote[pos].kitItem[j].adnote->stealFadeOut();
+
+        if (partnote[pos].kitItem[j].subnote)
+            partnote[pos].kitItem[j].subnote->stealFadeOut();
+
+        if (partnote[pos].kitItem[j].padnote)
+            partnote[pos].kitItem[j].padnote->stealFadeOut();
+    }
+    partnote[pos].status = KEY_RELEASED;
+    partnote[pos].stolen = true;
+}
+
+
+// Adds the sounding notes that could be stolen, counts those already fading
+int Part::listVoices(VoiceCandidate* to, uint& fading)
+{
+    float partLevel = std::max(pannedVolLeft(), pannedVolRight()) * ctl->expression.relvolume;
+    int count = 0;
+    for (int i = activeHead; i >= 0; i = partnote[i].next)
+    {
+        if (partnote[i].stolen)
+        {
+            ++fading;
+            continue;
+        }
+        VoiceCandidate& voice = to[count++];
+        voice.part = this;
+        voice.pos = i;
+        voice.held = (partnote[i].status != KEY_RELEASED);
+        voice.level = partnote[i].level * partLevel;
+        voice.age = partnote[i].time;
+        voice.costNs = voiceCostNs;
+    }
+    return count;
+}
+
+
 void Part::enforcekeylimit()
 {
     // release old keys if the number of notes>keylimit
     int notecount = 0;
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (int i = activeHead; i >= 0; i = partnote[i].next)
     {
         if (partnote[i].status == KEY_PLAYING
             || partnote[i].status == KEY_RELEASED_AND_SUSTAINED)
             notecount++;
     }
-    while (notecount > Pkeylimit)
-    {   // find out the oldest note
-        int oldestnotepos = 0;
-        int maxtime = 0;
-
-        for (int i = 0; i < POLYPHONY; ++i)
+    // the active list is oldest first
+    for (int i = activeHead; i >= 0 && notecount > Pkeylimit; i = partnote[i].next)
+    {
+        if (partnote[i].status == KEY_PLAYING
+            || partnote[i].status == KEY_RELEASED_AND_SUSTAINED)
         {
-            if ((partnote[i].status == KEY_PLAYING
-                || partnote[i].status == KEY_RELEASED_AND_SUSTAINED)
-                && partnote[i].time > maxtime)
-            {
-                maxtime = partnote[i].time;
-                oldestnotepos = i;
-            }
+            ReleaseNotePos(i);
+            --notecount;
         }
-        ReleaseNotePos(oldestnotepos);
-        --notecount;
     }
 }
 
@@ -996,55 +1204,200 @@ void Part::ComputePartSmps()
     assert(tmpoutl.get() == synth->getRuntime().genMixl.get());
     assert(tmpoutr.get() == synth->getRuntime().genMixr.get());
 
+    bool sounding = killallnotes || ctl->portamento.used || activeHead >= 0 || carried > 0;
+    for (int nefx = 0; nefx < NUM_PART_EFX && !sounding; ++nefx)
+        sounding = !(Pefxbypass[nefx] || partefx[nefx]->isAsleep());
+    if (!sounding)
+    {   // nothing playing and no effect tails, so there is nothing to compute
+        memset(partoutl.get(), 0, synth->sent_bufferbytes);
+        memset(partoutr.get(), 0, synth->sent_bufferbytes);
+        idle = true;
+        return;
+    }
+    idle = false;
+
+    int total = synth->sent_buffersize;
+    int clear = synth->buffersize + synth->controlsize - carried;
     for (int nefx = 0; nefx < NUM_PART_EFX + 1; ++nefx)
     {
-        memset(partfxinputl[nefx].get(), 0, synth->sent_bufferbytes);
-        memset(partfxinputr[nefx].get(), 0, synth->sent_bufferbytes);
+        memset(partfxinputl[nefx].get() + carried, 0, clear * sizeof(float));
+        memset(partfxinputr[nefx].get() + carried, 0, clear * sizeof(float));
     }
 
-    for (int k = 0; k < POLYPHONY; ++k)
+    /*
+     * Notes are rendered in whole control blocks so their envelopes, LFOs
+     * and filters advance in the same steps whatever the buffer size. The
+     * part of the last block that runs past this period was kept, and now
+     * starts it; the blocks carry on from there. The part effects still
+     * run once over the whole period.
+     */
+    int notes = 0;
+    for (int k = activeHead; k >= 0; k = partnote[k].next)
     {
-        int oldFilterState;
-        int oldBendState;
-        int oldModulationState;
-        if (partnote[k].status == KEY_OFF)
-            continue;
-        int noteplay = 0; // 0 if there is nothing activated
         partnote[k].time++;
-        int keyATtype = partnote[k].keyATtype;
-        int keyATvalue = partnote[k].keyATvalue;
-        if (keyATtype & PART::aftertouchType::filterCutoff)
+        partnote[k].level = 0.0f;
+        ++notes;
+    }
+    uint64_t start = VoiceManager::nowNs();
+    jobNs = 0;
+    spreadNotes = notes > 1
+               && voiceCostNs * notes * synth->controlsize / total >= RenderPool::MIN_SPREAD_NS;
+    int offset = carried;
+    int waiting = carried - total; // more was carried over than this period takes
+    synth->setSentBuffersize(synth->controlsize);
+    for (; offset < total; offset += synth->controlsize)
+    {
+        synth->controlOffset = offset;
+        computeNoteBlock(offset);
+        ctl->updateportamento();
+    }
+    synth->controlOffset = 0;
+    synth->setSentBuffersize(total);
+    // with no notes the new blocks were silent, so only what waited is kept
+    if (notes > 0 && offset > total)
+        carried = offset - total;
+    else
+        carried = (waiting > 0) ? waiting : 0;
+    if (notes > 0)
+    {   // the jobs add up to what it would have taken on one thread
+        uint64_t spent = (synth->renderPool.size() > 0) ? jobNs : VoiceManager::nowNs() - start;
+        float cost = float(spent) / notes;
+        voiceCostNs += (cost - voiceCostNs) * 0.125f;
+    }
+
+    // Apply part's effects and mix them
+    for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+    {
+        if (!Pefxbypass[nefx])
         {
-            oldFilterState = ctl->filtercutoff.data;
-            float adjust = oldFilterState / 127.0f;
-            if (keyATtype & PART::aftertouchType::filterCutoffDown)
-                ctl->setfiltercutoff(oldFilterState - (keyATvalue * adjust));
-            else
-                ctl->setfiltercutoff(oldFilterState + (keyATvalue * adjust));
+            partefx[nefx]->out(partfxinputl[nefx].get(), partfxinputr[nefx].get());
+            if (Pefxroute[nefx] == 2)
+            {
+                for (int i = 0; i < synth->sent_buffersize; ++i)
+                {
+                    partfxinputl[nefx + 1][i] += partefx[nefx]->efxoutl[i];
+                    partfxinputr[nefx + 1][i] += partefx[nefx]->efxoutr[i];
+                }
+            }
         }
-        if (keyATtype & PART::aftertouchType::filterQ)
+        int routeto = (Pefxroute[nefx] == 0) ? nefx + 1 : NUM_PART_EFX;
+        for (int i = 0; i < synth->sent_buffersize; ++i)
         {
-            oldFilterQstate = ctl->filterq.data;
-            float adjust = oldFilterQstate / 127.0f;
-            if (keyATtype & PART::aftertouchType::filterQdown)
-                ctl->setfilterq(oldFilterQstate - (keyATvalue * adjust));
-            else
-                ctl->setfilterq(oldFilterQstate + (keyATvalue * adjust));
+            partfxinputl[routeto][i] += partfxinputl[nefx][i];
+            partfxinputr[routeto][i] += partfxinputr[nefx][i];
         }
-        if (keyATtype & PART::aftertouchType::pitchBend)
+    }
+    memcpy(partoutl.get(), partfxinputl[NUM_PART_EFX].get(), synth->sent_bufferbytes);
+    memcpy(partoutr.get(), partfxinputr[NUM_PART_EFX].get(), synth->sent_bufferbytes);
+
+    // the effects only took this period, so the overrun is still untouched
+    for (int nefx = 0; nefx < NUM_PART_EFX + 1 && carried > 0; ++nefx)
+    {
+        memmove(partfxinputl[nefx].get(), partfxinputl[nefx].get() + total, carried * sizeof(float));
+        memmove(partfxinputr[nefx].get(), partfxinputr[nefx].get() + total, carried * sizeof(float));
+    }
+
+    // Kill All Notes if killallnotes true
+    if (killallnotes)
+    {
+        carried = 0;
+        for (int i = 0; i < synth->sent_buffersize; ++i)
+        {
+            float tmp = (synth->sent_buffersize - i) / synth->sent_buffersize_f;
+            partoutl[i] *= tmp;
+            partoutr[i] *= tmp;
+        }
+        while (activeHead >= 0)
+            KillNotePos(activeHead);
+        killallnotes = 0;
+        for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+            partefx[nefx]->cleanup();
+    }
+}
+
+
+namespace { // pressure on a single note, as the part takes channel aftertouch
+
+    inline void applyPressure(int type, int value, int& bend, int& cutoff, int& q, int& mod)
+    {
+        if (value <= 0)
+            return;
+        if (type & PART::aftertouchType::filterCutoff)
         {
-            keyATvalue *= 64.0f;
-            oldBendState = ctl->pitchwheel.data;
-            if (keyATtype & PART::aftertouchType::pitchBendDown)
-                ctl->setpitchwheel(-keyATvalue);
+            float adjust = cutoff / 127.0f;
+            if (type & PART::aftertouchType::filterCutoffDown)
+                cutoff -= value * adjust;
             else
-                ctl->setpitchwheel(keyATvalue);
+                cutoff += value * adjust;
         }
-        if (keyATtype & PART::aftertouchType::modulation)
+        if (type & PART::aftertouchType::filterQ)
         {
-            oldModulationState = ctl->modwheel.data;
-            ctl->setmodwheel(keyATvalue);
+            float adjust = q / 127.0f;
+            if (type & PART::aftertouchType::filterQdown)
+                q -= value * adjust;
+            else
+                q += value * adjust;
         }
+        if (type & PART::aftertouchType::pitchBend)
+            bend = (type & PART::aftertouchType::pitchBendDown) ? -value * 64 : value * 64;
+        if (type & PART::aftertouchType::modulation)
+            mod = value;
+    }
+}
+
+
+// The part controllers as the notes at pos should see them for the next
+// block, with their own key aftertouch and MPE member channel applied.
+void Part::refreshNoteExpr(int pos)
+{
+    NoteExpression& expr = *partnote[pos].expr;
+    int keyATtype = partnote[pos].keyATtype;
+    int chan = partnote[pos].mpeChannel;
+    if (keyATtype == PART::aftertouchType::off && chan < 0)
+    {
+        expr.relfreq = ctl->pitchwheel.relfreq;
+        expr.cutoff = ctl->filtercutoff.relfreq;
+        expr.relq = ctl->filterq.relq;
+        expr.relmod = ctl->modwheel.relmod;
+        return;
+    }
+    int bend = ctl->pitchwheel.data;
+    int cutoff = ctl->filtercutoff.data;
+    int q = ctl->filterq.data;
+    int mod = ctl->modwheel.data;
+    float memberBend = 1.0f;
+    if (chan >= 0)
+    {   // volume isn't per note, so that part of the choice is left out
+        applyPressure(PchannelATchoice, mpe[chan].pressure, bend, cutoff, q, mod);
+        cutoff += mpe[chan].timbre - 64;
+        memberBend = power<2>(mpe[chan].bend * PmpeBendRange / (8192.0f * 12.0f));
+    }
+    applyPressure(keyATtype, partnote[pos].keyATvalue, bend, cutoff, q, mod);
+    expr.relfreq = ctl->pitchwheelFreq(bend) * memberBend;
+    expr.cutoff = ctl->filtercutoffFreq(cutoff);
+    expr.relq = ctl->filterqRel(q);
+    expr.relmod = ctl->modwheelRel(mod);
+}
+
+
+// one control block of every playing note, mixed in at offset
+void Part::computeNoteBlock(int offset)
+{
+    if (synth->renderPool.size() > 0)
+    {
+        computeNoteJobs(offset);
+        return;
+    }
+    auto outputPeak = [&](float held)
+    {
+        held = meter::blockPeak(tmpoutl.get(), synth->sent_buffersize, held);
+        return meter::blockPeak(tmpoutr.get(), synth->sent_buffersize, held);
+    };
+    for (int k = activeHead, next; k >= 0; k = next)
+    {
+        next = partnote[k].next;
+        int noteplay = 0; // 0 if there is nothing activated
+        refreshNoteExpr(k);
 
         // get the sampledata of the note and kill it if it's finished
         for (size_t item = 0; item < partnote[k].itemsplaying; ++item)
@@ -1058,10 +1411,11 @@ void Part::ComputePartSmps()
             {
                 noteplay++;
                 adnote->noteout(tmpoutl.get(), tmpoutr.get());
+                partnote[k].level = outputPeak(partnote[k].level);
                 for (int i = 0; i < synth->sent_buffersize; ++i)
                 {   // add the ADnote to part(mix)
-                    partfxinputl[sendcurrenttofx][i] += tmpoutl[i];
-                    partfxinputr[sendcurrenttofx][i] += tmpoutr[i];
+                    partfxinputl[sendcurrenttofx][offset + i] += tmpoutl[i];
+                    partfxinputr[sendcurrenttofx][offset + i] += tmpoutr[i];
                 }
                 if (adnote->finished())
                 {
@@ -1074,10 +1428,11 @@ void Part::ComputePartSmps()
             {
                 noteplay++;
                 subnote->noteout(tmpoutl.get(), tmpoutr.get());
+                partnote[k].level = outputPeak(partnote[k].level);
                 for (int i = 0; i < synth->sent_buffersize; ++i)
                 {   // add the SUBnote to part(mix)
-                    partfxinputl[sendcurrenttofx][i] += tmpoutl[i];
-                    partfxinputr[sendcurrenttofx][i] += tmpoutr[i];
+                    partfxinputl[sendcurrenttofx][offset + i] += tmpoutl[i];
+                    partfxinputr[sendcurrenttofx][offset + i] += tmpoutr[i];
                 }
                 if (subnote->finished())
                 {
@@ -1090,10 +1445,11 @@ void Part::ComputePartSmps()
             {
                 noteplay++;
                 padnote->noteout(tmpoutl.get(), tmpoutr.get());
+                partnote[k].level = outputPeak(partnote[k].level);
                 for (int i = 0 ; i < synth->sent_buffersize; ++i)
                 {   // add the PADnote to part(mix)
-                    partfxinputl[sendcurrenttofx][i] += tmpoutl[i];
-                    partfxinputr[sendcurrenttofx][i] += tmpoutr[i];
+                    partfxinputl[sendcurrenttofx][offset + i] += tmpoutl[i];
+                    partfxinputr[sendcurrenttofx][offset + i] += tmpoutr[i];
                 }
                 if (padnote->finished())
                 {
@@ -1105,58 +1461,147 @@ void Part::ComputePartSmps()
         // Kill note if there is no synth on that note
         if (noteplay == 0)
             KillNotePos(k);
-
-        if (keyATtype & PART::aftertouchType::filterCutoff)
-            ctl->setfiltercutoff(oldFilterState);
-        if (keyATtype & PART::aftertouchType::filterQ)
-            ctl->setfilterq(oldFilterQstate);
-        if (keyATtype & PART::aftertouchType::pitchBend)
-            ctl->setpitchwheel(oldBendState);
-        if (keyATtype & PART::aftertouchType::modulation)
-            ctl->setmodwheel(oldModulationState);
     }
+}
 
-    // Apply part's effects and mix them
-    for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+
+/*
+ * With the render pool each sounding note position is a job of its own,
+ * rendering into buffers private to the job, with its own controller and
+ * random numbers. The jobs are then mixed in the order the notes started,
+ * so the result is the same whichever thread got which note, and whether
+ * the block was shared out at all. Anything touching the shared parameters is done here
+ * first, on this thread.
+ */
+void Part::computeNoteJobs(int offset)
+{
+    bool spread = spreadNotes;
+    uint count = 0;
+    for (int k = activeHead; k >= 0; k = partnote[k].next)
     {
-        if (!Pefxbypass[nefx])
+        refreshNoteExpr(k);
+        for (size_t item = 0; item < partnote[k].itemsplaying; ++item)
         {
-            partefx[nefx]->out(partfxinputl[nefx].get(), partfxinputr[nefx].get());
-            if (Pefxroute[nefx] == 2)
+            PartNotes::KitItemNotes& kitItem = partnote[k].kitItem[item];
+            if (kitItem.adnote)
+                kitItem.adnote->prepareOut();
+            if (kitItem.subnote)
+                kitItem.subnote->prepareOut();
+            if (kitItem.padnote)
             {
-                for (int i = 0; i < synth->sent_buffersize; ++i)
-                {
-                    partfxinputl[nefx + 1][i] += partefx[nefx]->efxoutl[i];
-                    partfxinputr[nefx + 1][i] += partefx[nefx]->efxoutr[i];
-                }
+                kitItem.padnote->prepareOut();
+                if (kitItem.padnote->crossFading())
+                    spread = false;
             }
         }
-        int routeto = (Pefxroute[nefx] == 0) ? nefx + 1 : NUM_PART_EFX;
-        for (int i = 0; i < synth->sent_buffersize; ++i)
+        noteJobs[count++].pos = k;
+    }
+    RenderPool& pool = synth->renderPool;
+    pool.run(noteJob, this, count, spread);
+
+    for (uint j = 0; j < count; ++j)
+    {
+        NoteJob& job = noteJobs[j];
+        for (int dest = 0; dest < NUM_PART_EFX + 1; ++dest)
         {
-            partfxinputl[routeto][i] += partfxinputl[nefx][i];
-            partfxinputr[routeto][i] += partfxinputr[nefx][i];
+            if (!(job.sends & (1u << dest)))
+                continue;
+            float *sendl = pool.jobBuffer(j, 2 + 2 * dest);
+            float *sendr = pool.jobBuffer(j, 3 + 2 * dest);
+            for (int i = 0; i < synth->sent_buffersize; ++i)
+            {
+                partfxinputl[dest][offset + i] += sendl[i];
+                partfxinputr[dest][offset + i] += sendr[i];
+            }
         }
+        jobNs += job.ns;
+        if (job.noteplay == 0)
+            KillNotePos(job.pos);
     }
-    memcpy(partoutl.get(), partfxinputl[NUM_PART_EFX].get(), synth->sent_bufferbytes);
-    memcpy(partoutr.get(), partfxinputr[NUM_PART_EFX].get(), synth->sent_bufferbytes);
+}
 
-    // Kill All Notes if killallnotes true
-    if (killallnotes)
+
+void Part::noteJob(void *part, uint index)
+{
+    static_cast<Part*>(part)->renderNoteJob(index);
+}
+
+
+// may run on any thread taking part in the pool
+void Part::renderNoteJob(uint index)
+{
+    uint64_t start = VoiceManager::nowNs();
+    RenderPool& pool = synth->renderPool;
+    NoteJob& job = noteJobs[index];
+    PartNotes& note = partnote[job.pos];
+    render::current->rng = &note.rng;
+
+    int frames = synth->sent_buffersize;
+    float *outl = pool.jobBuffer(index, 0);
+    float *outr = pool.jobBuffer(index, 1);
+    auto mixIn = [&](int dest)
     {
-        for (int i = 0; i < synth->sent_buffersize; ++i)
+        note.level = meter::blockPeak(outl, frames, note.level);
+        note.level = meter::blockPeak(outr, frames, note.level);
+        float *sendl = pool.jobBuffer(index, 2 + 2 * dest);
+        float *sendr = pool.jobBuffer(index, 3 + 2 * dest);
+        if (job.sends & (1u << dest))
         {
-            float tmp = (synth->sent_buffersize - i) / synth->sent_buffersize_f;
-            partoutl[i] *= tmp;
-            partoutr[i] *= tmp;
+            for (int i = 0; i < frames; ++i)
+            {
+                sendl[i] += outl[i];
+                sendr[i] += outr[i];
+            }
+        }
+        else
+        {
+            memcpy(sendl, outl, frames * sizeof(float));
+            memcpy(sendr, outr, frames * sizeof(float));
+            job.sends |= 1u << dest;
+        }
+    };
+
+    job.sends = 0;
+    job.noteplay = 0;
+    for (size_t item = 0; item < note.itemsplaying; ++item)
+    {
+        PartNotes::KitItemNotes& kitItem = note.kitItem[item];
+        if (kitItem.adnote)
+        {
+            job.noteplay++;
+            kitItem.adnote->noteout(outl, outr);
+            mixIn(kitItem.sendtoparteffect);
+            if (kitItem.adnote->finished())
+            {
+                delete kitItem.adnote;
+                kitItem.adnote = NULL;
+            }
+        }
+        if (kitItem.subnote)
+        {
+            job.noteplay++;
+            kitItem.subnote->noteout(outl, outr);
+            mixIn(kitItem.sendtoparteffect);
+            if (kitItem.subnote->finished())
+            {
+                delete kitItem.subnote;
+                kitItem.subnote = NULL;
+            }
+        }
+        if (kitItem.padnote)
+        {
+            job.noteplay++;
+            kitItem.padnote->noteout(outl, outr);
+            mixIn(kitItem.sendtoparteffect);
+            if (kitItem.padnote->finished())
+            {
+                delete kitItem.padnote;
+                kitItem.padnote = NULL;
+            }
         }
-        for (int k = 0; k < POLYPHONY; ++k)
-            KillNotePos(k);
-        killallnotes = 0;
-        for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
-            partefx[nefx]->cleanup();
     }
-    ctl->updateportamento();
+    render::current->rng = nullptr;
+    job.ns = VoiceManager::nowNs() - start;
 }
 
 
@@ -1242,8 +1687,8 @@ void Part::setkititemstatus(int kititem, int Penabled_)
     }
 
     if (resetallnotes)
-        for (int k = 0; k < POLYPHONY; ++k)
-            KillNotePos(k);
+        while (activeHead >= 0)
+            KillNotePos(activeHead);
 }
 
 
@@ -1338,6 +1783,8 @@ void Part::add2XML(XMLwrapper& xml, bool subset)
         xml.addpar("max_key", Pmaxkey);
         xml.addpar("key_shift", Pkeyshift);
         xml.addpar("rcv_chn", Prcvchn);
+        xml.addpar("mpe_channels", PmpeChannels);
+        xml.addpar("mpe_bend_range", PmpeBendRange);
 
         xml.addpar("velocity_sensing", Pvelsns);
         xml.addpar("velocity_offset", Pveloffs);
@@ -1586,6 +2033,8 @@ void Part::getfromXML(XMLwrapper& xml)
     Pkeyshift = xml.getpar("key_shift", Pkeyshift, MIN_KEY_SHIFT + 64, MAX_KEY_SHIFT + 64);
 
     Prcvchn = xml.getpar127("rcv_chn", Prcvchn);
+    PmpeChannels = xml.getpar("mpe_channels", PmpeChannels, 0, NUM_MIDI_CHANNELS - 1);
+    PmpeBendRange = xml.getpar("mpe_bend_range", PmpeBendRange, 0, 96);
 
     Pvelsns = xml.getpar127("velocity_sensing", Pvelsns);
     Pveloffs = xml.getpar127("velocity_offset", Pveloffs);
@@ -1742,6 +2191,16 @@ float Part::getLimits(CommandBlock *getData)
             def = 0;
             max = 0;
             break;
+
+        case PART::control::mpeChannels:
+            def = 0;
+            max = NUM_MIDI_CHANNELS - 1;
+            break;
+
+        case PART::control::mpeBendRange:
+            def = 48;
+            max = 96;
+            break;
         case PART::control::kitEffectNum:
             def = 1; // may be local to GUI
             max = 3;
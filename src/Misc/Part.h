@@ -31,6 +31,7 @@
 #include "DSP/FFTwrapper.h"
 #include "Params/ParamCheck.h"
 #include "Misc/Alloc.h"
+#include "Misc/RandomGen.h"
 
 #include <memory>
 #include <string>
@@ -45,11 +46,13 @@ class ADnote;
 class SUBnote;
 class PADnote;
 class Controller;
+struct NoteExpression;
 class XMLwrapper;
 class Microtonal;
 class EffectMgr;
 
 class SynthEngine;
+struct VoiceCandidate;
 
 class Part
 {
@@ -72,14 +75,17 @@ class Part
         void setNoteMap(int keyshift);
         void defaultsinstrument();
         void cleanup();
+        size_t prefault();
 
         // Midi commands implemented
         void setChannelAT(int type, int value);
         void setKeyAT(int note, int type, int value);
-        void NoteOn(int note, int velocity, bool renote = false);
-        void NoteOff(int note);
+        void NoteOn(int note, int velocity, bool renote = false, int mpeChannel = -1);
+        void NoteOff(int note, int mpeChannel = -1);
         void AllNotesOff() { killallnotes = true; }; // panic, prepare all notes to be turned off
         void SetController(unsigned int type, int par);
+        bool mpeMember(uint chan, uint manager) const;
+        void setMpeController(uint chan, uint type, int par);
         void ReleaseSustainedKeys();
         void ReleaseAllKeys();
         void ComputePartSmps();
@@ -121,7 +127,7 @@ class Part
         void checkPanning(float step, uchar panLaw);
 
         bool   PyoshiType;
-        float  PnoteMap[MAX_OCTAVE_SIZE];
+        int    noteShift;      // part and master keyshift, see setNoteMap()
         float  Pvolume;
         float  TransVolume;
         float  Ppanning;
@@ -139,6 +145,8 @@ class Part
         uchar  Pkeymode;       // 0 = poly, 1 = mono, > 1 = legato;
         uint   PchannelATchoice;
         uint   PkeyATchoice;
+        uchar  PmpeChannels;   // MPE member channels after Prcvchn, or before it when that is 15; 0 = off
+        uchar  PmpeBendRange;  // semitones, for the member channels
         uchar  Pkeylimit;      // how many keys can play simultaneously,
                                // time 0 = off, the older will be released
         float  Pfrand;         // Part random frequency content
@@ -162,6 +170,7 @@ class Part
 
         Samples partfxinputl[NUM_PART_EFX + 1]; // Left and right signal that pass-through part effects
         Samples partfxinputr[NUM_PART_EFX + 1]; // [NUM_PART_EFX] is for "no effect" buffer
+                                                // with room for a control block past the period
 
         uchar Pefxroute[NUM_PART_EFX];         // how the effect's output is
                                                // routed (to next effect/to out)
@@ -173,6 +182,11 @@ class Part
         float pangainL;
         float pangainR;
         bool  busy;
+        bool  isIdle() const { return idle; } // no notes and every part effect asleep
+
+        // for the engine wide voice manager
+        int  listVoices(VoiceCandidate* to, uint& fading);
+        void stealNote(int pos);
 
         int getLastNote()  const { return this->prevNote; }
         SynthEngine* getSynthEngine() const {return synth;}
@@ -181,7 +195,16 @@ class Part
         void setPan(float value);
         void KillNotePos(int pos);
         void ReleaseNotePos(int pos);
+        int  claimNotePos(int note);
+        void setNoteKey(int pos, int note);
+        void unlinkNoteKey(int pos);
         void monoNoteHistoryRecall();
+        void computeNoteBlock(int offset);
+        void computeNoteJobs(int offset);
+        void refreshNoteExpr(int pos);
+        void resetMpeChannels();
+        static void noteJob(void *part, uint index);
+        void renderNoteJob(uint index);
 
         void startNewNotes        (int pos, size_t item, size_t currItem, Note, bool portamento);
         void startLegato          (int pos, size_t item, size_t currItem, Note);
@@ -199,9 +222,16 @@ class Part
             NoteStatus status;
             int note;          // if there is no note playing, "note" = -1
             int time;
+            bool stolen;       // fading out for the voice manager
+            float level;       // peak output in the last period
             int keyATtype;
             int keyATvalue;
             size_t itemsplaying;
+            int prev, next;    // in the active list, or next in the free list
+            int keyPrev, keyNext; // among the active ones on the same key
+            int mpeChannel;    // member channel it was played on, -1 if not MPE
+            std::unique_ptr<NoteExpression> expr; // what the notes here read, see refreshNoteExpr()
+            RandomGen rng;     // for the notes here, when rendered as jobs
 
             struct KitItemNotes {
                 ADnote* adnote;
@@ -214,12 +244,37 @@ class Part
 
         PartNotes partnote[POLYPHONY];
 
+        /*
+         * The positions in use are kept in order of starting, and for each
+         * key those playing it, again oldest first, so MIDI events only
+         * look at the notes concerned. -1 ends each list.
+         */
+        int activeHead;
+        int activeTail;
+        int freeHead;
+        int keyHead[128];      // one per MIDI key
+        int keyTail[128];
+
+        // one sounding note position, rendered into buffers of its own
+        struct NoteJob {
+            int pos;
+            uint sends;        // bit per partfxinput it went to
+            int noteplay;
+            uint64_t ns;
+        };
+        NoteJob noteJobs[POLYPHONY];
+        bool spreadNotes;      // worth handing jobs to other threads this period
+        uint64_t jobNs;        // render time of all jobs this period
+
         int   prevNote;        // previous MIDI note
         int   prevPos;         // previous note pos
         float prevFreq;        // frequency of previous note (for portamento)
         bool  prevLegatoMode;  // previous note hat legato mode activated
 
         bool  killallnotes;    // "panic" switch
+        bool  idle;            // the last period was skipped, partout is silent
+        int   carried;         // note frames rendered past the last period, now at the front of partfxinput
+        float voiceCostNs;     // smoothed render time of one note per period
 
         int   oldFilterState;  // these for channel aftertouch
         int   oldFilterQstate;
@@ -228,15 +283,23 @@ class Part
         float oldVolumeAdjust;
         int   oldModulationState;
 
+        struct MpeChannel {    // as last sent on each member channel
+            int bend;
+            int pressure;
+            int timbre;
+        };
+        MpeChannel mpe[NUM_MIDI_CHANNELS];
+
         // MonoNote stuff
-        std::list<uchar> monoNoteHistory; // held notes.
+        struct HeldNote {
+            uchar note;
+            int velocity;
+            int mpeChannel; // as for the note positions, so the recalled note can be released
+        };
+        std::list<HeldNote> monoNoteHistory; // held notes, the same key on two MPE channels is held twice
         struct {
-            float velocity;
             float noteVolume;
-        } monoNote[256];   // 256 is to cover all possible note values. monoNote[]
-                           // is used in conjunction with the list to store the velocity value of a given note
-                           // (the list only store note values). For example:
-                           // 'monoNote[note].velocity' would be the velocity value of the note 'note'.
+        } monoNote[256];   // 256 is to cover all possible note values.
 
         SynthEngine* synth;
 };
@@ -0,0 +1,119 @@
+/*
+    PeriodTiming.h - Audio period render time telemetry
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PERIOD_TIMING_H
+#define PERIOD_TIMING_H
+
+#include <sys/types.h>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+using std::chrono::steady_clock;
+
+
+/**
+ * Records how long each audio period took to render, compared with the
+ * time the period actually represents. Written only by the audio thread,
+ * read by anyone (CLI) so everything is a relaxed atomic and no locks
+ * are involved. Readers may see values from neighbouring periods, which
+ * is fine for statistics.
+ */
+class PeriodTiming
+{
+    public:
+        // ten bins of 10% of the budget, the last one is 'over budget'
+        static constexpr uint BINS = 11;
+
+        PeriodTiming()
+        {
+            reset();
+            budgetUs.store(0, std::memory_order_relaxed);
+        }
+        // shall not be copied nor moved
+        PeriodTiming(PeriodTiming&&)                 = delete;
+        PeriodTiming(PeriodTiming const&)            = delete;
+        PeriodTiming& operator=(PeriodTiming&&)      = delete;
+        PeriodTiming& operator=(PeriodTiming const&) = delete;
+
+        void setBudget(uint frames, uint samplerate)
+        {
+            if (samplerate > 0)
+                budgetUs.store(uint64_t(frames) * 1000000 / samplerate, std::memory_order_relaxed);
+        }
+
+        void reset()
+        {
+            for (auto& bin : histogram)
+                bin.store(0, std::memory_order_relaxed);
+            periodCount.store(0, std::memory_order_relaxed);
+            xrunCount.store(0, std::memory_order_relaxed);
+            worstUs.store(0, std::memory_order_relaxed);
+            totalUs.store(0, std::memory_order_relaxed);
+        }
+
+        // audio thread only
+        void record(uint64_t renderUs)
+        {
+            uint64_t budget = budgetUs.load(std::memory_order_relaxed);
+            uint bin = BINS - 1;
+            if (budget > 0 && renderUs < budget)
+                bin = uint(renderUs * (BINS - 1) / budget);
+            histogram[bin].store(histogram[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            periodCount.store(periodCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            totalUs.store(totalUs.load(std::memory_order_relaxed) + renderUs, std::memory_order_relaxed);
+            if (renderUs > worstUs.load(std::memory_order_relaxed))
+                worstUs.store(renderUs, std::memory_order_relaxed);
+        }
+
+        void xrun()
+        {
+            xrunCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t budget()   const { return budgetUs.load(std::memory_order_relaxed); }
+        uint64_t periods()  const { return periodCount.load(std::memory_order_relaxed); }
+        uint64_t xruns()    const { return xrunCount.load(std::memory_order_relaxed); }
+        uint64_t worst()    const { return worstUs.load(std::memory_order_relaxed); }
+        uint64_t bin(uint i)const { return histogram[i].load(std::memory_order_relaxed); }
+        uint64_t average()  const
+        {
+            uint64_t count = periods();
+            return count ? totalUs.load(std::memory_order_relaxed) / count : 0;
+        }
+        // negative when the worst period overran its budget
+        int64_t headroom()  const { return int64_t(budget()) - int64_t(worst()); }
+
+        static uint64_t nowUs()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>
+                        (steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        std::atomic<uint64_t> budgetUs;
+        std::atomic<uint64_t> periodCount;
+        std::atomic<uint64_t> xrunCount;
+        std::atomic<uint64_t> worstUs;
+        std::atomic<uint64_t> totalUs;
+        std::atomic<uint64_t> histogram[BINS];
+};
+
+#endif /*PERIOD_TIMING_H*/
@@ -0,0 +1,241 @@
+/*
+    RTLog.h - Log messages from real-time threads without allocating
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef RTLOG_H
+#define RTLOG_H
+
+#include <sys/types.h>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include <cstdio>
+
+#include "Misc/PeriodTiming.h"
+#include "globals.h"
+
+
+/*
+ * Everything the audio side may want to report. The text is only put
+ * together later, on a thread where allocating and blocking are fine.
+ * In the formats %s takes the next text, %d the next number and %x the
+ * next number in hex.
+ */
+namespace rtlog {
+
+// set by each audio thread as it starts, so shared code knows it mustn't block
+inline thread_local bool audioThread = false;
+
+enum message : uchar {
+    tooManyNotes = 0,
+    jackAudioBuffer,
+    jackMidiBuffer,
+    jackXrun,
+    alsaError,
+    alsaWeirdState,
+    alsaNotRunning,
+    alsaXrunRecovery,
+    alsaGrowFailed,
+    alsaPeriodsRaised,
+    returnsFull,
+    midiUnsupported,
+    midiBufferFull,
+    midiLearnCongestion,
+    count // this must be the last one!
+};
+
+struct Description {
+    const char *format;
+    char severity;       // as for Config::Log()
+    uint intervalMs;     // repeats closer than this are only counted
+};
+
+inline Description const& describe(message id)
+{
+    static const Description table[count] = {
+        {"Too many notes - notes > polyphony",                     _SYS_::LogNormal,     1000},
+        {"Failed to get jack audio port buffer: %d",               _SYS_::LogNormal,     1000},
+        {"Bad midi jack_port_get_buffer",                          _SYS_::LogNormal,     1000},
+        {"xrun reported",                                          _SYS_::LogNotSerious, 250},
+        {"Error, alsa audio: %s: %s",                              _SYS_::LogNormal,     250},
+        {"Alsa AudioThread, weird SND_PCM_STATE: %d",              _SYS_::LogNormal,     1000},
+        {"Audio pcm still not running",                            _SYS_::LogNormal,     1000},
+        {"Alsa xrun recovery %s",                                  _SYS_::LogNormal,     250},
+        {"Alsa failed to raise number of periods",                 _SYS_::LogNormal,     1000},
+        {"Alsa xruns clustering, raised number of periods to %d",  _SYS_::LogNotSerious, 0},
+        {"Unable to write to decodeLoopback buffer",               _SYS_::LogNormal,     1000},
+        {"Unsupported MIDI event, status byte 0x%x",                 _SYS_::LogNotSerious, 1000},
+        {"Midi buffer full!",                                      _SYS_::LogNormal,     1000},
+        {"MidiLearn: congestion on MIDI->Engine",                  _SYS_::LogNormal,     1000},
+    };
+    return table[id];
+}
+
+} // namespace rtlog
+
+
+/*
+ * A fixed ring of message records that any number of real-time threads
+ * can post to without locks or allocation (a bounded queue after Dmitry
+ * Vyukov, each slot carries its own sequence number). A single non-RT
+ * thread drains it. If the ring is full the message is dropped, and a
+ * message repeated within its interval is only counted; both totals are
+ * kept for the stats and the repeats are reported with the next one
+ * that gets through.
+ */
+class RTLog
+{
+    public:
+        static constexpr uint SLOTS = 256; // must be a power of 2
+
+        struct Entry {
+            rtlog::message id;
+            const char *text[2]; // string literals or other static text only
+            long value[2];
+        };
+
+        RTLog() : head{0}, tail{0}, droppedCount{0}, suppressedCount{0}
+        {
+            for (uint i = 0; i < SLOTS; ++i)
+                slot[i].seq.store(i, std::memory_order_relaxed);
+            for (uint i = 0; i < rtlog::count; ++i)
+            {
+                nextAllowedUs[i].store(0, std::memory_order_relaxed);
+                repeats[i].store(0, std::memory_order_relaxed);
+            }
+        }
+        // shall not be copied nor moved
+        RTLog(RTLog&&)                 = delete;
+        RTLog(RTLog const&)            = delete;
+        RTLog& operator=(RTLog&&)      = delete;
+        RTLog& operator=(RTLog const&) = delete;
+
+        // safe from any thread, never blocks
+        bool post(rtlog::message id, long value0 = 0, long value1 = 0)
+        {
+            return post(id, nullptr, nullptr, value0, value1);
+        }
+
+        bool post(rtlog::message id, const char *text0, const char *text1 = nullptr, long value0 = 0, long value1 = 0)
+        {
+            if (id >= rtlog::count)
+                return false;
+            uint64_t interval = rtlog::describe(id).intervalMs * uint64_t(1000);
+            if (interval)
+            {
+                uint64_t now = PeriodTiming::nowUs();
+                uint64_t allowed = nextAllowedUs[id].load(std::memory_order_relaxed);
+                if (now < allowed || !nextAllowedUs[id].compare_exchange_strong(allowed, now + interval, std::memory_order_relaxed))
+                {
+                    repeats[id].fetch_add(1, std::memory_order_relaxed);
+                    suppressedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            uint64_t pos = head.load(std::memory_order_relaxed);
+            Cell *cell;
+            while (true)
+            {
+                cell = &slot[pos & (SLOTS - 1)];
+                uint64_t seq = cell->seq.load(std::memory_order_acquire);
+                int64_t diff = int64_t(seq) - int64_t(pos);
+                if (diff == 0)
+                {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                    pos = head.load(std::memory_order_relaxed);
+            }
+            cell->entry = Entry{id, {text0, text1}, {value0, value1}};
+            cell->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // single consumer only
+        bool fetch(Entry& out, uint& repeated)
+        {
+            Cell& cell = slot[tail & (SLOTS - 1)];
+            if (cell.seq.load(std::memory_order_acquire) != tail + 1)
+                return false;
+            out = cell.entry;
+            cell.seq.store(tail + SLOTS, std::memory_order_release);
+            ++tail;
+            repeated = repeats[out.id].exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        static std::string format(Entry const& entry, uint repeated)
+        {
+            std::string line;
+            int texts = 0;
+            int values = 0;
+            for (const char *c = rtlog::describe(entry.id).format; *c; ++c)
+            {
+                if (c[0] == '%' && c[1] == 's' && texts < 2)
+                {
+                    line += entry.text[texts] ? entry.text[texts] : "";
+                    ++texts;
+                    ++c;
+                }
+                else if (c[0] == '%' && c[1] == 'd' && values < 2)
+                {
+                    line += std::to_string(entry.value[values++]);
+                    ++c;
+                }
+                else if (c[0] == '%' && c[1] == 'x' && values < 2)
+                {
+                    char hex[20];
+                    snprintf(hex, sizeof(hex), "%lx", (unsigned long)entry.value[values++]);
+                    line += hex;
+                    ++c;
+                }
+                else
+                    line += *c;
+            }
+            if (repeated)
+                line += " (repeated " + std::to_string(repeated) + " more times)";
+            return line;
+        }
+
+        uint64_t dropped()    const { return droppedCount.load(std::memory_order_relaxed); }
+        uint64_t suppressed() const { return suppressedCount.load(std::memory_order_relaxed); }
+
+    private:
+        struct Cell {
+            std::atomic<uint64_t> seq;
+            Entry entry;
+        };
+
+        Cell slot[SLOTS];
+        std::atomic<uint64_t> head;
+        uint64_t tail;
+        std::atomic<uint64_t> droppedCount;
+        std::atomic<uint64_t> suppressedCount;
+        std::atomic<uint64_t> nextAllowedUs[rtlog::count];
+        std::atomic<uint> repeats[rtlog::count];
+};
+
+#endif /*RTLOG_H*/
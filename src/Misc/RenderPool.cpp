@@ -0,0 +1,252 @@
+/*
+    RenderPool.cpp - Worker threads sharing out the notes of one part
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Misc/RenderPool.h"
+#include "Misc/SynthEngine.h"
+#include "Misc/Config.h"
+#include "Misc/Denormals.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <string>
+
+namespace { // pause between looks while waiting for the other threads
+
+    constexpr uint SPINS = 2000;
+
+    inline void relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    inline void semWait(sem_t *sem)
+    {
+        while (sem_wait(sem) < 0 && errno == EINTR)
+        { }
+    }
+}
+
+
+RenderPool::RenderPool(SynthEngine& _synth)
+    : synth{_synth}
+    , threads{}
+    , callerContext{}
+    , jobBuffers{}
+    , bufferFrames{0}
+    , running{0}
+    , quit{false}
+    , wake{}
+    , finished{}
+    , cursor{0}
+    , done{0}
+    , batchJob{nullptr}
+    , batchOwner{nullptr}
+    , batchSize{0}
+    , batchCount{0}
+{
+    sem_init(&wake, 0, 0);
+    sem_init(&finished, 0, 0);
+}
+
+
+RenderPool::~RenderPool()
+{
+    stop();
+    sem_destroy(&wake);
+    sem_destroy(&finished);
+}
+
+
+bool RenderPool::start(uint count)
+{
+    if (running > 0 || count == 0)
+        return true;
+    if (count > MAX_THREADS)
+        count = MAX_THREADS;
+    Config& runtime = synth.getRuntime();
+
+    bufferFrames = synth.controlsize;
+    for (uint j = 0; j < MAX_JOBS; ++j)
+        jobBuffers[j].reset(JOB_BUFFERS * bufferFrames);
+
+    callerContext.tmp[0] = &runtime.genTmp1;
+    callerContext.tmp[1] = &runtime.genTmp2;
+    callerContext.tmp[2] = &runtime.genTmp3;
+    callerContext.tmp[3] = &runtime.genTmp4;
+    callerContext.rng = nullptr;
+
+    quit.store(false);
+    for (uint i = 0; i < count; ++i)
+    {
+        Thread& thread = threads[i];
+        thread.pool = this;
+        thread.index = i;
+        for (int b = 0; b < 4; ++b)
+        {
+            thread.buffers[b].reset(bufferFrames);
+            thread.context.tmp[b] = &thread.buffers[b];
+        }
+        thread.context.rng = nullptr;
+        if (!runtime.startThread(&thread.handle, _worker, &thread, true, 0, "Render " + std::to_string(i + 1)))
+        {
+            runtime.Log("Failed to start render thread " + std::to_string(i + 1), _SYS_::LogError);
+            break;
+        }
+        ++running;
+    }
+    if (running > 0)
+        runtime.Log("Rendering notes on " + std::to_string(running + 1) + " threads");
+    return running == count;
+}
+
+
+void RenderPool::stop()
+{
+    if (running == 0)
+        return;
+    quit.store(true);
+    for (uint i = 0; i < running; ++i)
+        sem_post(&wake);
+    for (uint i = 0; i < running; ++i)
+        pthread_join(threads[i].handle, nullptr);
+    running = 0;
+}
+
+
+size_t RenderPool::prefault()
+{
+    size_t bytes = 0;
+    if (running == 0)
+        return bytes;
+    for (uint j = 0; j < MAX_JOBS; ++j)
+        bytes += prefaultPages(jobBuffers[j], JOB_BUFFERS * bufferFrames);
+    for (uint i = 0; i < running; ++i)
+        for (int b = 0; b < 4; ++b)
+            bytes += prefaultPages(threads[i].buffers[b], bufferFrames);
+    return bytes;
+}
+
+
+void *RenderPool::_worker(void *arg)
+{
+    Thread *thread = static_cast<Thread*>(arg);
+    thread->pool->worker(thread->index);
+    return nullptr;
+}
+
+
+void RenderPool::worker(uint index)
+{
+    prefaultStack();
+    if (synth.getRuntime().flushDenormals)
+        denormal::enableFlushToZero();
+    render::current = &threads[index].context;
+
+    while (true)
+    {
+        semWait(&wake);
+        if (quit.load(std::memory_order_relaxed))
+            break;
+        uint job;
+        while (claim(job))
+        {   // only read once a job of this batch is held, so it can't move on
+            Job func = batchJob;
+            void *owner = batchOwner;
+            uint size = batchSize;
+            func(owner, job);
+            if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == size)
+                sem_post(&finished);
+        }
+    }
+    render::current = nullptr;
+}
+
+
+bool RenderPool::claim(uint& index)
+{
+    uint64_t value = cursor.load(std::memory_order_acquire);
+    while (true)
+    {
+        uint next = value & 0xffff;
+        uint size = (value >> 16) & 0xffff;
+        if (next >= size)
+            return false;
+        if (cursor.compare_exchange_weak(value, value + 1,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+        {
+            index = next;
+            return true;
+        }
+    }
+}
+
+
+void RenderPool::run(Job job, void *owner, uint count, bool spread)
+{
+    if (count == 0)
+        return;
+    render::Context *saved = render::current;
+    render::current = &callerContext;
+    if (!spread || running == 0 || count == 1)
+    {
+        for (uint i = 0; i < count; ++i)
+            job(owner, i);
+        render::current = saved;
+        return;
+    }
+
+    batchJob = job;
+    batchOwner = owner;
+    batchSize = count;
+    done.store(0, std::memory_order_relaxed);
+    uint64_t batch = (cursor.load(std::memory_order_relaxed) >> 32) + 1;
+    cursor.store(batch << 32 | uint64_t(count) << 16, std::memory_order_release);
+
+    uint helpers = std::min(running, count - 1);
+    for (uint i = 0; i < helpers; ++i)
+        sem_post(&wake);
+
+    bool last = false;
+    uint index;
+    while (claim(index))
+    {
+        job(owner, index);
+        if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == count)
+            last = true;
+    }
+    render::current = saved;
+
+    if (!last)
+    {   // whoever finishes the batch posts once, so always collect it
+        for (uint spin = 0; spin < SPINS; ++spin)
+        {
+            if (done.load(std::memory_order_acquire) == count)
+                break;
+            relax();
+        }
+        semWait(&finished);
+    }
+    batchCount.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,146 @@
+/*
+    RenderPool.h - Worker threads sharing out the notes of one part
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef RENDER_POOL_H
+#define RENDER_POOL_H
+
+#include <sys/types.h>
+#include <cstdint>
+#include <atomic>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "Misc/Alloc.h"
+#include "Misc/RandomGen.h"
+#include "globals.h"
+
+class SynthEngine;
+
+
+/*
+ * While notes are being rendered in parallel, the scratch buffers and
+ * the random numbers they use can't be the engine wide ones. Each thread
+ * taking part has its own context, and every note slot its own random
+ * generator, so the result doesn't depend on which thread got which
+ * note. Outside of that 'current' is null and the shared ones are used.
+ */
+namespace render {
+
+struct Context
+{
+    Samples *tmp[4];
+    RandomGen *rng;
+};
+
+inline thread_local Context *current = nullptr;
+
+inline Samples& scratch(Samples& shared, int which)
+{
+    return current ? *current->tmp[which] : shared;
+}
+
+inline RandomGen& random(RandomGen& shared)
+{
+    return (current && current->rng) ? *current->rng : shared;
+}
+
+} // namespace render
+
+
+/*
+ * A handful of real-time threads that the audio thread can hand a batch
+ * of independent jobs to. The caller takes jobs too, and only returns
+ * once all of them are done, so the batch is just a faster way of
+ * running a loop.
+ *
+ * Jobs are claimed from a single atomic cursor which also carries the
+ * batch number and size, so a worker that wakes late can never pick up
+ * a stale job. The caller spins briefly for jobs still running on other
+ * threads, then blocks, so it can't starve a worker on the same core.
+ */
+class RenderPool
+{
+    public:
+        static constexpr uint MAX_THREADS = 16;
+        static constexpr uint MAX_JOBS = POLYPHONY;
+        // a stereo pair for a note, one for the part output and one per part effect
+        static constexpr uint JOB_BUFFERS = 2 * (NUM_PART_EFX + 2);
+        static constexpr float MIN_SPREAD_NS = 10000.0f; // per batch, below this waking threads costs more
+        using Job = void (*)(void *owner, uint index);
+
+        RenderPool(SynthEngine& _synth);
+       ~RenderPool();
+        // shall not be copied nor moved
+        RenderPool(RenderPool&&)                 = delete;
+        RenderPool(RenderPool const&)            = delete;
+        RenderPool& operator=(RenderPool&&)      = delete;
+        RenderPool& operator=(RenderPool const&) = delete;
+
+        bool start(uint threads);
+        void stop();
+        size_t prefault();
+
+        uint size() const { return running; } // not counting the caller
+
+        // audio thread only, count must be below 65536; without
+        // spread, or any threads, the caller runs them all in turn
+        void run(Job job, void *owner, uint count, bool spread = true);
+
+        // private to the job with this index, controlsize long
+        float *jobBuffer(uint index, uint which)
+        {
+            return jobBuffers[index].get() + which * bufferFrames;
+        }
+
+        uint64_t batches() const { return batchCount.load(std::memory_order_relaxed); }
+
+    private:
+        static void *_worker(void *arg);
+        void worker(uint index);
+        bool claim(uint& index);
+
+        struct Thread {
+            RenderPool *pool;
+            uint index;
+            pthread_t handle;
+            Samples buffers[4];
+            render::Context context;
+        };
+
+        SynthEngine& synth;
+        Thread threads[MAX_THREADS];
+        render::Context callerContext;
+        Samples jobBuffers[MAX_JOBS];
+        uint bufferFrames;
+        uint running;
+        std::atomic<bool> quit;
+        sem_t wake;
+        sem_t finished;
+
+        // batch number << 32 | size << 16 | next index
+        std::atomic<uint64_t> cursor;
+        std::atomic<uint> done;
+        Job batchJob;
+        void *batchOwner;
+        uint batchSize;
+        std::atomic<uint64_t> batchCount;
+};
+
+#endif /*RENDER_POOL_H*/
@@ -67,6 +67,8 @@ using file::make_legit_filename;
 using func::decibel;
 using func::bitTest;
 using func::asString;
+using func::asDecibel;
+using func::asCompactString;
 using func::string2int;
 
 using std::this_thread::sleep_for;
@@ -136,6 +138,9 @@ SynthEngine::SynthEngine(uint instanceID)
     , sent_bufferbytes{0}
     , sent_buffersize_f{0}
     , fixed_sample_step_f{0}
+    , controlsize{0}
+    , control_step_f{0}
+    , controlOffset{0}
     , TransVolume{0}
     , Pvolume{0}
     , ControlStep{0}
@@ -160,15 +165,17 @@ SynthEngine::SynthEngine(uint instanceID)
     , microtonal{this}
     , fft{}
     , textMsgBuffer{TextMsgBuffer::instance()}
-    , VUpeak{}
-    , VUcopy{}
     , VUdata{}
     , VUcount{0}
-    , VUready{false}
+    , meters{}
+    , renderPool{*this}
     , volume{0.0}
     // sysefxvol[][]
     // sysefxsend[][]
     , keyshift{0}
+    , meterAccum{}
+    , truePeak{}
+    , meterSeen{0}
     , callbackGuiClosed{}
     , windowTitle{"Yoshimi" + asString(uniqueId)}
     , needsSaving{false}
@@ -209,6 +216,8 @@ SynthEngine::~SynthEngine()
     shutdownGui();
 #endif
 
+    renderPool.stop();
+    mididecode.tuning.stop();
     for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
         if (part[npart])
             delete part[npart];
@@ -239,6 +248,13 @@ bool SynthEngine::Init(uint audiosrate, int audiobufsize)
         buffersize = audiobufsize;
     buffersize_f = buffersize;
     fixed_sample_step_f = buffersize_f / samplerate_f;
+    /*
+     * Notes are always rendered in control blocks of this size, so
+     * modulation sounds the same with any buffer size. Parts carry
+     * whatever runs past the end of a period over to the next one.
+     */
+    controlsize = CONTROL_BLOCK_SIZE;
+    control_step_f = controlsize / samplerate_f;
     bufferbytes = buffersize * sizeof(float);
 
     oscilsize_f = oscilsize = Runtime.oscilsize;
@@ -314,14 +330,20 @@ bool SynthEngine::Init(uint audiosrate, int audiobufsize)
      * were being made every time an add or sub note
      * was processed. Now global so treat with care!
      */
-    Runtime.genTmp1.reset(buffersize);
-    Runtime.genTmp2.reset(buffersize);
-    Runtime.genTmp3.reset(buffersize);
-    Runtime.genTmp4.reset(buffersize);
+    Runtime.genTmp1.reset(controlsize);
+    Runtime.genTmp2.reset(controlsize);
+    Runtime.genTmp3.reset(controlsize);
+    Runtime.genTmp4.reset(controlsize);
 
-    // similar to above but for parts
-    Runtime.genMixl.reset(buffersize);
-    Runtime.genMixr.reset(buffersize);
+    // similar to above but for parts, which also take a note's block
+    Runtime.genMixl.reset(std::max(buffersize, controlsize));
+    Runtime.genMixr.reset(std::max(buffersize, controlsize));
+
+    // helper threads for the notes of busy parts
+    if (Runtime.renderThreads > 0)
+        renderPool.start(Runtime.renderThreads);
+    // MIDI Tuning Standard messages are worked out away from the MIDI thread
+    mididecode.tuning.start();
 
     defaults();
     ClearNRPNs();
@@ -409,6 +431,52 @@ bail_out:
 }
 
 
+/**
+ * Called once everything is allocated, just before the audio threads start.
+ * Locks the process in memory if wanted, then touches every buffer the
+ * engine owns so the first periods don't stall on page faults.
+ */
+void SynthEngine::prepareRealtime()
+{
+    bool locked = (Runtime.memoryLock || Runtime.memoryLockCmd) && Runtime.lockMemory();
+    size_t bytes = prefault();
+    string msg = "Prefaulted " + asString(uint(bytes / 1024)) + "kB of engine buffers";
+    if (locked)
+        msg += ", locked memory " + Runtime.lockedFootprint();
+    Runtime.Log(msg);
+}
+
+
+/**
+ * Each audio thread calls this for itself as it starts,
+ * as the floating point mode belongs to the thread.
+ */
+void SynthEngine::enableFlushToZero()
+{
+    if (Runtime.flushDenormals)
+        flushingDenormals.store(denormal::enableFlushToZero(), std::memory_order_relaxed);
+}
+
+
+size_t SynthEngine::prefault()
+{
+    size_t bytes = prefaultPages(Runtime.genTmp1, controlsize)
+                 + prefaultPages(Runtime.genTmp2, controlsize)
+                 + prefaultPages(Runtime.genTmp3, controlsize)
+                 + prefaultPages(Runtime.genTmp4, controlsize)
+                 + prefaultPages(Runtime.genMixl, std::max(buffersize, controlsize))
+                 + prefaultPages(Runtime.genMixr, std::max(buffersize, controlsize));
+    for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+        bytes += part[npart]->prefault();
+    for (int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
+        bytes += insefx[nefx]->prefault();
+    for (int nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
+        bytes += sysefx[nefx]->prefault();
+    bytes += renderPool.prefault();
+    return bytes;
+}
+
+
 /**
  * Prepare and wire a communication anchor, allowing the GUI to establish
  * data connections with this SynthEngine. This InstanceAnchor record is
@@ -501,20 +569,13 @@ void SynthEngine::defaults()
     setPkeyshift(64);
     PbpmFallback = 120;
 
-    VUpeak.values.vuOutPeakL = 0;
-    VUpeak.values.vuOutPeakR = 0;
-    VUpeak.values.vuRmsPeakL = 0;
-    VUpeak.values.vuRmsPeakR = 0;
+    meterAccum.clear();
 
     for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
         part[npart]->defaults(npart);
 
-    VUpeak.values.parts[0] = -1.0f;
-    VUpeak.values.partsR[0] = -1.0f;
     VUdata.values.parts[0] = -1.0f;
     VUdata.values.partsR[0] = -1.0f;
-    VUcopy.values.parts[0]= -1.0f;
-    VUcopy.values.partsR[0]= -1.0f;
 
     inseffnum = 0;
     for (int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
@@ -543,7 +604,6 @@ void SynthEngine::defaults()
     microtonal.defaults();
     setAllPartMaps();
     VUcount = 0;
-    VUready = false;
     Runtime.currentPart = 0;
     Runtime.VUcount = 0;
     Runtime.channelSwitchType = MIDI::SoloType::Disabled;
@@ -577,8 +637,10 @@ void SynthEngine::setPartMap(int npart)
 }
 
 
+// after any change to the tuning
 void SynthEngine::setAllPartMaps()
 {
+    microtonal.compile();
     for (int npart = 0; npart < NUM_MIDI_PARTS; ++ npart)
         setPartMap(npart);
 }
@@ -686,6 +748,8 @@ void SynthEngine::NoteOn(uchar chan, uchar note, uchar velocity)
             if (partonoffRead(npart))
                 part[npart]->NoteOn(note, velocity);
         }
+        else if (part[npart]->mpeMember(chan, part[npart]->Prcvchn) && partonoffRead(npart))
+            part[npart]->NoteOn(note, velocity, false, chan);
     }
 #ifdef REPORT_NOTE_ON_TIME
     if (Runtime.showTimes)
@@ -712,6 +776,8 @@ void SynthEngine::NoteOff(uchar chan, uchar note)
         // mask values 16 - 31 to still allow a note off
         if (chan == (part[npart]->Prcvchn & 0xef) && partonoffRead(npart))
             part[npart]->NoteOff(note);
+        else if (part[npart]->mpeMember(chan, part[npart]->Prcvchn & 0xef) && partonoffRead(npart))
+            part[npart]->NoteOff(note, chan);
     }
 }
 
@@ -858,8 +924,9 @@ void SynthEngine::SetController(uchar chan, int CCtype, short int par)
     }
 
     int minPart, maxPart;
+    bool channel = chan < NUM_MIDI_CHANNELS; // rather than one part
 
-    if (chan < NUM_MIDI_CHANNELS)
+    if (channel)
     {
         minPart = 0;
         maxPart = Runtime.numAvailableParts;
@@ -899,6 +966,8 @@ void SynthEngine::SetController(uchar chan, int CCtype, short int par)
                 part[npart]->SetController(CCtype, par);
             }
         }
+        else if (channel && part[npart]->Penabled == 1 && part[npart]->mpeMember(chan, part[npart]->Prcvchn))
+            part[npart]->setMpeController(chan, CCtype, par);
     }
 }
 
@@ -1557,6 +1626,108 @@ void SynthEngine::ListSettings(list<string>& msg_buf)
 }
 
 
+void SynthEngine::ListStats(list<string>& msg_buf)
+{
+    msg_buf.push_back("Engine statistics:");
+    uint64_t budget = periodTiming.budget();
+    if (budget == 0)
+        msg_buf.push_back("  No period timing from this audio backend");
+    else
+    {
+        msg_buf.push_back("  Period budget " + asString(budget) + "us");
+        msg_buf.push_back("  Periods " + asString(periodTiming.periods()));
+        msg_buf.push_back("  Xruns " + asString(periodTiming.xruns()));
+        msg_buf.push_back("  Average render " + asString(periodTiming.average()) + "us");
+        msg_buf.push_back("  Worst render " + asString(periodTiming.worst()) + "us");
+        msg_buf.push_back("  Headroom " + asString(periodTiming.headroom()) + "us");
+        msg_buf.push_back("  Render time as % of budget:");
+        for (uint i = 0; i < PeriodTiming::BINS; ++i)
+        {
+            string label;
+            if (i < PeriodTiming::BINS - 1)
+                label = asString(i * 10) + "-" + asString((i + 1) * 10);
+            else
+                label = "over";
+            msg_buf.push_back("    " + label + "  " + asString(periodTiming.bin(i)));
+        }
+    }
+
+    msg_buf.push_back("  Sleeping parts " + asString(sleepingParts.load(std::memory_order_relaxed))
+                      + " of " + asString(activeParts.load(std::memory_order_relaxed)));
+    msg_buf.push_back("  Sleeping effects " + asString(sleepingEffects.load(std::memory_order_relaxed))
+                      + " of " + asString(activeEffects.load(std::memory_order_relaxed)));
+
+    msg_buf.push_back("  Voices " + asString(voices.voices()) + ", peak " + asString(voices.peakVoices())
+                      + ", limit " + (Runtime.voiceLimit ? asString(Runtime.voiceLimit) : string{"none"}));
+    msg_buf.push_back("  Synth load " + asString(voices.loadPercent()) + "% of period, ceiling "
+                      + (Runtime.loadCeiling ? asString(Runtime.loadCeiling) + "%" : string{"none"}));
+    msg_buf.push_back("  Voices stolen for limit " + asString(voices.stolenForLimit())
+                      + ", for load " + asString(voices.stolenForLoad())
+                      + ", notes dropped " + asString(voices.droppedNotes()));
+    if (renderPool.size() > 0)
+        msg_buf.push_back("  Render threads " + asString(renderPool.size())
+                          + ", shared out blocks " + asString(renderPool.batches()));
+    msg_buf.push_back("  MIDI commands merged " + asString(interchange.midiMerged()));
+    if (mididecode.tuning.applied() > 0 || mididecode.tuning.dropped() > 0)
+        msg_buf.push_back("  MIDI tuning messages applied " + asString(mididecode.tuning.applied())
+                          + ", lost " + asString(mididecode.tuning.dropped()));
+    msg_buf.push_back("  Audio thread messages repeated " + asString(Runtime.rtLog.suppressed())
+                      + ", lost " + asString(Runtime.rtLog.dropped()));
+
+    if (flushingDenormals.load(std::memory_order_relaxed))
+        msg_buf.push_back("  Denormals flushed to zero");
+    else
+        msg_buf.push_back("  Denormals not flushed");
+    if (Runtime.denormalCheck)
+    {
+        static const string effectNames[DenormalCounter::EFFECTS] = {"None", "Reverb", "Echo", "Chorus", "Phaser", "AlienWah", "Distortion", "EQ", "DynFilter"};
+        static const string filterNames[DenormalCounter::FILTERS] = {"Analog filter", "Formant filter", "SV filter"};
+        msg_buf.push_back("  Denormal samples seen:");
+        for (uint type = 1; type < DenormalCounter::EFFECTS; ++type)
+            msg_buf.push_back("    " + effectNames[type] + "  " + asString(denormals.effect(type)));
+        for (uint category = 0; category < DenormalCounter::FILTERS; ++category)
+            msg_buf.push_back("    " + filterNames[category] + "  " + asString(denormals.filter(category)));
+    }
+}
+
+
+void SynthEngine::ListMeters(list<string>& msg_buf)
+{
+    MeterBlock block;
+    if (!meters.read(block))
+    {
+        msg_buf.push_back("No meter data yet");
+        return;
+    }
+    auto dB = [](float level) -> string
+    {
+        if (level < 1e-6f)
+            return "-inf";
+        return asCompactString(asDecibel(level));
+    };
+    // peak hold over the whole history ring
+    float holdL = block.peakL;
+    float holdR = block.peakR;
+    MeterBlock older;
+    for (uint age = 1; age < MeterPublisher::HISTORY && meters.read(older, age); ++age)
+    {
+        holdL = std::max(holdL, older.peakL);
+        holdR = std::max(holdR, older.peakR);
+    }
+    msg_buf.push_back("Meters in dB (peak / rms / true peak):");
+    msg_buf.push_back("  Main L  " + dB(block.peakL) + " / " + dB(block.rmsL) + " / " + dB(block.truePeakL) + "   hold " + dB(holdL));
+    msg_buf.push_back("  Main R  " + dB(block.peakR) + " / " + dB(block.rmsR) + " / " + dB(block.truePeakR) + "   hold " + dB(holdR));
+    for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+    {
+        if (block.partPeakL[npart] < 0.0f)
+            continue;
+        msg_buf.push_back("  Part " + asString(npart + 1)
+                          + "  L " + dB(block.partPeakL[npart]) + " / " + dB(block.partRmsL[npart]) + " / " + dB(block.partTrueL[npart])
+                          + "   R " + dB(block.partPeakR[npart]) + " / " + dB(block.partRmsR[npart]) + " / " + dB(block.partTrueR[npart]));
+    }
+}
+
+
 /*
  * Provides a way of setting dynamic system variables via NRPNs
  */
@@ -1632,15 +1803,17 @@ int SynthEngine::SetSystemValue(int type, int value)
                         {
                             ++ tries;
                             ok = interchange.fromMIDI.write(putData.bytes);
-                            if (!ok)
+                            if (!ok && !rtlog::audioThread)
                                 sleep_for(1us);
-                        // we can afford a short delay for buffer to clear
+                        // off the audio thread we can afford a short delay for buffer to clear
                         }
-                        while (!ok && tries < 3);
+                        while (!ok && !rtlog::audioThread && tries < 3);
                         if (!ok)
                         {
-                            Runtime.Log("Midi buffer full!");
-                            ok = false;
+                            if (rtlog::audioThread)
+                                Runtime.rtLog.post(rtlog::midiBufferFull);
+                            else
+                                Runtime.Log("Midi buffer full!");
                         }
                     }
                 }
@@ -1750,15 +1923,17 @@ int SynthEngine::SetSystemValue(int type, int value)
     {
         ++ tries;
         ok = interchange.fromMIDI.write(putData.bytes);
-        if (!ok)
+        if (!ok && !rtlog::audioThread)
             sleep_for(1us);
-    // we can afford a short delay for buffer to clear
+    // off the audio thread we can afford a short delay for buffer to clear
     }
-    while (!ok && tries < 3);
+    while (!ok && !rtlog::audioThread && tries < 3);
     if (!ok)
     {
-        Runtime.Log("Midi buffer full!");
-        ok = false;
+        if (rtlog::audioThread)
+            Runtime.rtLog.post(rtlog::midiBufferFull);
+        else
+            Runtime.Log("Midi buffer full!");
     }
     return 0;
 }
@@ -2053,12 +2228,7 @@ void SynthEngine::partonoffWrite(uint npart, int what)
     }
 
     part[npart]->Penabled = tmp;
-    if (tmp == 1 && original != 1) // enable if it wasn't already on
-    {
-        VUpeak.values.parts[npart] = 1e-9f;
-        VUpeak.values.partsR[npart] = 1e-9f;
-    }
-    else if (tmp < 1 && original == 1) // disable if it wasn't already off
+    if (tmp < 1 && original == 1) // disable if it wasn't already off
     {
         part[npart]->cleanup();
         for (int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
@@ -2066,8 +2236,6 @@ void SynthEngine::partonoffWrite(uint npart, int what)
             if (Pinsparts[nefx] == int(npart))
                 insefx[nefx]->cleanup();
         }
-        VUpeak.values.parts[npart] = -1.0f;
-        VUpeak.values.partsR[npart] = -1.0f;
     }
 }
 
@@ -2096,11 +2264,7 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
     sent_buffersize_f = buffersize_f;
 
     if ((to_process > 0) && (to_process < buffersize))
-    {
-        sent_buffersize = to_process;
-        sent_bufferbytes = sent_buffersize * sizeof(float);
-        sent_buffersize_f = sent_buffersize;
-    }
+        setSentBuffersize(to_process);
 
     memset(mainL, 0, sent_bufferbytes);
     memset(mainR, 0, sent_bufferbytes);
@@ -2157,7 +2321,7 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
     {
         for (uint npart = 0; npart < (Runtime.numAvailableParts); ++npart)
         {
-            if (partLocal[npart])
+            if (partLocal[npart] || (part[npart]->Paudiodest & 2))
             {
                 memset(outl[npart], 0, sent_bufferbytes);
                 memset(outr[npart], 0, sent_bufferbytes);
@@ -2168,9 +2332,13 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
  * that have a direct output. This completely overwrites the buffers.
  * Only these are sent to jack, so it doesn't matter what the unused ones contain.
  * However, this doesn't happen when muted, so the buffers then need to be zeroed.
+ * With jack direct output these may be the port buffers themselves, so every
+ * part with a direct output must be covered, enabled or not.
  */
     else
     {
+        voices.beginPeriod(*this, partLocal);
+
         // Compute part samples and store them ->partoutl,partoutr
         for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
         {
@@ -2193,12 +2361,25 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
             }
         }
 
+        // silent parts need no volume, panning or effect sends
+        bool partQuiet[NUM_MIDI_PARTS];
+        countSleeping(partLocal, partQuiet);
+
         // Apply the part volumes and pannings (after insertion effects)
         uchar panLaw = Runtime.panLaw;
         for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
         {
             if (!partLocal[npart])
                 continue;
+            if (partQuiet[npart])
+            {   // nothing to fade while silent, so volume and panning go
+                // straight to where they are heading, ready for the next note
+                if (fabsf(part[npart]->Ppanning - part[npart]->TransPanning) > ControlStep)
+                    part[npart]->checkPanning(part[npart]->Ppanning - part[npart]->TransPanning, panLaw);
+                if (fabsf(part[npart]->Pvolume - part[npart]->TransVolume) > ControlStep)
+                    part[npart]->checkVolume(part[npart]->Pvolume - part[npart]->TransVolume);
+                continue;
+            }
 
             float Step = ControlStep;
             for (int i = 0; i < sent_buffersize; ++i)
@@ -2232,6 +2413,7 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
             for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
             {
                 if (partLocal[npart]               // it's enabled
+                 && !partQuiet[npart]              // it has something to send
                  && Psysefxvol[nefx][npart]        // it's sending an output
                  && (part[npart]->Paudiodest & 1)) // it's connected to the main outs
                 {
@@ -2281,7 +2463,7 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
                     outr[npart][i] = part[npart]->partoutr[i];
                 }
             }
-            if (part[npart]->Paudiodest & 1)    // Mix wanted parts to mains
+            if ((part[npart]->Paudiodest & 1) && !partQuiet[npart]) // Mix wanted parts to mains
             {
                 for (int i = 0; i < sent_buffersize; ++i)
                 {   // the volume did not change
@@ -2332,126 +2514,184 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
                 mainL[idx] = mainR[idx] = (mainL[idx] + mainR[idx]) / 2.0;
         }
 
-        // Peak calculation for mixed outputs
-        float absval;
-        for (int idx = 0; idx < sent_buffersize; ++idx)
-        {
-            if ((absval = fabsf(mainL[idx])) > VUpeak.values.vuOutPeakL)
-                VUpeak.values.vuOutPeakL = absval;
-            if ((absval = fabsf(mainR[idx])) > VUpeak.values.vuOutPeakR)
-                VUpeak.values.vuOutPeakR = absval;
-
-            // RMS Peak
-            VUpeak.values.vuRmsPeakL += mainL[idx] * mainL[idx];
-            VUpeak.values.vuRmsPeakR += mainR[idx] * mainR[idx];
-        }
-
-        // Peak computation for part vu meters
-        for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
-        {
-            if (partLocal[npart])
-            {
-                for (int idx = 0; idx < sent_buffersize; ++idx)
-                {
-                    if ((absval = fabsf(part[npart]->partoutl[idx])) > VUpeak.values.parts[npart])
-                        VUpeak.values.parts[npart] = absval;
-                    if ((absval = fabsf(part[npart]->partoutr[idx])) > VUpeak.values.partsR[npart])
-                        VUpeak.values.partsR[npart] = absval;
-                }
-            }
-            else
-            {
-                VUpeak.values.parts[npart] = -1.0f;
-                VUpeak.values.partsR[npart] = -1.0f;
-            }
-        }
-
+        accumulateMeters(mainL, mainR, partLocal);
         VUcount += sent_buffersize;
-        if ((VUcount >= VUperiod && !VUready) || VUcount > (samplerate << 2))
-        // ensure this eventually clears if VUready fails
+        if (VUcount >= VUperiod)
         {
-            VUpeak.values.buffersize = VUcount;
+            meterAccum.frames = VUcount;
             VUcount = 0;
-            memcpy(&VUcopy, &VUpeak, sizeof(VUpeak));
-            VUready = true;
-            VUpeak.values.vuOutPeakL = 1e-12f;
-            VUpeak.values.vuOutPeakR = 1e-12f;
-            VUpeak.values.vuRmsPeakL = 1e-12f;
-            VUpeak.values.vuRmsPeakR = 1e-12f;
+            float scale = 1.0f / meterAccum.frames;
+            meterAccum.rmsL = sqrtf(meterAccum.rmsL * scale);
+            meterAccum.rmsR = sqrtf(meterAccum.rmsR * scale);
             for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
             {
-                if (partLocal[npart])
+                if (meterAccum.partPeakL[npart] >= 0.0f)
                 {
-                    VUpeak.values.parts[npart] = 1.0e-9f;
-                    VUpeak.values.partsR[npart] = 1.0e-9f;
+                    meterAccum.partRmsL[npart] = sqrtf(meterAccum.partRmsL[npart] * scale);
+                    meterAccum.partRmsR[npart] = sqrtf(meterAccum.partRmsR[npart] * scale);
                 }
-                else
-                {
-                    VUpeak.values.parts[npart] = -1.0f;
-                    VUpeak.values.partsR[npart] = -1.0f;
-                }
-
             }
+            meters.publish(meterAccum);
+            meterAccum.peakL = meterAccum.peakR = 0.0f;
+            meterAccum.rmsL = meterAccum.rmsR = 0.0f;
+            meterAccum.truePeakL = meterAccum.truePeakR = 0.0f;
+            for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+                meterAccum.clearPart(npart, partLocal[npart] ? 0.0f : -1.0f);
         }
 
         LFOtime += sent_buffersize; // update the LFO's time
+        voices.endPeriod();
     }
     return sent_buffersize;
 }
 
 
+/*
+ * A part is only quiet if no insertion effect has written a tail into
+ * its output since it was computed. The totals are only for the stats.
+ */
+void SynthEngine::countSleeping(const char *partLocal, bool *partQuiet)
+{
+    uint parts = 0;
+    uint partsAsleep = 0;
+    uint effects = 0;
+    uint effectsAsleep = 0;
+    for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+    {
+        partQuiet[npart] = false;
+        if (!partLocal[npart])
+            continue;
+        ++parts;
+        partQuiet[npart] = part[npart]->isIdle();
+        for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+        {
+            if (part[npart]->Pefxbypass[nefx] || !part[npart]->partefx[nefx]->geteffect())
+                continue;
+            ++effects;
+            if (part[npart]->partefx[nefx]->isAsleep())
+                ++effectsAsleep;
+        }
+    }
+    for (int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
+    {
+        int efxpart = Pinsparts[nefx];
+        if (efxpart == -1 || !insefx[nefx]->geteffect())
+            continue;
+        if (efxpart >= 0 && !part[efxpart]->Penabled)
+            continue; // not being run
+        ++effects;
+        if (insefx[nefx]->isAsleep())
+            ++effectsAsleep;
+        else if (efxpart >= 0)
+            partQuiet[efxpart] = false;
+    }
+    for (int nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
+    {
+        if (!syseffEnable[nefx] || !sysefx[nefx]->geteffect())
+            continue;
+        ++effects;
+        if (sysefx[nefx]->isAsleep())
+            ++effectsAsleep;
+    }
+    for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+    {
+        if (partQuiet[npart])
+            ++partsAsleep;
+    }
+    sleepingParts.store(partsAsleep, std::memory_order_relaxed);
+    activeParts.store(parts, std::memory_order_relaxed);
+    sleepingEffects.store(effectsAsleep, std::memory_order_relaxed);
+    activeEffects.store(effects, std::memory_order_relaxed);
+}
+
+
+void SynthEngine::accumulateMeters(float *mainL, float *mainR, const char *partLocal)
+{
+    int frames = sent_buffersize;
+    float peak = meter::blockPeak(mainL, frames, 0.0f);
+    meterAccum.peakL = std::max(meterAccum.peakL, peak);
+    meterAccum.truePeakL = truePeak[NUM_MIDI_PARTS * 2].process(mainL, frames, peak, std::max(meterAccum.truePeakL, peak));
+    peak = meter::blockPeak(mainR, frames, 0.0f);
+    meterAccum.peakR = std::max(meterAccum.peakR, peak);
+    meterAccum.truePeakR = truePeak[NUM_MIDI_PARTS * 2 + 1].process(mainR, frames, peak, std::max(meterAccum.truePeakR, peak));
+    meterAccum.rmsL = meter::blockSquares(mainL, frames, meterAccum.rmsL);
+    meterAccum.rmsR = meter::blockSquares(mainR, frames, meterAccum.rmsR);
+
+    for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+    {
+        if (!partLocal[npart])
+        {
+            meterAccum.clearPart(npart, -1.0f);
+            continue;
+        }
+        if (meterAccum.partPeakL[npart] < 0.0f) // only just started
+            meterAccum.clearPart(npart, 0.0f);
+        const float *partL = part[npart]->partoutl.get();
+        const float *partR = part[npart]->partoutr.get();
+        peak = meter::blockPeak(partL, frames, 0.0f);
+        meterAccum.partPeakL[npart] = std::max(meterAccum.partPeakL[npart], peak);
+        meterAccum.partTrueL[npart] = truePeak[npart * 2].process(partL, frames, peak, std::max(meterAccum.partTrueL[npart], peak));
+        peak = meter::blockPeak(partR, frames, 0.0f);
+        meterAccum.partPeakR[npart] = std::max(meterAccum.partPeakR[npart], peak);
+        meterAccum.partTrueR[npart] = truePeak[npart * 2 + 1].process(partR, frames, peak, std::max(meterAccum.partTrueR[npart], peak));
+        meterAccum.partRmsL[npart] = meter::blockSquares(partL, frames, meterAccum.partRmsL[npart]);
+        meterAccum.partRmsR[npart] = meter::blockSquares(partR, frames, meterAccum.partRmsR[npart]);
+    }
+}
+
+
+/*
+ * GUI side ballistics, applied to the most recent published block.
+ * Other readers can take the raw blocks straight from 'meters'.
+ */
 void SynthEngine::fetchMeterData()
 {
-    if (!VUready)
+    MeterBlock block;
+    if (!meters.read(block) || block.number + 1 == meterSeen)
         return;
+    meterSeen = block.number + 1;
 
     float fade;
-    float root;
-    int buffsize = VUcopy.values.buffersize;
-
-    root = sqrt(VUcopy.values.vuRmsPeakL / buffsize);
-    VUdata.values.vuRmsPeakL = ((VUdata.values.vuRmsPeakL * 7) + root) / 8;
-    root = sqrt(VUcopy.values.vuRmsPeakR / buffsize);
-    VUdata.values.vuRmsPeakR = ((VUdata.values.vuRmsPeakR * 7) + root) / 8;
+    VUdata.values.vuRmsPeakL = ((VUdata.values.vuRmsPeakL * 7) + block.rmsL) / 8;
+    VUdata.values.vuRmsPeakR = ((VUdata.values.vuRmsPeakR * 7) + block.rmsR) / 8;
 
     fade = VUdata.values.vuOutPeakL * 0.92f;// mult;
     if (fade >= 1.0f) // overload protection
         fade = 0.0f;
-    if (VUcopy.values.vuOutPeakL > fade)
-        VUdata.values.vuOutPeakL = VUcopy.values.vuOutPeakL;
+    if (block.peakL > fade)
+        VUdata.values.vuOutPeakL = block.peakL;
     else
         VUdata.values.vuOutPeakL = fade;
 
     fade = VUdata.values.vuOutPeakR * 0.92f;// mult;
-    if (VUcopy.values.vuOutPeakR > fade)
-        VUdata.values.vuOutPeakR = VUcopy.values.vuOutPeakR;
+    if (block.peakR > fade)
+        VUdata.values.vuOutPeakR = block.peakR;
     else
         VUdata.values.vuOutPeakR = fade;
 
     for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
     {
-        if (VUpeak.values.parts[npart] < 0.0)
+        if (block.partPeakL[npart] < 0.0)
             VUdata.values.parts[npart] = -1.0f;
         else
         {
             fade = VUdata.values.parts[npart];
-            if (VUcopy.values.parts[npart] > fade)
-                VUdata.values.parts[npart] = VUcopy.values.parts[npart];
+            if (block.partPeakL[npart] > fade)
+                VUdata.values.parts[npart] = block.partPeakL[npart];
             else
                 VUdata.values.parts[npart] = fade * 0.85f;
         }
-        if (VUpeak.values.partsR[npart] < 0.0)
+        if (block.partPeakR[npart] < 0.0)
             VUdata.values.partsR[npart] = -1.0f;
         else
         {
             fade = VUdata.values.partsR[npart];
-            if (VUcopy.values.partsR[npart] > fade)
-                VUdata.values.partsR[npart] = VUcopy.values.partsR[npart];
+            if (block.partPeakR[npart] > fade)
+                VUdata.values.partsR[npart] = block.partPeakR[npart];
             else
                 VUdata.values.partsR[npart] = fade * 0.85f;
         }
     }
-    VUready = false;
 }
 
 
@@ -2576,15 +2816,8 @@ void SynthEngine::maybePublishEffectsToGui()
 // Panic! (Clean up all parts and effects)
 void SynthEngine::ShutUp()
 {
-    VUpeak.values.vuOutPeakL = 1e-12f;
-    VUpeak.values.vuOutPeakR = 1e-12f;
-
     for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
-    {
         part[npart]->cleanup();
-        VUpeak.values.parts[npart] = -1.0f;
-        VUpeak.values.partsR[npart] = -1.0f;
-    }
     for (int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
         insefx[nefx]->cleanup();
     for (int nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
@@ -47,6 +47,11 @@
 #include "Interface/MidiDecode.h"
 #include "Interface/Vectors.h"
 #include "Misc/Config.h"
+#include "Misc/PeriodTiming.h"
+#include "Misc/Denormals.h"
+#include "Misc/Meters.h"
+#include "Misc/VoiceManager.h"
+#include "Misc/RenderPool.h"
 #include "globals.h"
 
 class Part;
@@ -92,6 +97,8 @@ class SynthEngine
         SynthEngine& operator=(SynthEngine const&) = delete;
 
         bool Init(uint audiosrate, int audiobufsize);
+        void prepareRealtime();
+        size_t prefault();
         InterfaceAnchor buildGuiAnchor();
         void postBootHook(bool);
 
@@ -140,6 +147,8 @@ class SynthEngine
         void ListVectors(std::list<string>& msg_buf);
         bool SingleVector(std::list<string>& msg_buf, int chan);
         void ListSettings(std::list<string>& msg_buf);
+        void ListStats(std::list<string>& msg_buf);
+        void ListMeters(std::list<string>& msg_buf);
         int SetSystemValue(int type, int value);
         int LoadNumbered(uchar group, uchar entry);
         bool vectorInit(int dHigh, uchar chan, int par);
@@ -200,6 +209,15 @@ class SynthEngine
         int   sent_bufferbytes; //used for variable length runs
         float sent_buffersize_f; //used for variable length runs
         float fixed_sample_step_f;
+        int   controlsize;       // frames per control block for note rendering
+        float control_step_f;    // duration of one control block
+        int   controlOffset;     // where in the period the block being rendered starts
+        void setSentBuffersize(int frames)
+        {
+            sent_buffersize = frames;
+            sent_bufferbytes = frames * sizeof(float);
+            sent_buffersize_f = frames;
+        }
         float TransVolume;
         float Pvolume;
         float ControlStep;
@@ -243,7 +261,7 @@ class SynthEngine
         unique_ptr<fft::Calc> fft;
         TextMsgBuffer& textMsgBuffer;
 
-        // peaks for VU-meters
+        // peaks for VU-meters, smoothed for the GUI by fetchMeterData()
         union VUtransfer{
             struct{
                 float vuOutPeakL{0};
@@ -252,15 +270,34 @@ class SynthEngine
                 float vuRmsPeakR{0};
                 float parts[NUM_MIDI_PARTS];
                 float partsR[NUM_MIDI_PARTS];
-                int buffersize{0};
             } values;
             char bytes [sizeof(values)];
         };
-        VUtransfer VUpeak, VUcopy, VUdata;
+        VUtransfer VUdata;
         uint VUcount;
-        bool VUready;
+        MeterPublisher meters; // raw blocks, readable from any thread
         void fetchMeterData();
 
+        // filled in by the audio backend
+        PeriodTiming periodTiming;
+        std::atomic<bool> flushingDenormals{false}; // as reported by the audio thread
+
+        // parts and effects skipped in the last period, out of those running
+        std::atomic<uint> sleepingParts{0};
+        std::atomic<uint> activeParts{0};
+        std::atomic<uint> sleepingEffects{0};
+        std::atomic<uint> activeEffects{0};
+        void enableFlushToZero();
+
+        // only counted when Runtime.denormalCheck is set
+        DenormalCounter denormals;
+
+        // engine wide voice limit and load ceiling, see Runtime.voiceLimit
+        VoiceManager voices;
+
+        // shares out the notes of a busy part, see Runtime.renderThreads
+        RenderPool renderPool;
+
         using CallbackGuiClosed = std::function<void()>;
         void installGuiClosedCallback(CallbackGuiClosed callback)
         {
@@ -268,9 +305,11 @@ class SynthEngine
         }
         void signalGuiWindowClosed();
         void shutdownGui();
-        int64_t getLFOtime()      const { return LFOtime;}
-        float getSongBeat()       const { return songBeat;}
-        float getMonotonicBeat()  const { return monotonicBeat;}
+        // while notes render, these are moved on to the current control block
+        int64_t getLFOtime()      const { return LFOtime + controlOffset;}
+        float getSongBeat()       const { return songBeat + controlBeats();}
+        float getMonotonicBeat()  const { return monotonicBeat + controlBeats();}
+        float controlBeats()      const { return controlOffset * bpm / (60.0f * samplerate_f); }
         float getBPM()            const { return bpm; }
         bool isBPMAccurate()      const { return bpmAccurate; }
         void setBPMAccurate(bool value) { bpmAccurate = value; }
@@ -293,6 +332,14 @@ class SynthEngine
 
         int keyshift;
 
+        // meter accumulation, audio thread only
+        MeterBlock meterAccum;
+        TruePeak truePeak[(NUM_MIDI_PARTS + 1) * 2];
+        void accumulateMeters(float *mainL, float *mainR, const char *partLocal);
+        uint64_t meterSeen; // blocks taken by fetchMeterData()
+
+        void countSleeping(const char *partLocal, bool *partQuiet);
+
     public:
 #ifdef GUI_FLTK
         ///////////////////TODO 1/2024 : retract direct usage of direct SynthEngine* from UI
@@ -314,8 +361,8 @@ class SynthEngine
 
         RandomGen prng;
     public:
-        float numRandom()   { return prng.numRandom(); }
-        uint32_t randomINT(){ return prng.randomINT(); }   // random number in the range 0...INT_MAX
+        float numRandom()   { return render::random(prng).numRandom(); }
+        uint32_t randomINT(){ return render::random(prng).randomINT(); }   // random number in the range 0...INT_MAX
         void setReproducibleState(int value);
         void swapTestPADtable();
 };
@@ -24,6 +24,9 @@
 
 #include <cmath>
 #include <cassert>
+#include <cstring>
+
+#include "globals.h"
 
 
 namespace synth {
@@ -217,6 +220,61 @@ inline float interpolateAmplitude(float a, float b, int x, int size)
 }
 
 
+/*
+ * Note fades are set in frames rather than in blocks, so they can run on
+ * over several control blocks. The fade-in rises on a half cosine over
+ * 'length' frames with 'pos' carried from one block to the next.
+ */
+inline void fadeIn(float *smpsl, float *smpsr, int& pos, int length, int frames)
+{
+    for (int i = 0; i < frames && pos < length; ++i, ++pos)
+    {
+        float amp = 0.5f - 0.5f * cosf((float)pos / (float)length * PI);
+        smpsl[i] *= amp;
+        if (smpsr)
+            smpsr[i] *= amp;
+    }
+}
+
+
+// about a third of the note's period, to remove the click but keep the
+// sound "punchy"; never more than 'limit' frames
+inline int fadeInLength(float samplerate, float freq, float adjustment, int limit)
+{
+    float length = (freq > 0.0f) ? samplerate / freq / 3.0f : 8.0f;
+    if (length < 8.0f)
+        length = 8.0f;
+    length *= adjustment;
+    return (length < limit) ? int(length) : limit;
+}
+
+
+/*
+ * The fade-out drops 'level' by 'step' every frame, also carried between
+ * blocks. Once it reaches zero the rest of the block is silenced and
+ * false returned, so the note can be killed.
+ */
+inline bool fadeOut(float *smpsl, float *smpsr, float& level, float step, int frames)
+{
+    for (int i = 0; i < frames; ++i)
+    {
+        level -= step;
+        if (level <= 0.0f)
+        {
+            level = 0.0f;
+            memset(smpsl + i, 0, (frames - i) * sizeof(float));
+            if (smpsr)
+                memset(smpsr + i, 0, (frames - i) * sizeof(float));
+            return false;
+        }
+        smpsl[i] *= level;
+        if (smpsr)
+            smpsr[i] *= level;
+    }
+    return true;
+}
+
+
 inline float velF(float velocity, unsigned char scaling)
 {
     if (scaling == 127 || velocity > 0.99f)
@@ -33,11 +33,17 @@
 #include <memory>
 #include <cmath>
 #include <ctime>
+#include <list>
+#include <cstring>
+#include <chrono>
+#include <thread>
 
 #include "Misc/TestSequence.h"
 #include "Misc/SynthEngine.h"
 #include "Misc/CliFuncs.h"
 #include "Misc/Alloc.h"
+#include "Misc/WaveShapeSamples.h"
+#include "DSP/Unison.h"
 #include "CLI/Parser.h"
 
 
@@ -534,5 +540,163 @@ inline bool TestInvoker::doTreatParameter(ParamOp operation, VAL& theParameter,
         return false;
 }
 
+
+
+
+/* Compare the exact and fast waveshapers against a double precision
+ * reference over the full drive range, and time both on one buffer.
+ * Quantisize and Clip are left out, their fast floor gives the same result.
+ */
+inline void benchmarkWaveShapers(std::list<string>& msg, int buffersize)
+{
+    auto reference = [](int type, double x, int drive) -> double
+    {
+        double ws = drive / 127.0;
+        double norm;
+        switch (type)
+        {
+            case 1:
+                ws = pow(10.0, ws * ws * 3.0) - 1.0 + 0.001;
+                return atan(x * ws) / atan(ws);
+            case 2:
+                ws = ws * ws * 32.0 + 0.0001;
+                norm = (ws < 1.0) ? sin(ws) + 0.1 : 1.1;
+                return sin(x * (0.1 + ws - ws * x)) / norm;
+            case 4:
+                ws = ws * ws * ws * 32.0 + 0.0001;
+                norm = (ws < 1.57) ? sin(ws) : 1.0;
+                return sin(x * ws) / norm;
+            case 6:
+                ws = ws * ws * ws * 32.0 + 0.0001;
+                norm = (ws < 1.0) ? sin(ws) : 1.0;
+                return asin(sin(x * ws)) / norm;
+            default: // 14
+                ws = pow(ws, 5.0) * 80.0 + 0.0001;
+                norm = (ws > 10.0) ? 0.5 : 0.5 - 1.0 / (exp(ws) + 1.0);
+                x = clamp(x * ws, -10.0, 10.0);
+                return (0.5 - 1.0 / (exp(x) + 1.0)) / norm;
+        }
+    };
+    const int points = 4096;
+    const int runs = 2000;
+    std::vector<float> buff(std::max(points, buffersize));
+    std::vector<float> source(buffersize);
+    for (int i = 0; i < buffersize; ++i)
+        source[i] = sinf(i * 0.1f);
+    WaveShapeSamples shaper;
+
+    msg.push_back("Waveshaper  max error exact / fast   ns per sample exact / fast");
+    for (int type : {1, 2, 4, 6, 14})
+    {
+        float maxError[2] = {0, 0};
+        size_t nanos[2];
+        for (int fast = 0; fast < 2; ++fast)
+        {
+            for (int drive = 0; drive < 128; ++drive)
+            {
+                for (int i = 0; i < points; ++i)
+                    buff[i] = -1.0f + 2.0f * i / points;
+                shaper.waveShapeSmps(points, buff.data(), type, drive, fast);
+                for (int i = 0; i < points; ++i)
+                {
+                    float error = fabs(buff[i] - reference(type, -1.0f + 2.0f * i / points, drive));
+                    maxError[fast] = std::max(maxError[fast], error);
+                }
+            }
+            StopWatch timer;
+            for (int run = 0; run < runs; ++run)
+            {
+                std::copy(source.begin(), source.end(), buff.begin());
+                timer.start();
+                shaper.waveShapeSmps(buffersize, buff.data(), type, 90, fast);
+                timer.stop();
+            }
+            nanos[fast] = timer.getCumulatedNanos();
+        }
+        auto perSample = [&](size_t ns) { return asCompactString(float(ns) / (float(runs) * buffersize)); };
+        msg.push_back("  type " + asString(type) + "   "
+                      + asString(maxError[0]) + " / " + asString(maxError[1]) + "   "
+                      + perSample(nanos[0]) + " / " + perSample(nanos[1]));
+    }
+}
+
+
+/* Time Unison::process on one buffer for a range of voice counts,
+ * using the same update period and maximum delay as Reverb bandwidth.
+ */
+inline void benchmarkUnison(std::list<string>& msg, SynthEngine& synth)
+{
+    const int runs = 2000;
+    const int buffersize = synth.buffersize;
+    std::vector<float> source(buffersize);
+    std::vector<float> buff(buffersize);
+    for (int i = 0; i < buffersize; ++i)
+        source[i] = sinf(i * 0.1f);
+
+    msg.push_back("Unison voices   ns per sample   ns per sample and voice");
+    for (int size : {1, 2, 4, 8, 16, 32, 50})
+    {
+        Unison unison(buffersize / 4 + 1, 2.0f, &synth);
+        unison.setSize(size);
+        unison.setBaseFrequency(1.0f);
+        unison.setBandwidth(600.0f);
+        StopWatch timer;
+        for (int run = 0; run < runs; ++run)
+        {
+            std::copy(source.begin(), source.end(), buff.begin());
+            timer.start();
+            unison.process(buffersize, buff.data());
+            timer.stop();
+        }
+        float perSample = float(timer.getCumulatedNanos()) / (float(runs) * buffersize);
+        msg.push_back("  " + asString(size) + "   " + asCompactString(perSample)
+                      + "   " + asCompactString(perSample / size));
+    }
+}
+
+
+/* Send 10k CC/s for one second through a MIDI-learn list of its own,
+ * paced as a controller would send them, and time runMidiLearn() on each.
+ * The lines all point at the volume of the last part, but their output is
+ * discarded, so nothing reaches the engine and there is nothing to restore.
+ */
+inline void benchmarkMidiLearn(std::list<string>& msg, SynthEngine& synth)
+{
+    const int rate = 10000;
+    auto learn = std::make_unique<MidiLearn>(synth);
+    learn->discardOutput = true;
+
+    CommandBlock frame;
+    memset(frame.bytes, 0xff, sizeof(frame));
+    frame.data.value   = 0;
+    frame.data.type    = 0;
+    frame.data.source  = TOPLEVEL::action::fromCLI;
+    frame.data.control = PART::control::volume;
+    frame.data.part    = NUM_MIDI_PARTS - 1;
+    frame.data.miscmsg = NO_MSG;
+
+    // own channel lines for CC 1 to 7, and an all channel line for CC 7
+    for (ushort CC = 1; CC <= 7; ++CC)
+        learn->insertTestLine(CC, 0, frame);
+    learn->insertTestLine(7, 16, frame);
+
+    StopWatch timer;
+    auto period = std::chrono::nanoseconds(1000*1000*1000 / rate);
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < rate; ++i)
+    {
+        next += period;
+        std::this_thread::sleep_until(next);
+        timer.start();
+        learn->runMidiLearn(i & 0x7f, ushort(1 + i % 8), 0, false);
+        timer.stop();
+    }
+
+    float perCC = float(timer.getCumulatedNanos()) / rate;
+    msg.push_back("MIDI-learn: 8 lines, " + asString(rate) + " CC in one second");
+    msg.push_back("  ns per CC   " + asCompactString(perCC));
+    msg.push_back("  busy        " + asCompactString(perCC * rate / 1e7f) + "%");
+}
+
 }// namespace test
 #endif /*TESTINVOKER_H*/
@@ -0,0 +1,125 @@
+/*
+    VoiceManager.cpp - Engine wide voice limit and load ceiling
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Misc/VoiceManager.h"
+#include "Misc/SynthEngine.h"
+#include "Misc/Config.h"
+#include "Misc/Part.h"
+
+#include <algorithm>
+
+
+VoiceManager::VoiceManager()
+    : candidates{}
+    , periodStart{0}
+    , lastRenderNs{0}
+    , budgetNs{0}
+    , ceilingNs{0}
+    , overPeriods{0}
+    , voiceCount{0}
+    , voicePeak{0}
+    , lastLoad{0}
+    , limitSteals{0}
+    , loadSteals{0}
+    , dropped{0}
+{ }
+
+
+void VoiceManager::beginPeriod(SynthEngine& synth, const char *partLocal)
+{
+    periodStart = nowNs();
+    Config& runtime = synth.getRuntime();
+    budgetNs = uint64_t(synth.sent_buffersize) * 1000000000 / synth.samplerate;
+    ceilingNs = budgetNs * runtime.loadCeiling / 100;
+
+    uint count = 0;
+    uint fading = 0;
+    for (uint npart = 0; npart < runtime.numAvailableParts; ++npart)
+    {
+        if (partLocal[npart])
+            count += synth.part[npart]->listVoices(candidates + count, fading);
+    }
+    voiceCount.store(count, std::memory_order_relaxed);
+    if (count > voicePeak.load(std::memory_order_relaxed))
+        voicePeak.store(count, std::memory_order_relaxed);
+
+    uint needed = 0;
+    if (runtime.voiceLimit > 0 && count > runtime.voiceLimit)
+        needed = count - runtime.voiceLimit;
+    float excessNs = 0.0f;
+    if (overPeriods >= LOAD_PERIODS && fading == 0)
+    {   // only once the last lot of steals has gone quiet
+        if (lastRenderNs > ceilingNs)
+            excessNs = float(lastRenderNs - ceilingNs);
+    }
+    if (needed == 0 && excessNs <= 0.0f)
+        return;
+
+    uint stolen = stealFor(needed, excessNs, count);
+    if (stolen > needed)
+    {
+        limitSteals.fetch_add(needed, std::memory_order_relaxed);
+        loadSteals.fetch_add(stolen - needed, std::memory_order_relaxed);
+        overPeriods = 0;
+    }
+    else
+        limitSteals.fetch_add(stolen, std::memory_order_relaxed);
+}
+
+
+void VoiceManager::endPeriod()
+{
+    if (budgetNs == 0)
+        return;
+    lastRenderNs = nowNs() - periodStart;
+    lastLoad.store(uint(lastRenderNs * 100 / budgetNs), std::memory_order_relaxed);
+    if (ceilingNs > 0 && lastRenderNs > ceilingNs)
+        ++overPeriods;
+    else
+        overPeriods = 0;
+}
+
+
+// the first 'needed' go whatever, then more until the excess is covered
+uint VoiceManager::stealFor(uint needed, float excessNs, uint count)
+{
+    uint wanted = std::min(count, needed + (excessNs > 0.0f ? LOAD_STEALS : 0));
+    std::partial_sort(candidates, candidates + wanted, candidates + count,
+                      [](VoiceCandidate const& a, VoiceCandidate const& b)
+                      {
+                          if (a.held != b.held)
+                              return !a.held;
+                          if (a.level != b.level)
+                              return a.level < b.level;
+                          return a.age > b.age;
+                      });
+    uint stolen = 0;
+    for (; stolen < wanted; ++stolen)
+    {
+        if (stolen >= needed)
+        {
+            if (excessNs <= 0.0f)
+                break;
+            excessNs -= candidates[stolen].costNs;
+        }
+        candidates[stolen].part->stealNote(candidates[stolen].pos);
+    }
+    return stolen;
+}
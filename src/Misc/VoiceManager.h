@@ -0,0 +1,114 @@
+/*
+    VoiceManager.h - Engine wide voice limit and load ceiling
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef VOICE_MANAGER_H
+#define VOICE_MANAGER_H
+
+#include <sys/types.h>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+#include "globals.h"
+
+class Part;
+class SynthEngine;
+
+
+/*
+ * One sounding note of one part, as seen when deciding what to steal.
+ */
+struct VoiceCandidate
+{
+    Part *part;
+    int pos;        // in the part's note table
+    bool held;      // key down or sustained, as opposed to released
+    float level;    // peak of the last period, after the part volume
+    int age;        // in periods
+    float costNs;   // estimated render time per period
+};
+
+
+/*
+ * Parts limit their own polyphony, but nothing else stops a stack of
+ * busy parts from taking longer than the period and xrunning. At the
+ * start of every period this looks over all the notes of the enabled
+ * parts and, when there are more than the configured voice limit, or
+ * the last few periods took longer than the configured share of the
+ * period, steals the least useful ones: released notes before held
+ * ones, then the quietest, then the oldest. A stolen note fades out
+ * over a few milliseconds rather than being cut.
+ *
+ * Each part measures the time spent on its notes, divided by the number
+ * of notes, as the cost of one voice, so stealing for load knows how
+ * much each note is expected to give back.
+ *
+ * Everything except the statistics belongs to the audio thread.
+ */
+class VoiceManager
+{
+    public:
+        static constexpr uint MAX_VOICES = NUM_MIDI_PARTS * POLYPHONY;
+        static constexpr uint LOAD_STEALS = 4; // at most per period
+        static constexpr uint LOAD_PERIODS = 2; // over the ceiling this many in a row
+
+        VoiceManager();
+        // shall not be copied nor moved
+        VoiceManager(VoiceManager&&)                 = delete;
+        VoiceManager(VoiceManager const&)            = delete;
+        VoiceManager& operator=(VoiceManager&&)      = delete;
+        VoiceManager& operator=(VoiceManager const&) = delete;
+
+        static uint64_t nowNs()
+        {
+            using namespace std::chrono;
+            return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        void beginPeriod(SynthEngine& synth, const char *partLocal);
+        void endPeriod();
+        void noteDropped() { dropped.fetch_add(1, std::memory_order_relaxed); }
+
+        uint voices()         const { return voiceCount.load(std::memory_order_relaxed); }
+        uint peakVoices()     const { return voicePeak.load(std::memory_order_relaxed); }
+        uint loadPercent()    const { return lastLoad.load(std::memory_order_relaxed); }
+        uint64_t stolenForLimit() const { return limitSteals.load(std::memory_order_relaxed); }
+        uint64_t stolenForLoad()  const { return loadSteals.load(std::memory_order_relaxed); }
+        uint64_t droppedNotes()   const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        uint stealFor(uint needed, float excessNs, uint count);
+
+        VoiceCandidate candidates[MAX_VOICES];
+        uint64_t periodStart;
+        uint64_t lastRenderNs;
+        uint64_t budgetNs;
+        uint64_t ceilingNs;
+        uint overPeriods;
+
+        std::atomic<uint> voiceCount;
+        std::atomic<uint> voicePeak;
+        std::atomic<uint> lastLoad;
+        std::atomic<uint64_t> limitSteals;
+        std::atomic<uint64_t> loadSteals;
+        std::atomic<uint64_t> dropped;
+};
+
+#endif /*VOICE_MANAGER_H*/
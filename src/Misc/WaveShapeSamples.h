@@ -26,22 +26,121 @@
 #define WAVESHAPESAMPLES_H
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 #include "Misc/NumericFuncs.h"
+#include "globals.h"
 
 using func::power;
 
 
+/*
+ * Cheap replacements for the libm calls in the waveshapers. They have no
+ * branches or calls, so loops using them are vectorised by the compiler.
+ * Each shaper normalises by the same approximation it shapes with, so
+ * their relative errors cancel at low drive. The shaped result stays
+ * within 1e-5 of a double precision reference, which the CLI
+ * 'test benchshapers' command measures.
+ */
+namespace shaperApprox {
+
+// nearest integer; plain SSE2 has no vector floor, but it does convert
+inline int32_t roundToInt(float x)
+{
+    return int32_t(x + copysignf(0.5f, x));
+}
+
+// the same as floorf for x within the range of int32_t
+inline float floor(float x)
+{
+    float whole = float(int32_t(x));
+    return whole - ((whole > x) ? 1.0f : 0.0f);
+}
+
+// wrap into -PI..PI
+inline float wrapPi(float x)
+{
+    return x - TWOPI * float(roundToInt(x * (1.0f / TWOPI)));
+}
+
+// for x in -PI..PI gives y in -PI/2..PI/2 with sin(y) == sin(x), so also asin(sin(x))
+inline float foldHalfPi(float x)
+{
+    float ax = fabsf(x);
+    return copysignf(std::min(ax, PI - ax), x);
+}
+
+// Taylor series to the 11th power, good for -PI/2..PI/2
+inline float sinHalfPi(float y)
+{
+    float y2 = y * y;
+    return y * (1.0f + y2 * (-1.0f / 6.0f + y2 * (1.0f / 120.0f + y2 * (-1.0f / 5040.0f
+               + y2 * (1.0f / 362880.0f + y2 * (-1.0f / 39916800.0f))))));
+}
+
+inline float sin(float x)
+{
+    return sinHalfPi(foldHalfPi(wrapPi(x)));
+}
+
+// minimax polynomial on 0..1, mirrored for larger values
+inline float atan(float x)
+{
+    float ax = fabsf(x);
+    float inv = 1.0f / std::max(ax, 1.0f);
+    float z = (ax > 1.0f) ? inv : ax;
+    float z2 = z * z;
+    float p = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f
+              + z2 * (0.05265332f + z2 * -0.01172120f)))));
+    p = (ax > 1.0f) ? HALFPI - p : p;
+    return copysignf(p, x);
+}
+
+// e^x for modest x, built from the exponent bits and a short series
+inline float exp(float x)
+{
+    float t = x * 1.44269504f; // to base 2
+    int32_t whole = roundToInt(t);
+    float f = (t - float(whole)) * 0.69314718f; // back to base e, now within +-0.35
+    float p = 1.0f + f * (1.0f + f * (0.5f + f * (1.0f / 6.0f + f * (1.0f / 24.0f
+              + f * (1.0f / 120.0f + f * (1.0f / 720.0f))))));
+    int32_t bits = (whole + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+/*
+ * 0.5 - 1 / (e^x + 1), which is tanh(x / 2) / 2. Near zero the two terms
+ * cancel and leave mostly rounding error, so small x uses the series.
+ */
+inline float sigmoid(float x)
+{
+    float x2 = x * x;
+    float series = x * (0.25f + x2 * (-1.0f / 48.0f + x2 * (1.0f / 480.0f + x2 * (-17.0f / 80640.0f))));
+    float full = 0.5f - 1.0f / (exp(x) + 1.0f);
+    return (fabsf(x) < 0.5f) ? series : full;
+}
+
+} // namespace shaperApprox
+
+
 class WaveShapeSamples
 {
     public:
         WaveShapeSamples() { }
         ~WaveShapeSamples() { }
-        void waveShapeSmps(int n, float *smps, unsigned char type, unsigned char drive);
+        void waveShapeSmps(int n, float *smps, unsigned char type, unsigned char drive, bool fast = false);
 };
 
-// Waveshape, used by OscilGen::waveshape and Distorsion::process
-inline void WaveShapeSamples::waveShapeSmps(int n, float *smps, unsigned char type, unsigned char drive)
+/*
+ * Waveshape, used by OscilGen::waveshape and Distorsion::process
+ * 'fast' swaps the transcendental functions for the approximations above,
+ * the other types are the same either way.
+ */
+inline void WaveShapeSamples::waveShapeSmps(int n, float *smps, unsigned char type, unsigned char drive, bool fast)
 {
     int i;
     float ws = drive / 127.0f;
@@ -51,17 +150,41 @@ inline void WaveShapeSamples::waveShapeSmps(int n, float *smps, unsigned char ty
     {
         case 1:
             ws = powf( 10.0f, ws * ws * 3.0f) - 1.0f + 0.001f; // Arctangent
+            if (fast)
+            {
+                tmpv = 1.0f / shaperApprox::atan(ws);
+                for (i = 0; i < n; ++i)
+                    smps[i] = shaperApprox::atan(smps[i] * ws) * tmpv;
+                break;
+            }
             for (i = 0; i < n; ++i)
                 smps[i] = atanf(smps[i] * ws) / atanf(ws);
             break;
         case 2:
             ws = ws * ws * 32.0f + 0.0001f; // Asymmetric
             tmpv = (ws < 1.0f) ? sinf(ws) + 0.1f : 1.1f;
+            if (fast)
+            {
+                tmpv = 1.0f / tmpv;
+                for (i = 0; i < n; ++i)
+                    smps[i] = shaperApprox::sin(smps[i] * (0.1f + ws - ws * smps[i])) * tmpv;
+                break;
+            }
             for (i = 0; i < n; ++i)
                 smps[i] = sinf(smps[i] * (0.1f + ws - ws * smps[i])) / tmpv;
             break;
         case 3:
             ws = ws * ws * ws * 20.0f + 0.0001f; // Pow
+            if (fast)
+            {
+                tmpv = (ws < 1.0f) ? 1.0f / ws : 1.0f;
+                for (i = 0; i < n; ++i)
+                {
+                    float tmp = smps[i] * ws;
+                    smps[i] = (fabsf(tmp) < 1.0f) ? (tmp - tmp * tmp * tmp) * 3.0f * tmpv : 0.0f;
+                }
+                break;
+            }
             for (i = 0; i < n; ++i)
             {
                 smps[i] *= ws;
@@ -78,17 +201,37 @@ inline void WaveShapeSamples::waveShapeSmps(int n, float *smps, unsigned char ty
         case 4:
             ws = ws * ws * ws * 32.0f + 0.0001f; // Sine
             tmpv = (ws < 1.57f) ? sinf(ws) : 1.0f;
+            if (fast)
+            {
+                tmpv = 1.0f / tmpv;
+                for (i = 0; i < n; ++i)
+                    smps[i] = shaperApprox::sin(smps[i] * ws) * tmpv;
+                break;
+            }
             for (i = 0; i < n; ++i)
                 smps[i] = sinf(smps[i] * ws) / tmpv;
             break;
         case 5:
             ws = ws * ws + 0.000001f; // Quantisize
+            if (fast)
+            {
+                for (i = 0; i < n; ++i)
+                    smps[i] = shaperApprox::floor(smps[i] / ws + 0.5f) * ws;
+                break;
+            }
             for (i = 0; i < n; ++i)
                 smps[i] = floorf(smps[i] / ws + 0.5f) * ws;
             break;
         case 6:
             ws = ws * ws * ws * 32.0f + 0.0001f; // Zigzag
             tmpv = (ws < 1.0f) ? sinf(ws) : 1.0f;
+            if (fast)
+            {// asin(sin(x)) is just a triangle wave
+                tmpv = 1.0f / tmpv;
+                for (i = 0; i < n; ++i)
+                    smps[i] = shaperApprox::foldHalfPi(shaperApprox::wrapPi(smps[i] * ws)) * tmpv;
+                break;
+            }
             for (i = 0; i < n; ++i)
                 smps[i] = asinf(sinf(smps[i] * ws)) / tmpv;
             break;
@@ -140,6 +283,15 @@ inline void WaveShapeSamples::waveShapeSmps(int n, float *smps, unsigned char ty
             break;
         case 11:
             ws = power<5>(ws * ws * 1.0f) - 1.0f; // Clip
+            if (fast)
+            {
+                for (i = 0; i < n; ++i)
+                {
+                    float tmp = smps[i] * (ws + 0.5f) * 0.9999f;
+                    smps[i] = tmp - shaperApprox::floor(0.5f + tmp);
+                }
+                break;
+            }
             for (i = 0; i < n; ++i)
                 smps[i] = smps[i] * (ws + 0.5f) * 0.9999f - floorf(0.5f + smps[i] * (ws + 0.5f) * 0.9999f);
             break;
@@ -172,6 +324,13 @@ inline void WaveShapeSamples::waveShapeSmps(int n, float *smps, unsigned char ty
         case 14:
             ws = powf(ws, 5.0f) * 80.0f + 0.0001f; // sigmoid
             tmpv = (ws > 10.0f) ? 0.5f : 0.5f - 1.0f / (expf(ws) + 1.0f);
+            if (fast)
+            {
+                tmpv = 1.0f / ((ws > 10.0f) ? 0.5f : shaperApprox::sigmoid(ws));
+                for (i = 0; i < n; ++i)
+                    smps[i] = shaperApprox::sigmoid(std::clamp(smps[i] * ws, -10.0f, 10.0f)) * tmpv;
+                break;
+            }
             for (i = 0; i < n; ++i)
             {
                 float tmp = smps[i] * ws;
@@ -46,13 +46,18 @@ using util::unConst;
 
 AlsaEngine::AlsaEngine(SynthEngine& _synth, shared_ptr<BeatTracker> beat)
     : MusicIO{_synth, move(beat)}
-    , little_endian{runtime().isLittleEndian}
     , card_endian{false}
     , card_signed{true}
+    , card_float{false}
     , card_chans{2}   // got to start somewhere}
     , card_bits{0}
-    , pcmWrite{nullptr}
+    , card_bytes{0}
+    , mmapAccess{false}
+    , dither{false}
+    , ditherSeed{0x12345678}
     , interleaved{}
+    , rwAreas{}
+    , convertBuff{}
     , audio{}
     , midi{}
 {
@@ -73,6 +78,8 @@ bool AlsaEngine::openAudio()
     audio.period_size = runtime().buffersize;
     audio.period_count = 2;
     audio.buffer_size = audio.period_size * audio.period_count;
+    card_chans = runtime().alsaChannels;
+    dither = runtime().alsaDither;
     if (not alsaBad(snd_pcm_open(&audio.handle, audio.device.c_str(),
                                  SND_PCM_STREAM_PLAYBACK, SND_PCM_NO_AUTO_CHANNELS),
                                  "failed to open alsa audio device:" + audio.device))
@@ -81,8 +88,9 @@ bool AlsaEngine::openAudio()
                 if (prepSwparams())
                 {
                     prepBuffers();
-                    // Buffers for interleaved audio only used by AlsaEngine
-                    interleaved.reset(new int[getBuffersize() * card_chans]{0});
+                    prepAreas();
+                    synth.periodTiming.reset();
+                    synth.periodTiming.setBudget(audio.period_size, audio.samplerate);
                     return true;
                 }
     // if anything did not go well...
@@ -156,6 +164,7 @@ bool AlsaEngine::openMidi()
     snd_seq_client_info_event_filter_add(seq_info, SND_SEQ_EVENT_RESET);
     snd_seq_client_info_event_filter_add(seq_info, SND_SEQ_EVENT_SONGPOS);
     snd_seq_client_info_event_filter_add(seq_info, SND_SEQ_EVENT_CLOCK);
+    snd_seq_client_info_event_filter_add(seq_info, SND_SEQ_EVENT_SYSEX);
     snd_seq_client_info_event_filter_add(seq_info, SND_SEQ_EVENT_PORT_SUBSCRIBED);
     snd_seq_client_info_event_filter_add(seq_info, SND_SEQ_EVENT_PORT_UNSUBSCRIBED);
     if (0 > snd_seq_set_client_info(midi.handle, seq_info))
@@ -300,18 +309,22 @@ bool AlsaEngine::prepHwparams()
     {
         snd_pcm_format_t card_format;
         int card_bits;
+        uint card_bytes;
         bool card_endian;
         bool card_signed;
+        bool card_float;
     }
     card_formats[] =
     {
-        {SND_PCM_FORMAT_S32_LE, 32, true, true},
-        {SND_PCM_FORMAT_S32_BE, 32, false, true},
-        {SND_PCM_FORMAT_S24_3LE, 24, true, true},
-        {SND_PCM_FORMAT_S24_3BE, 24, false, true},
-        {SND_PCM_FORMAT_S16_LE, 16, true, true},
-        {SND_PCM_FORMAT_S16_BE, 16, false, true},
-        {SND_PCM_FORMAT_UNKNOWN, 0, false, true}
+        {SND_PCM_FORMAT_S32_LE, 32, 4, true, true, false},
+        {SND_PCM_FORMAT_S32_BE, 32, 4, false, true, false},
+        {SND_PCM_FORMAT_FLOAT_LE, 32, 4, true, true, true},
+        {SND_PCM_FORMAT_FLOAT_BE, 32, 4, false, true, true},
+        {SND_PCM_FORMAT_S24_3LE, 24, 3, true, true, false},
+        {SND_PCM_FORMAT_S24_3BE, 24, 3, false, true, false},
+        {SND_PCM_FORMAT_S16_LE, 16, 2, true, true, false},
+        {SND_PCM_FORMAT_S16_BE, 16, 2, false, true, false},
+        {SND_PCM_FORMAT_UNKNOWN, 0, 0, false, true, false}
     };
     int formidx;
     string formattxt;
@@ -330,14 +343,14 @@ bool AlsaEngine::prepHwparams()
         return false;
     if (!alsaBad(snd_pcm_hw_params_set_access(audio.handle, hwparams, axs),
                  "alsa audio mmap not possible"))
-        pcmWrite = &snd_pcm_mmap_writei;
+        mmapAccess = true;
     else
     {
         axs = SND_PCM_ACCESS_RW_INTERLEAVED;
         if (alsaBad(snd_pcm_hw_params_set_access(audio.handle, hwparams, axs),
                      "alsa audio failed to set access, both mmap and rw failed"))
             return false;
-        pcmWrite = &snd_pcm_writei;
+        mmapAccess = false;
     }
 
     formidx = 0;
@@ -351,17 +364,21 @@ bool AlsaEngine::prepHwparams()
         }
     }
     card_bits = card_formats[formidx].card_bits;
+    card_bytes = card_formats[formidx].card_bytes;
     card_endian = card_formats[formidx].card_endian;
     card_signed = card_formats[formidx].card_signed;
+    card_float = card_formats[formidx].card_float;
 
-    if (little_endian)
+    if (runtime().isLittleEndian)
         formattxt += "Little";
     else
         formattxt += "Big";
 
     runtime().Log("March is " + formattxt + " Endian", _SYS_::LogNotSerious);
 
-    if (card_signed)
+    if (card_float)
+        formattxt = "Float ";
+    else if (card_signed)
         formattxt = "Signed ";
     else
         formattxt = "Unsigned ";
@@ -398,7 +415,10 @@ bool AlsaEngine::prepHwparams()
                 NULL), "failed to get period size"))
         return false;
 
-    runtime().Log("Card Format is " + formattxt + " Endian " + asString(card_bits) +" Bit " + asString(card_chans) + " Channel" , 2);
+    runtime().Log("Card Format is " + formattxt + " Endian " + asString(card_bits) +" Bit " + asString(card_chans) + " Channel"
+                + (mmapAccess ? " mmap" : ""), 2);
+    // any channels beyond the main pair carry part direct outputs
+    runtime().isMultiFeed = (card_chans > 2);
     if (ask_buffersize != audio.period_size)
     {
         runtime().Log("Asked for buffersize " + asString(ask_buffersize, 2)
@@ -409,73 +429,202 @@ bool AlsaEngine::prepHwparams()
 }
 
 
-bool AlsaEngine::prepSwparams()
+// realTime only uses the audio thread safe error report
+bool AlsaEngine::prepSwparams(bool realTime)
 {
+    auto bad = [&](int op_result, const char* err_msg)
+    {
+        return realTime ? alsaBadRT(op_result, err_msg) : alsaBad(op_result, err_msg);
+    };
     snd_pcm_sw_params_t *swparams;
     snd_pcm_sw_params_alloca(&swparams); // allocated on stack and automatically freed when leaving this scope
 	snd_pcm_uframes_t boundary;
-	return (not alsaBad(snd_pcm_sw_params_current(audio.handle, swparams),
-                        "alsa audio failed to get swparams"))
-       and (not alsaBad(snd_pcm_sw_params_get_boundary(swparams, &boundary),
-                        "alsa audio failed to get boundary"))
-       and (not alsaBad(snd_pcm_sw_params_set_start_threshold(audio.handle
-                                                             ,swparams
-                                                             ,boundary + 1)
-                       ,"failed to set start threshold"))  // explicit start, not auto start
-       and (not alsaBad(snd_pcm_sw_params_set_stop_threshold(audio.handle
-                                                            ,swparams
-                                                            ,boundary)
-                       ,"alsa audio failed to set stop threshold"))
-       and (not alsaBad(snd_pcm_sw_params(audio.handle, swparams)
-                       ,"alsa audio failed to set software parameters"))
+	return (not bad(snd_pcm_sw_params_current(audio.handle, swparams),
+                    "alsa audio failed to get swparams"))
+       and (not bad(snd_pcm_sw_params_get_boundary(swparams, &boundary),
+                    "alsa audio failed to get boundary"))
+       and (not bad(snd_pcm_sw_params_set_start_threshold(audio.handle
+                                                         ,swparams
+                                                         ,boundary + 1)
+                   ,"failed to set start threshold"))  // explicit start, not auto start
+       and (not bad(snd_pcm_sw_params_set_stop_threshold(audio.handle
+                                                        ,swparams
+                                                        ,boundary)
+                   ,"alsa audio failed to set stop threshold"))
+       and (not bad(snd_pcm_sw_params(audio.handle, swparams)
+                   ,"alsa audio failed to set software parameters"))
          ;
 }
 
 
-void AlsaEngine::Interleave(int buffersize)
+void AlsaEngine::prepAreas()
 {
-    size_t idx = 0;
-    bool byte_swap = (little_endian != card_endian);
-    ushort tmp16a, tmp16b;
-    size_t chans;
-    uint tmp32a, tmp32b;
-    uint shift = 0x78000000;
-    if (card_bits == 24)
-        shift = 0x780000;
-
-    if (card_bits == 16)
-    {
-        chans = card_chans / 2; // because we're pairing them on a single integer
-        for (int frame = 0; frame < buffersize; ++frame)
+    size_t frames = getBuffersize();
+    convertBuff.reset(frames);
+    interleaved.reset(new char[frames * card_chans * card_bytes]{0});
+    rwAreas.reset(new snd_pcm_channel_area_t[card_chans]);
+    for (uint chan = 0; chan < card_chans; ++chan)
+    {
+        rwAreas[chan].addr = interleaved.get();
+        rwAreas[chan].first = chan * card_bytes * 8;
+        rwAreas[chan].step = card_chans * card_bytes * 8;
+    }
+}
+
+
+namespace { // sample format conversion kernels
+
+    // The loops below are kept free of branches and aliasing
+    // so the compiler can vectorise them.
+
+    void scaleSaturate(float const* __restrict src, float* __restrict dst,
+                       uint frames, float scale, float limit)
+    {
+        for (uint i = 0; i < frames; ++i)
         {
-            tmp16a = ushort(lrint( zynLeft[NUM_MIDI_PARTS][frame] * 0x7800));
-            tmp16b = ushort(lrint(zynRight[NUM_MIDI_PARTS][frame] * 0x7800));
-            if (byte_swap)
-            {
-                tmp16a = (short int) ((tmp16a >> 8) | (tmp16a << 8));        //TODO shouldn't that be a cast to unsigned short? IIRC, the assignment promotes to unsigned
-                tmp16b = ((tmp16b >> 8) | (tmp16b << 8));
-            }
-            interleaved[idx] = tmp16a | int(tmp16b << 16);
-            idx += chans;
+            float val = src[i] * scale;
+            val = val > limit ? limit : val;
+            dst[i] = val < -limit ? -limit : val;
+        }
+    }
+
+    // as above, with triangular PDF noise of +-1 LSB added before saturation
+    void ditherSaturate(float const* __restrict src, float* __restrict dst,
+                        uint frames, float scale, float limit, uint32_t& seed)
+    {
+        const float norm = 1.0f / 4294967296.0f;
+        uint32_t rnd = seed;
+        for (uint i = 0; i < frames; ++i)
+        {
+            rnd = rnd * 1664525u + 1013904223u;
+            float first = rnd * norm;
+            rnd = rnd * 1664525u + 1013904223u;
+            float second = rnd * norm;
+            float val = src[i] * scale + (first - second);
+            val = val > limit ? limit : val;
+            dst[i] = val < -limit ? -limit : val;
+        }
+        seed = rnd;
+    }
+
+    inline int32_t roundInt(float val)
+    {
+        return int32_t(val + (val < 0.0f ? -0.5f : 0.5f));
+    }
+
+    template<uint BYTES, bool LITTLE>
+    void packInt(float const* __restrict src, char* __restrict dest, uint step, uint frames)
+    {
+        for (uint i = 0; i < frames; ++i, dest += step)
+        {
+            uint32_t val = uint32_t(roundInt(src[i]));
+            for (uint b = 0; b < BYTES; ++b)
+                dest[LITTLE ? b : BYTES - 1 - b] = char(val >> (8 * b));
+        }
+    }
+
+    template<bool LITTLE>
+    void packFloat(float const* __restrict src, char* __restrict dest, uint step, uint frames)
+    {
+        for (uint i = 0; i < frames; ++i, dest += step)
+        {
+            uint32_t val;
+            memcpy(&val, &src[i], sizeof(val));
+            for (uint b = 0; b < 4; ++b)
+                dest[LITTLE ? b : 3 - b] = char(val >> (8 * b));
         }
     }
+}
+
+
+/*
+ * The integer scaling keeps the small headroom yoshimi has always used,
+ * while the limits give hard saturation rather than wrap-around.
+ */
+void AlsaEngine::convertChannel(float const* src, char* dest, uint step, uint frames)
+{
+    float* buff = convertBuff.get();
+    float scale;
+    float limit;
+    switch (card_bits)
+    {
+        case 16:
+            scale = 0x7800;
+            limit = 0x7fff;
+            break;
+        case 24:
+            scale = 0x780000;
+            limit = 0x7fffff;
+            break;
+        default:
+            scale = card_float ? (0x7800 / 32768.0f) : 0x78000000;
+            limit = card_float ? 1.0f : 2147483520.0f; // largest float below 2^31
+            break;
+    }
+    if (dither && !card_float && card_bits < 32)
+        ditherSaturate(src, buff, frames, scale, limit, ditherSeed);
     else
+        scaleSaturate(src, buff, frames, scale, limit);
+
+    if (card_float)
+    {
+        if (card_endian)
+            packFloat<true>(buff, dest, step, frames);
+        else
+            packFloat<false>(buff, dest, step, frames);
+        return;
+    }
+    switch (card_bytes)
+    {
+        case 2:
+            if (card_endian)
+                packInt<2, true>(buff, dest, step, frames);
+            else
+                packInt<2, false>(buff, dest, step, frames);
+            break;
+        case 3:
+            if (card_endian)
+                packInt<3, true>(buff, dest, step, frames);
+            else
+                packInt<3, false>(buff, dest, step, frames);
+            break;
+        default:
+            if (card_endian)
+                packInt<4, true>(buff, dest, step, frames);
+            else
+                packInt<4, false>(buff, dest, step, frames);
+            break;
+    }
+}
+
+
+/*
+ * Channels 0 and 1 are the main mix, then each further pair
+ * is the direct output of the corresponding part.
+ */
+void AlsaEngine::Interleave(const snd_pcm_channel_area_t* areas, snd_pcm_uframes_t offset,
+                            uint from, uint frames)
+{
+    uint currentmax = runtime().numAvailableParts;
+    for (uint chan = 0; chan < card_chans; ++chan)
     {
-        chans = card_chans;
-        for (int frame = 0; frame < buffersize; ++frame)
+        char* dest = (char*)areas[chan].addr + (areas[chan].first + offset * areas[chan].step) / 8;
+        uint step = areas[chan].step / 8;
+        float const* src = nullptr;
+        if (chan < 2)
+            src = (chan == 0) ? zynLeft[NUM_MIDI_PARTS] : zynRight[NUM_MIDI_PARTS];
+        else
         {
-            tmp32a = uint(lrint( zynLeft[NUM_MIDI_PARTS][frame] * shift));
-            tmp32b = uint(lrint(zynRight[NUM_MIDI_PARTS][frame] * shift));
-            // how should we do an endian swap for 24 bit, 3 byte?
-            // is it really the same, just swapping the 'unused' byte?
-            if (byte_swap)
-            {
-                tmp32a = (tmp32a >> 24) | ((tmp32a << 8) & 0x00FF0000) | ((tmp32a >> 8) & 0x0000FF00) | (tmp32a << 24);
-                tmp32b = (tmp32b >> 24) | ((tmp32b << 8) & 0x00FF0000) | ((tmp32b >> 8) & 0x0000FF00) | (tmp32b << 24);
-            }
-            interleaved[idx] = int(tmp32a);
-            interleaved[idx + 1] = int(tmp32b);
-            idx += chans;
+            uint npart = (chan - 2) / 2;
+            if (npart < currentmax && (synth.part[npart]->Paudiodest & 2))
+                src = (chan & 1) ? zynRight[npart] : zynLeft[npart];
+        }
+        if (src)
+            convertChannel(src + from, dest, step, frames);
+        else
+        {
+            for (uint i = 0; i < frames; ++i, dest += step)
+                memset(dest, 0, card_bytes);
         }
     }
 }
@@ -489,7 +638,10 @@ void* AlsaEngine::_AudioThread(void* arg)
 
 void* AlsaEngine::AudioThread()
 {
-    alsaBad(snd_pcm_start(audio.handle), "alsa audio pcm start failed");
+    prefaultStack();
+    synth.enableFlushToZero();
+    rtlog::audioThread = true;
+    alsaBadRT(snd_pcm_start(audio.handle), "alsa audio pcm start failed");
     while (runtime().runSynth.load(std::memory_order_relaxed))  // read the atomic flag as we happen to see it, without forcing any sync
     {
         BeatTracker::BeatValues beats(beatTracker->getBeatValues());
@@ -507,30 +659,36 @@ void* AlsaEngine::AudioThread()
                         break;
                     /* falls through */
                 case SND_PCM_STATE_SETUP:
-                    if (alsaBad(snd_pcm_prepare(audio.handle),
-                                "alsa audio pcm prepare failed"))
+                    if (alsaBadRT(snd_pcm_prepare(audio.handle),
+                                  "alsa audio pcm prepare failed"))
                         break;
                     /* falls through */
                 case SND_PCM_STATE_PREPARED:
-                    alsaBad(snd_pcm_start(audio.handle), "pcm start failed");
+                    alsaBadRT(snd_pcm_start(audio.handle), "pcm start failed");
                     break;
 
                 default:
-                    runtime().Log("Alsa AudioThread, weird SND_PCM_STATE: "
-                                 + asString(audio.pcm_state));
+                    runtime().rtLog.post(rtlog::alsaWeirdState, long(audio.pcm_state));
                     break;
             }
             audio.pcm_state = snd_pcm_state(audio.handle);
         }
         if (audio.pcm_state == SND_PCM_STATE_RUNNING)
         {
+            uint64_t start = PeriodTiming::nowUs();
             getAudio();
+            synth.periodTiming.record(PeriodTiming::nowUs() - start);
             int alsa_buff = getBuffersize();
-            Interleave(alsa_buff);
-            Write(alsa_buff);
+            if (mmapAccess)
+                mmapWrite(alsa_buff);
+            else
+            {
+                Interleave(rwAreas.get(), 0, 0, alsa_buff);
+                Write(alsa_buff);
+            }
         }
         else
-            runtime().Log("Audio pcm still not running");
+            runtime().rtLog.post(rtlog::alsaNotRunning);
     }
     return NULL;
 }
@@ -539,11 +697,11 @@ void* AlsaEngine::AudioThread()
 void AlsaEngine::Write(snd_pcm_uframes_t towrite)
 {
     snd_pcm_sframes_t wrote = 0;
-    int *data = interleaved.get();
+    char *data = interleaved.get();
 
     while (towrite > 0)
     {
-        wrote = pcmWrite(audio.handle, data, towrite);
+        wrote = snd_pcm_writei(audio.handle, data, towrite);
         if (wrote >= 0)
         {
             if ((snd_pcm_uframes_t)wrote < towrite || wrote == -EAGAIN)
@@ -551,35 +709,89 @@ void AlsaEngine::Write(snd_pcm_uframes_t towrite)
             if (wrote > 0)
             {
                 towrite -= wrote;
-                data += wrote * card_chans;
+                data += wrote * card_chans * card_bytes;
             }
         }
-        else // (wrote < 0)
-        {
-            switch (wrote)
-            {
-                case -EBADFD:
-                    alsaBad(-EBADFD, "alsa audio unfit for writing");
-                    break;
+        else if (!writeFailed(wrote))
+            return;
+    }
+}
 
-                case -EPIPE:
-                    xrunRecover();
-                    break;
 
-                case -ESTRPIPE:
-                    Recover(wrote);
-                    break;
+/*
+ * Converts straight into the card's ring buffer,
+ * so there is no intermediate interleaved copy.
+ */
+void AlsaEngine::mmapWrite(snd_pcm_uframes_t towrite)
+{
+    uint from = 0;
+    while (towrite > 0)
+    {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(audio.handle);
+        if (avail >= 0 && snd_pcm_uframes_t(avail) < towrite)
+        {
+            snd_pcm_wait(audio.handle, 666);
+            avail = snd_pcm_avail_update(audio.handle);
+        }
+        if (avail < 0)
+        {
+            if (!writeFailed(avail))
+                return;
+            continue;
+        }
+        if (avail == 0)
+            continue;
 
-                default:
-                    alsaBad(wrote, "alsa audio, snd_pcm_writei ==> weird state");
-                    break;
-            }
-            wrote = 0;
+        const snd_pcm_channel_area_t* areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = towrite;
+        int err = snd_pcm_mmap_begin(audio.handle, &areas, &offset, &frames);
+        if (err < 0)
+        {
+            if (!writeFailed(err))
+                return;
+            continue;
         }
+        Interleave(areas, offset, from, frames);
+        snd_pcm_sframes_t wrote = snd_pcm_mmap_commit(audio.handle, offset, frames);
+        if (wrote < 0)
+        {
+            if (!writeFailed(wrote))
+                return;
+            continue;
+        }
+        from += wrote;
+        towrite -= wrote;
     }
 }
 
 
+// returns true if it's worth trying to write again
+bool AlsaEngine::writeFailed(snd_pcm_sframes_t err)
+{
+    switch (err)
+    {
+        case -EBADFD:
+            alsaBadRT(-EBADFD, "alsa audio unfit for writing");
+            break;
+
+        case -EPIPE:
+            return xrunRecover();
+
+        case -ESTRPIPE:
+            return Recover(err);
+
+        case -EAGAIN:
+            return true;
+
+        default:
+            alsaBadRT(err, "alsa audio, pcm write ==> weird state");
+            break;
+    }
+    return false;
+}
+
+
 bool AlsaEngine::Recover(int err)
 {
     if (err > 0)
@@ -592,14 +804,14 @@ bool AlsaEngine::Recover(int err)
             break;
 
         case -ESTRPIPE:
-            if (!alsaBad(snd_pcm_prepare(audio.handle),
-                         "Error, AlsaEngine failed to recover from suspend"))
+            if (!alsaBadRT(snd_pcm_prepare(audio.handle),
+                           "Error, AlsaEngine failed to recover from suspend"))
                 isgood = true;
             break;
 
         case -EPIPE:
-            if (!alsaBad(snd_pcm_prepare(audio.handle),
-                         "Error, AlsaEngine failed to recover from underrun"))
+            if (!alsaBadRT(snd_pcm_prepare(audio.handle),
+                           "Error, AlsaEngine failed to recover from underrun"))
                 isgood = true;
             break;
 
@@ -615,16 +827,80 @@ bool AlsaEngine::xrunRecover()
     bool isgood = false;
     if (audio.handle != NULL)
     {
-        if (!alsaBad(snd_pcm_drop(audio.handle), "pcm drop failed"))
-            if (!alsaBad(snd_pcm_prepare(audio.handle), "pcm prepare failed"))
+        synth.periodTiming.xrun();
+        if (!alsaBadRT(snd_pcm_drop(audio.handle), "pcm drop failed"))
+        {
+            if (xrunsClustered() && runtime().alsaAdaptive)
+                growBuffer();
+            if (!alsaBadRT(snd_pcm_prepare(audio.handle), "pcm prepare failed"))
                 isgood = true;
-        runtime().Log("Alsa xrun recovery "
-                     + (isgood? string{"good"} : string{"not good"}));
+        }
+        runtime().rtLog.post(rtlog::alsaXrunRecovery, isgood ? "good" : "not good");
     }
     return isgood;
 }
 
 
+bool AlsaEngine::xrunsClustered()
+{
+    uint64_t now = PeriodTiming::nowUs();
+    audio.xrunTimes[audio.xrunPos] = now;
+    audio.xrunPos = (audio.xrunPos + 1) % ALSA_XRUN_CLUSTER;
+    // the next slot holds the oldest of the recent xruns
+    uint64_t oldest = audio.xrunTimes[audio.xrunPos];
+    return oldest != 0 && (now - oldest) < ALSA_XRUN_WINDOW_US;
+}
+
+
+/*
+ * Only the number of periods can change on the fly. Everything else is
+ * taken as it stands from the installed setup, so the conversion areas
+ * and the card format still match it and needn't be rebuilt. Called from
+ * the audio thread with the pcm stopped, so nothing here logs directly.
+ */
+bool AlsaEngine::growBuffer()
+{
+    if (audio.period_count >= ALSA_MAX_PERIODS)
+        return false;
+    for (auto& time : audio.xrunTimes)
+        time = 0;
+
+    snd_pcm_hw_params_t *current;
+    snd_pcm_hw_params_t *hwparams;
+    snd_pcm_hw_params_alloca(&current);
+    snd_pcm_hw_params_alloca(&hwparams);
+    snd_pcm_access_t axs;
+    snd_pcm_format_t format;
+    uint rate;
+    uint periods = audio.period_count + 1;
+    snd_pcm_uframes_t buffer_size;
+    bool isgood =
+           !alsaBadRT(snd_pcm_hw_params_current(audio.handle, current), "failed to get hardware parameters")
+        && !alsaBadRT(snd_pcm_hw_params_get_access(current, &axs), "failed to get access")
+        && !alsaBadRT(snd_pcm_hw_params_get_format(current, &format), "failed to get format")
+        && !alsaBadRT(snd_pcm_hw_params_get_rate(current, &rate, NULL), "failed to get sample rate")
+        && !alsaBadRT(snd_pcm_hw_params_any(audio.handle, hwparams), "no playback configurations available")
+        && !alsaBadRT(snd_pcm_hw_params_set_access(audio.handle, hwparams, axs), "failed to keep access")
+        && !alsaBadRT(snd_pcm_hw_params_set_format(audio.handle, hwparams, format), "failed to keep format")
+        && !alsaBadRT(snd_pcm_hw_params_set_channels(audio.handle, hwparams, card_chans), "failed to keep channels")
+        && !alsaBadRT(snd_pcm_hw_params_set_rate(audio.handle, hwparams, rate, 0), "failed to keep sample rate")
+        && !alsaBadRT(snd_pcm_hw_params_set_period_size(audio.handle, hwparams, audio.period_size, 0), "failed to keep period size")
+        && !alsaBadRT(snd_pcm_hw_params_set_periods(audio.handle, hwparams, periods, 0), "no more periods")
+        && !alsaBadRT(snd_pcm_hw_params(audio.handle, hwparams), "failed to set hardware parameters")
+        && !alsaBadRT(snd_pcm_hw_params_get_buffer_size(hwparams, &buffer_size), "failed to get buffer size");
+    // installing the hardware setup puts the software one back to defaults
+    if (!isgood || !prepSwparams(true))
+    {
+        runtime().rtLog.post(rtlog::alsaGrowFailed);
+        return false;
+    }
+    audio.period_count = periods;
+    audio.buffer_size = buffer_size;
+    runtime().rtLog.post(rtlog::alsaPeriodsRaised, long(audio.period_count));
+    return true;
+}
+
+
 bool AlsaEngine::Start()
 {
     if (NULL != midi.handle && !runtime().startThread(&midi.pThread, _MidiThread,
@@ -773,6 +1049,11 @@ void AlsaEngine::handleMidiEvents(uint64_t clock)
                 par2 = par & 0x7f; // let last one through
                 break;
 
+            case SND_SEQ_EVENT_SYSEX: // long ones can come in several pieces
+                handleSysex(static_cast<const uchar*>(event->data.ext.ptr), event->data.ext.len);
+                sendit = false;
+                break;
+
             case SND_SEQ_EVENT_RESET: // reset to power-on state
                 par0 = 0xff;
                 break;
@@ -842,6 +1123,16 @@ bool AlsaEngine::alsaBad(int op_result, string err_msg)
     return isbad;
 }
 
+
+// as above, for use in the audio thread (err_msg must be a literal)
+bool AlsaEngine::alsaBadRT(int op_result, const char* err_msg)
+{
+    bool isbad = (op_result < 0);
+    if (isbad)
+        runtime().rtLog.post(rtlog::alsaError, err_msg, snd_strerror(op_result));
+    return isbad;
+}
+
 void AlsaEngine::handleSongPos(float beat)
 {
     const float subDiv = 1.0f / float(MIDI_CLOCKS_PER_BEAT / MIDI_CLOCK_DIVISION);
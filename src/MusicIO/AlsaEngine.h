@@ -41,6 +41,11 @@ using std::string;
 #define ALSA_MIDI_BPM_MEDIAN_WINDOW 48
 #define ALSA_MIDI_BPM_MEDIAN_AVERAGE_WINDOW 20
 
+// adaptive latency: this many xruns within the window add a period
+#define ALSA_XRUN_CLUSTER 3
+#define ALSA_XRUN_WINDOW_US 10000000
+#define ALSA_MAX_PERIODS 8
+
 class SynthEngine;
 
 
@@ -72,12 +77,20 @@ class AlsaEngine : public MusicIO
 
     private:
         bool prepHwparams();
-        bool prepSwparams();
-        void Interleave(int buffersize);
+        bool prepSwparams(bool realTime = false);
+        void prepAreas();
+        void Interleave(const snd_pcm_channel_area_t* areas, snd_pcm_uframes_t offset,
+                        uint from, uint frames);
+        void convertChannel(float const* src, char* dest, uint step, uint frames);
         void Write(snd_pcm_uframes_t towrite);
+        void mmapWrite(snd_pcm_uframes_t towrite);
+        bool writeFailed(snd_pcm_sframes_t err);
         bool Recover(int err);
         bool xrunRecover();
+        bool xrunsClustered();
+        bool growBuffer();
         bool alsaBad(int op_result, string err_msg);
+        bool alsaBadRT(int op_result, const char* err_msg);
         void closeAudio();
         void closeMidi();
 
@@ -94,16 +107,19 @@ class AlsaEngine : public MusicIO
         void handleSongPos(float beat);
         void handleMidiClock(uint64_t clock);
 
-        bool little_endian;
         bool card_endian;
         bool card_signed;
+        bool card_float;
         uint card_chans;
         int  card_bits;
+        uint card_bytes;  // storage per sample, 24 bit is packed into 3
+        bool mmapAccess;
+        bool dither;
+        uint32_t ditherSeed;
 
-        using PcmOutput = snd_pcm_sframes_t(snd_pcm_t*, const void*, snd_pcm_uframes_t);
-        PcmOutput* pcmWrite;
-
-        unique_ptr<int[]> interleaved; // output buffer for 16bit interleaved audio
+        unique_ptr<char[]> interleaved;  // output buffer for rw access
+        unique_ptr<snd_pcm_channel_area_t[]> rwAreas;
+        Samples convertBuff;             // per channel scaling scratch
 
         struct Audio {
             string            device{};
@@ -115,6 +131,8 @@ class AlsaEngine : public MusicIO
             int               alsaId{-1};
             snd_pcm_state_t   pcm_state{SND_PCM_STATE_DISCONNECTED};
             pthread_t         pThread{0};
+            uint64_t          xrunTimes[ALSA_XRUN_CLUSTER]{};
+            uint              xrunPos{0};
         };
 
         struct Midi {
@@ -55,6 +55,8 @@ JackEngine::JackEngine(SynthEngine& _synth, shared_ptr<BeatTracker> beat)
         audio.ports[i] = nullptr;
         audio.portBuffs[i] = nullptr;
     }
+    for (int i = 0; i < NUM_MIDI_PARTS; ++i)
+        audio.partConnected[i].store(false, std::memory_order_relaxed);
 }
 
 
@@ -146,6 +148,10 @@ bool JackEngine::Start()
     bool jackPortsRegistered = true;
     internalbuff = runtime().buffersize;
     jack_set_xrun_callback(jackClient, _xrunCallback, this);
+    if (jack_set_thread_init_callback(jackClient, _threadInitCallback, this))
+        runtime().Log("Set jack thread init callback failed");
+    if (jack_set_port_connect_callback(jackClient, _portConnectCallback, this))
+        runtime().Log("Set jack port connect callback failed");
     #if defined(JACK_SESSION)
         //if (jack_set_session_callback &&
         if(jack_set_session_callback(jackClient, _jsessionCallback, this))
@@ -260,6 +266,7 @@ void JackEngine::registerAudioPort(int partnum)
             portName = "track_" + asString(partnum + 1) + "_r";
             audio.ports[portnum + 1] = jack_port_register(jackClient, portName.c_str(), JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
 
+            audio.partConnected[partnum].store(false, std::memory_order_relaxed);
             if (audio.ports [portnum])
             {
                 runtime().Log("Registered jack port " + asString(partnum + 1));
@@ -422,7 +429,7 @@ bool JackEngine::processAudio(jack_nframes_t nframes)
                     (float*)jack_port_get_buffer(audio.ports[port], nframes);
             if (!audio.portBuffs[port])
             {
-                runtime().Log("Failed to get jack audio port buffer: " + asString(port));
+                runtime().rtLog.post(rtlog::jackAudioBuffer, port);
                 return false;
             }
         }
@@ -431,40 +438,92 @@ bool JackEngine::processAudio(jack_nframes_t nframes)
     audio.portBuffs[2 * NUM_MIDI_PARTS] = (float*)jack_port_get_buffer(audio.ports[2 * NUM_MIDI_PARTS], nframes);
     if (!audio.portBuffs[2 * NUM_MIDI_PARTS])
     {
-        runtime().Log("Failed to get jack audio port buffer: " + asString(2 * NUM_MIDI_PARTS));
+        runtime().rtLog.post(rtlog::jackAudioBuffer, 2 * NUM_MIDI_PARTS);
         return false;
     }
     audio.portBuffs[2 * NUM_MIDI_PARTS + 1] = (float*)jack_port_get_buffer(audio.ports[2 * NUM_MIDI_PARTS + 1], nframes);
     if (!audio.portBuffs[2 * NUM_MIDI_PARTS + 1])
     {
-        runtime().Log("Failed to get jack audio port buffer: " + asString(2 * NUM_MIDI_PARTS + 1));
+        runtime().rtLog.post(rtlog::jackAudioBuffer, 2 * NUM_MIDI_PARTS + 1);
         return false;
     }
 
     BeatTracker::BeatValues beats(beatTracker->getBeatValues());
-    int framesize;
+    bool direct = runtime().jackDirectOutput;
     if (nframes <= internalbuff)
     {
         synth.setBeatValues(beats.songBeat, beats.monotonicBeat, beats.bpm);
-        framesize = sizeof(float) * nframes;
-        synth.MasterAudio(zynLeft, zynRight, nframes);
-        sendAudio(framesize, 0);
+        if (direct)
+            renderDirect(nframes, 0);
+        else
+        {
+            synth.MasterAudio(zynLeft, zynRight, nframes);
+            sendAudio(sizeof(float) * nframes, 0);
+        }
     }
     else
     {
-        framesize = sizeof(float) * internalbuff;
+        int framesize = sizeof(float) * internalbuff;
         for (unsigned int pos = 0; pos < nframes; pos += internalbuff)
         {
             float bpmInc = (float)pos * beats.bpm / (audio.jackSamplerate * 60.0f);
             synth.setBeatValues(beats.songBeat + bpmInc, beats.monotonicBeat + bpmInc, beats.bpm);
-            synth.MasterAudio(zynLeft, zynRight, internalbuff);
-            sendAudio(framesize, pos);
+            if (direct)
+                renderDirect(internalbuff, pos);
+            else
+            {
+                synth.MasterAudio(zynLeft, zynRight, internalbuff);
+                sendAudio(framesize, pos);
+            }
         }
     }
     return true;
 }
 
 
+/*
+ * Let MasterAudio write straight into the jack port buffers, for the
+ * main outs and for every part port that is actually connected.
+ * Parts nobody listens to still need somewhere to go, so they keep
+ * using the internal buffers, which are never copied anywhere.
+ */
+void JackEngine::renderDirect(uint framecount, uint offset)
+{
+    float* outL[NUM_MIDI_PARTS + 1];
+    float* outR[NUM_MIDI_PARTS + 1];
+    for (int npart = 0, idx = 0; npart < NUM_MIDI_PARTS; ++npart, idx += 2)
+    {
+        if (audio.ports[idx] && audio.partConnected[npart].load(std::memory_order_relaxed))
+        {
+            outL[npart] = audio.portBuffs[idx] + offset;
+            outR[npart] = audio.portBuffs[idx + 1] + offset;
+        }
+        else
+        {
+            outL[npart] = zynLeft[npart];
+            outR[npart] = zynRight[npart];
+        }
+    }
+    outL[NUM_MIDI_PARTS] = audio.portBuffs[2 * NUM_MIDI_PARTS] + offset;
+    outR[NUM_MIDI_PARTS] = audio.portBuffs[2 * NUM_MIDI_PARTS + 1] + offset;
+
+    synth.MasterAudio(outL, outR, framecount);
+
+    // connected ports of parts that didn't produce any direct output
+    uint currentmax = runtime().numAvailableParts;
+    size_t framesize = sizeof(float) * framecount;
+    for (uint npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+    {
+        if (outL[npart] == zynLeft[npart])
+            continue;
+        if ((synth.part[npart]->Paudiodest & 2) && npart < currentmax)
+            continue;
+        memset(outL[npart], 0, framesize);
+        memset(outR[npart], 0, framesize);
+    }
+}
+
+
 void JackEngine::sendAudio(int framesize, uint offset)
 {
     // Part outputs
@@ -473,7 +532,7 @@ void JackEngine::sendAudio(int framesize, uint offset)
     {
         if (audio.ports [idx])
         {
-            if (jack_port_connected(audio.ports[idx])) // just a few % improvement.
+            if (audio.partConnected[port].load(std::memory_order_relaxed))
             {
                 float *lpoint = audio.portBuffs[idx] + offset;
                 float *rpoint = audio.portBuffs[idx + 1] + offset;
@@ -503,7 +562,7 @@ bool JackEngine::processMidi(jack_nframes_t nframes)
     void *portBuf = jack_port_get_buffer(midiPort, nframes);
     if (!portBuf)
     {
-        runtime().Log("Bad midi jack_port_get_buffer");
+        runtime().rtLog.post(rtlog::jackMidiBuffer);
         return  false;
     }
 
@@ -514,8 +573,12 @@ bool JackEngine::processMidi(jack_nframes_t nframes)
     for (idx = 0; idx < eventCount; ++idx)
     {
         if (!jack_midi_event_get(&jEvent, portBuf, idx))
+        {
             if (jEvent.size >= 1 && jEvent.size <= 4) // no interest in zero sized or long events
                 handleMidi(jEvent.buffer[0], jEvent.buffer[1], jEvent.buffer[2]);
+            else if (jEvent.size > 4 && jEvent.buffer[0] == 0xf0) // other than tuning is ignored
+                handleSysex(jEvent.buffer, jEvent.size);
+        }
     }
     return true;
 }
@@ -562,11 +625,43 @@ void JackEngine::handleBeatValues(jack_nframes_t nframes)
 
 int JackEngine::_xrunCallback(void* arg)
 {
-    ((JackEngine *)arg)->runtime().Log("xrun reported", _SYS_::LogNotSerious);
+    ((JackEngine *)arg)->runtime().rtLog.post(rtlog::jackXrun);
     return 0;
 }
 
 
+// runs in the jack process thread before it starts processing
+void JackEngine::_threadInitCallback(void* arg)
+{
+    prefaultStack();
+    static_cast<JackEngine*>(arg)->synth.enableFlushToZero();
+    rtlog::audioThread = true;
+}
+
+
+void JackEngine::_portConnectCallback(jack_port_id_t, jack_port_id_t, int, void* arg)
+{
+    static_cast<JackEngine*>(arg)->refreshConnections();
+}
+
+
+/*
+ * Runs in the jack notification thread, so the process
+ * callback only ever needs to read the cached flags.
+ */
+void JackEngine::refreshConnections()
+{
+    for (int npart = 0, idx = 0; npart < NUM_MIDI_PARTS; ++npart, idx += 2)
+    {
+        bool connected = false;
+        if (audio.ports[idx])
+            connected = jack_port_connected(audio.ports[idx])
+                     || jack_port_connected(audio.ports[idx + 1]);
+        audio.partConnected[npart].store(connected, std::memory_order_relaxed);
+    }
+}
+
+
 bool JackEngine::latencyPrep()
 {
 #if defined(JACK_LATENCY)  // >= 0.120.1 API
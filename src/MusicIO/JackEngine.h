@@ -25,6 +25,7 @@
 
 #include "Misc/Util.h"
 
+#include <atomic>
 #include <string>
 #include <jack/jack.h>
 
@@ -76,13 +77,17 @@ class JackEngine : public MusicIO
         bool openJackClient(string server);
         bool connectJackPorts();
         bool processAudio(jack_nframes_t nframes);
+        void renderDirect(uint framecount, uint offset);
         void sendAudio(int framesize, uint offset);
+        void refreshConnections();
         bool processMidi(jack_nframes_t nframes);
         void handleBeatValues(jack_nframes_t nframes);
         bool latencyPrep();
         int processCallback(jack_nframes_t nframes);
         static int _processCallback(jack_nframes_t nframes, void* arg);
         static int _xrunCallback(void* arg);
+        static void _threadInitCallback(void* arg);
+        static void _portConnectCallback(jack_port_id_t a, jack_port_id_t b, int connect, void* arg);
 
 
 #if defined(JACK_SESSION)
@@ -101,6 +106,9 @@ class JackEngine : public MusicIO
             unsigned int  jackNframes;
             jack_port_t  *ports[2*NUM_MIDI_PARTS+2];
             float        *portBuffs[2*NUM_MIDI_PARTS+2];
+            // cached jack_port_connected() state of each part L/R pair,
+            // refreshed from the port-connect callback (non-RT thread)
+            std::atomic<bool> partConnected[NUM_MIDI_PARTS];
         };
 
         jack_client_t *jackClient;
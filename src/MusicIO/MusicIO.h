@@ -68,6 +68,7 @@ class MusicIO
         bool prepBuffers();
         void getAudio()    { synth.MasterAudio(zynLeft, zynRight); }
         void handleMidi(uchar par0, uchar par1, uchar par2, bool in_place = false);
+        void handleSysex(const uchar *data, size_t size) { synth.mididecode.sysexProcess(data, size); }
 
         Samples bufferAllocation;
         float*  zynLeft[NUM_MIDI_PARTS + 1];
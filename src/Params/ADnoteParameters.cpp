@@ -42,6 +42,8 @@ int ADnoteParameters::ADnote_unison_sizes[] =
 ADnoteParameters::ADnoteParameters(fft::Calc& fft_, SynthEngine& _synth)
     : ParamBase{_synth}
     , fft(fft_)
+    , changeCount{0}
+    , changedAt{}
 {
     GlobalPar.FreqEnvelope = new EnvelopeParams(0, 0, synth);
     GlobalPar.FreqEnvelope->ASRinit(64, 50, 64, 60);
@@ -230,6 +232,117 @@ float ADnoteParameters::getUnisonFrequencySpreadCents(int nvoice)
 }
 
 
+// Which of the groups the notes work out a global control falls in,
+// nothing for those they only read when starting, or read directly
+uint ADnoteParameters::globalChange(int control)
+{
+    switch (control)
+    {
+        case ADDSYNTH::control::volume:
+        case ADDSYNTH::control::velocitySense:
+            return ampChange;
+
+        case ADDSYNTH::control::detuneFrequency:
+        case ADDSYNTH::control::octave:
+        case ADDSYNTH::control::detuneType:
+        case ADDSYNTH::control::coarseDetune:
+        case ADDSYNTH::control::relativeBandwidth:
+        case ADDSYNTH::control::bandwidthMultiplier:
+            return pitchChange;
+
+        case ADDSYNTH::control::panning:
+        case ADDSYNTH::control::enableRandomPan:
+        case ADDSYNTH::control::randomWidth:
+        case ADDSYNTH::control::stereo:
+        case ADDSYNTH::control::dePop:
+        case ADDSYNTH::control::punchStrength:
+        case ADDSYNTH::control::punchDuration:
+        case ADDSYNTH::control::punchStretch:
+        case ADDSYNTH::control::punchVelocity:
+            return 0;
+    }
+    return allChanges;
+}
+
+
+// as above for the voice controls, anything not listed redoes the lot
+uint ADnoteParameters::voiceChange(int control)
+{
+    switch (control)
+    {
+        case ADDVOICE::control::volume:
+        case ADDVOICE::control::velocitySense:
+        case ADDVOICE::control::invertPhase:
+            return ampChange;
+
+        case ADDVOICE::control::detuneFrequency:
+        case ADDVOICE::control::equalTemperVariation:
+        case ADDVOICE::control::baseFrequencyAs440Hz:
+        case ADDVOICE::control::octave:
+        case ADDVOICE::control::detuneType:
+        case ADDVOICE::control::coarseDetune:
+        case ADDVOICE::control::pitchBendAdjustment:
+        case ADDVOICE::control::pitchBendOffset:
+            return pitchChange;
+
+        case ADDVOICE::control::unisonFrequencySpread:
+        case ADDVOICE::control::unisonSpreadCents:
+        case ADDVOICE::control::unisonPhaseRandomise:
+        case ADDVOICE::control::unisonStereoSpread:
+        case ADDVOICE::control::unisonVibratoDepth:
+        case ADDVOICE::control::unisonVibratoSpeed:
+        case ADDVOICE::control::unisonPhaseInvert:
+            return unisonChange;
+
+        case ADDVOICE::control::bypassGlobalFilter:
+            return filterChange;
+
+        case ADDVOICE::control::modulatorAmplitude:
+        case ADDVOICE::control::modulatorVelocitySense:
+        case ADDVOICE::control::modulatorHFdamping:
+        case ADDVOICE::control::modulatorDetuneFrequency:
+        case ADDVOICE::control::modulatorDetuneFromBaseOsc:
+        case ADDVOICE::control::modulatorFrequencyAs440Hz:
+        case ADDVOICE::control::modulatorOctave:
+        case ADDVOICE::control::modulatorDetuneType:
+        case ADDVOICE::control::modulatorCoarseDetune:
+        case ADDVOICE::control::modulatorOscillatorPhase:
+        case ADDVOICE::control::modulatorOscillatorSource:
+            return fmChange;
+
+        case ADDVOICE::control::enableResonance:
+        case ADDVOICE::control::voiceOscillatorPhase:
+        case ADDVOICE::control::externalOscillator:
+        case ADDVOICE::control::voiceOscillatorSource:
+            return waveChange;
+    }
+    return allChanges;
+}
+
+
+void ADnoteParameters::paramsChanged(uint what)
+{
+    if (what == 0)
+        return;
+    ++changeCount;
+    for (uint group = 0; group < CHANGE_GROUPS; ++group)
+        if (what & (1u << group))
+            changedAt[group] = changeCount;
+    ParamBase::paramsChanged();
+}
+
+
+// the groups changed after stamp, it's fine for the count to wrap
+uint ADnoteParameters::changedSince(uint stamp) const
+{
+    uint what = 0;
+    for (uint group = 0; group < CHANGE_GROUPS; ++group)
+        if (int(changedAt[group] - stamp) > 0)
+            what |= 1u << group;
+    return what;
+}
+
+
 // Kill the voice
 void ADnoteParameters::killVoice(int nvoice)
 {
@@ -206,6 +206,24 @@ class ADnoteParameters : public ParamBase
         float getBandwidthDetuneMultiplier();
         float getUnisonFrequencySpreadCents(int nvoice);
         void setGlobalPan(char pan, uchar panLaw);
+
+        // what a change means for the notes playing, see ADnote::computeNoteParameters()
+        enum Change : uint {
+            ampChange    = 1,
+            pitchChange  = 2,  // implies FM and wave, they depend on the voice frequency
+            filterChange = 4,
+            fmChange     = 8,
+            unisonChange = 16,
+            waveChange   = 32,
+            allChanges   = 63
+        };
+        static constexpr uint CHANGE_GROUPS = 6;
+        static uint globalChange(int control);
+        static uint voiceChange(int control);
+        void paramsChanged(uint what = allChanges);
+        uint changeStamp() const { return changeCount; }
+        uint changedSince(uint stamp) const;
+
         void setVoicePan(int voice, char pan, uchar panLaw);
         ADnoteGlobalParam GlobalPar;
         ADnoteVoiceParam VoicePar[NUM_VOICES];
@@ -224,6 +242,8 @@ class ADnoteParameters : public ParamBase
         void killVoice(int nvoice);
 
         fft::Calc& fft;
+        uint changeCount;
+        uint changedAt[CHANGE_GROUPS]; // changeCount when each group last changed
 };
 
 #endif
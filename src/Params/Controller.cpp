@@ -124,14 +124,20 @@ void  Controller::portamentosetup()
 void Controller::setpitchwheel(int value)
 {
     pitchwheel.data = value;
-    float cents = value / 8192.0f;
-    cents *= pitchwheel.bendrange;
-    pitchwheel.relfreq = power<2>(cents / 1200.0f);
+    pitchwheel.relfreq = pitchwheelFreq(value);
     // original comment
     //fprintf(stderr,"%ld %ld -> %.3f\n",pitchwheel.bendrange,pitchwheel.data,pitchwheel.relfreq);fflush(stderr);
 }
 
 
+float Controller::pitchwheelFreq(int value) const
+{
+    float cents = value / 8192.0f;
+    cents *= pitchwheel.bendrange;
+    return power<2>(cents / 1200.0f);
+}
+
+
 void Controller::setpitchwheelbendrange(ushort value)
 {
     pitchwheel.bendrange = value;
@@ -151,15 +157,27 @@ void Controller::setexpression(int value)
 void Controller::setfiltercutoff(int value)
 {
     filtercutoff.data = value;
-    filtercutoff.relfreq = (value - 64.0f) * filtercutoff.depth / 4096.0f
-                           * 3.321928f; // 3.3219.. = ln2(10)
+    filtercutoff.relfreq = filtercutoffFreq(value);
+}
+
+
+float Controller::filtercutoffFreq(int value) const
+{
+    return (value - 64.0f) * filtercutoff.depth / 4096.0f
+           * 3.321928f; // 3.3219.. = ln2(10)
 }
 
 
 void Controller::setfilterq(int value)
 {
     filterq.data = value;
-    filterq.relq = power<30>((value - 64.0f) / 64.0f * (filterq.depth / 64.0f));
+    filterq.relq = filterqRel(value);
+}
+
+
+float Controller::filterqRel(int value) const
+{
+    return power<30>((value - 64.0f) / 64.0f * (filterq.depth / 64.0f));
 }
 
 
@@ -185,17 +203,19 @@ void Controller::setbandwidth(int value)
 void Controller::setmodwheel(int value)
 {
     modwheel.data = value;
-    if (!modwheel.exponential)
-    {
-        float tmp = power<25>(powf(modwheel.depth / 127.0f, 1.5f) * 2.0f) / 25.0f;
-        if (value < 64 && modwheel.depth >= 64)
-            tmp = 1.0f;
-        modwheel.relmod = (value / 64.0f - 1.0f) * tmp + 1.0f;
-        if (modwheel.relmod < 0.0f)
-            modwheel.relmod = 0.0f;
-    }
-    else
-        modwheel.relmod = power<25>((value - 64.0f) / 64.0f * (modwheel.depth / 80.0f));
+    modwheel.relmod = modwheelRel(value);
+}
+
+
+float Controller::modwheelRel(int value) const
+{
+    if (modwheel.exponential)
+        return power<25>((value - 64.0f) / 64.0f * (modwheel.depth / 80.0f));
+    float tmp = power<25>(powf(modwheel.depth / 127.0f, 1.5f) * 2.0f) / 25.0f;
+    if (value < 64 && modwheel.depth >= 64)
+        tmp = 1.0f;
+    float relmod = (value / 64.0f - 1.0f) * tmp + 1.0f;
+    return (relmod < 0.0f) ? 0.0f : relmod;
 }
 
 
@@ -285,7 +305,7 @@ bool Controller::initportamento(float oldfreq, float newfreq, bool in_progress)
         portamentotime *= powFrac<10>((64.0f - portamento.updowntimestretch) / 64.0f);
     }
 
-    portamento.dx = synth->fixed_sample_step_f / portamentotime;
+    portamento.dx = synth->control_step_f / portamentotime;
     portamento.origfreqrap = oldfreq / newfreq;
 
     float tmprap = (portamento.origfreqrap > 1.0f)
@@ -61,6 +61,13 @@ class Controller
         void setresonancecenter(int value);
         void setresonancebw(int value);
         void setPanDepth(char par) { panning.depth = par;}
+
+        // what the setters above work out, for a value other than the current one
+        float pitchwheelFreq(int value) const;
+        float filtercutoffFreq(int value) const;
+        float filterqRel(int value) const;
+        float modwheelRel(int value) const;
+
         bool initportamento(float oldfreq, float newfreq, bool in_progress); // returns true if portamento's preconditions are met
         void updateportamento(); // update portamento values
         float getLimits(CommandBlock *getData);
@@ -166,5 +173,20 @@ private:
         SynthEngine *synth;
 };
 
+
+/*
+ * The controller values that can be different for every note, with key
+ * aftertouch or MPE, in the form the notes read them. The part works
+ * them out for each note before every block, so the Controller itself
+ * is shared by all the notes and left alone while they are rendered.
+ */
+struct NoteExpression
+{
+    float relfreq; // as Controller::pitchwheel
+    float cutoff;  // as Controller::filtercutoff
+    float relq;    // as Controller::filterq
+    float relmod;  // as Controller::modwheel
+};
+
 #endif
 
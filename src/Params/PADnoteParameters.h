@@ -31,6 +31,7 @@
 
 #include "Params/ParamCheck.h"
 #include "Misc/RandomGen.h"
+#include "Misc/Alloc.h"
 #include "Misc/BuildScheduler.h"
 #include "Params/RandomWalk.h"
 #include "Synth/XFadeManager.h"
@@ -114,6 +115,14 @@ public: // can be moved and swapped, but not copied...
             samples[tab].reset();
     }
 
+    size_t prefault() // touch all wavetables, returns bytes covered
+    {
+        size_t bytes = prefaultPages(basefreq.get(), numTables * sizeof(float));
+        for (size_t tab=0; tab < numTables; ++tab)
+            bytes += prefaultPages(&samples[tab][0], (tableSize + fft::Waveform::INTERPOLATION_BUFFER) * sizeof(float));
+        return bytes;
+    }
+
     // Subscript: access n-th wavetable
     fft::Waveform& operator[](size_t tableNo)
     {
@@ -38,6 +38,7 @@
 #include "Misc/SynthEngine.h"
 #include "Misc/SynthHelper.h"
 #include "Misc/NumericFuncs.h"
+#include "Misc/RenderPool.h"
 
 #include "globals.h"
 
@@ -47,6 +48,9 @@ using synth::velF;
 using synth::getDetune;
 using synth::interpolateAmplitude;
 using synth::aboveAmplitudeThreshold;
+using synth::fadeInLength;
+using synth::fadeIn;
+using synth::fadeOut;
 using func::setRandomPan;
 
 using std::isgreater;
@@ -105,13 +109,15 @@ ADnote::~ADnote() { /* all clean-up done automatically */ }
 
 
 // Internal: this constructor does the actual initialisation....
-ADnote::ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note note_, bool portamento_
+ADnote::ADnote(ADnoteParameters& adpars_, Controller& ctl_, NoteExpression const& expr_, Note note_, bool portamento_
               ,ADnote* topVoice_, int subVoice_, int phaseOffset, float *parentFMmod_
               , bool forFM_, size_t unison_total_size)
     : synth{adpars_.getSynthEngine()}
     , adpars{adpars_}
     , paramsUpdate{adpars}
+    , paramsSeen{adpars.changeStamp()}
     , ctl{ctl_}
+    , expr{expr_}
     , note{note_}
     , stereo{adpars.GlobalPar.PStereo}
     , noteStatus{NOTE_ENABLED}
@@ -162,9 +168,10 @@ ADnote::ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note note_, bool por
 }
 
 // Public Constructor for ordinary (top-level) voices
-ADnote::ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note note_, bool portamento_)
+ADnote::ADnote(ADnoteParameters& adpars_, Controller& ctl_, NoteExpression const& expr_, Note note_, bool portamento_)
     : ADnote(adpars_
             ,ctl_
+            ,expr_
             ,note_
             ,portamento_
             , this    // marker: "this is a topVoice"
@@ -182,6 +189,7 @@ ADnote::ADnote(ADnote *topVoice_, float freq_,
                size_t unison_total_size)
     : ADnote(topVoice_->adpars
             ,topVoice_->ctl
+            ,topVoice_->expr
             ,topVoice_->note.withFreq(freq_)
             ,topVoice_->portamento
             ,topVoice_
@@ -217,7 +225,9 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
     : synth{orig.synth}
     , adpars{orig.adpars} // Probably okay for legato?
     , paramsUpdate{adpars}
+    , paramsSeen{adpars.changeStamp()}
     , ctl{orig.ctl}
+    , expr{orig.expr}
     , note{orig.note}
     , stereo{orig.stereo}
     , noteStatus{orig.noteStatus}
@@ -231,6 +241,7 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
     , max_unison{orig.max_unison}
     , globaloldamplitude{orig.globaloldamplitude}
     , globalnewamplitude{orig.globalnewamplitude}
+    , fadeOutLevel{orig.fadeOutLevel}
     , portamento{orig.portamento}
     , bandwidthDetuneMultiplier{orig.bandwidthDetuneMultiplier}
     , legatoFade{0.0f} // Silent by default
@@ -246,6 +257,9 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
     // These are all arrays, so sizeof is correct
     memcpy(pinking, orig.pinking, sizeof(pinking));
     memcpy(firsttick, orig.firsttick, sizeof(firsttick));
+    memcpy(fadeinPos, orig.fadeinPos, sizeof(fadeinPos));
+    memcpy(fadeinLength, orig.fadeinLength, sizeof(fadeinLength));
+    memcpy(voiceFadeOut, orig.voiceFadeOut, sizeof(voiceFadeOut));
 
     memcpy(oldAmplitude, orig.oldAmplitude, sizeof(oldAmplitude));
     memcpy(newAmplitude, orig.newAmplitude, sizeof(newAmplitude));
@@ -256,7 +270,7 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
     memcpy(unison_stereo_spread, orig.unison_stereo_spread, sizeof(unison_stereo_spread));
     memcpy(freqbasedmod, orig.freqbasedmod, sizeof(freqbasedmod));
 
-    allocateUnison(max_unison, synth.buffersize);
+    allocateUnison(max_unison, synth.controlsize);
 
     for (int voice = 0; voice < NUM_VOICES; ++voice)
     {
@@ -268,9 +282,9 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
 
         if (ovpar.voiceOut)
         {
-            vpar.voiceOut.reset(synth.buffersize);
+            vpar.voiceOut.reset(synth.controlsize);
             ///TODO: is copying of output buffers contents really necessary?
-            memcpy(vpar.voiceOut.get(), ovpar.voiceOut.get(), synth.bufferbytes);
+            memcpy(vpar.voiceOut.get(), ovpar.voiceOut.get(), synth.controlsize * sizeof(float));
         }
         else
             vpar.voiceOut.reset();
@@ -284,7 +298,7 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
         vpar.voice = ovpar.voice;
         vpar.noiseType = ovpar.noiseType;
         vpar.filterBypass = ovpar.filterBypass;
-        vpar.delayTicks = ovpar.delayTicks;
+        vpar.delayFrames = ovpar.delayFrames;
         vpar.phaseOffset = ovpar.phaseOffset;
 
         vpar.fixedFreq = ovpar.fixedFreq;
@@ -425,6 +439,7 @@ void ADnote::construct(size_t unison_total_size)
     // Initialise some legato-specific vars
     legatoFade = 1.0f; // Full volume
     legatoFadeStep = 0.0f; // Legato disabled
+    fadeOutLevel = 1.0f;
 
     paramSeed = synth.randomINT();
 
@@ -622,9 +637,11 @@ void ADnote::construct(size_t unison_total_size)
         fm_oldSmp[nvoice].reset(new float [unison]{0}); // zero init
 
         firsttick[nvoice] = 1;
-        NoteVoicePar[nvoice].delayTicks =
+        fadeinPos[nvoice] = fadeinLength[nvoice] = 0;
+        voiceFadeOut[nvoice] = 1.0f;
+        NoteVoicePar[nvoice].delayFrames = synth.controlsize *
             (int)((expf(adpars.VoicePar[nvoice].PDelay / 127.0f
-            * logf(50.0f)) - 1.0f) / synth.fixed_sample_step_f / 10.0f);
+            * logf(50.0f)) - 1.0f) / synth.control_step_f / 10.0f);
 
         if (parentFMmod != NULL && NoteVoicePar[nvoice].fmEnabled == FREQ_MOD)
         {
@@ -645,7 +662,7 @@ void ADnote::construct(size_t unison_total_size)
         if (unison_size[nvoice] > max_unison)
             max_unison = unison_size[nvoice];
 
-    allocateUnison(max_unison, synth.buffersize);
+    allocateUnison(max_unison, synth.controlsize);
 
     initParameters();
     initSubVoices(unison_total_size);
@@ -795,6 +812,15 @@ void ADnote::legatoFadeOut()
 }
 
 
+// Fade to silence from the current level, then the note disables itself.
+// Used by the voice manager, so unlike a release there is no tail.
+void ADnote::stealFadeOut()
+{
+    legatoFadeStep = -synth.fadeStepShort;
+    noteStatus = NOTE_LEGATOFADEOUT;
+}
+
+
 
 // Kill a voice of ADnote
 void ADnote::killVoice(int nvoice)
@@ -831,7 +857,7 @@ void ADnote::killVoice(int nvoice)
     NoteVoicePar[nvoice].fmAmpEnvelope.reset();
 
     if (NoteVoicePar[nvoice].voiceOut)
-        memset(NoteVoicePar[nvoice].voiceOut.get(), 0, synth.bufferbytes);
+        memset(NoteVoicePar[nvoice].voiceOut.get(), 0, synth.controlsize * sizeof(float));
         // do not delete, yet: perhaps is used by another voice
 
     if (parentFMmod != NULL && NoteVoicePar[nvoice].fmEnabled == FREQ_MOD)
@@ -1016,301 +1042,357 @@ void ADnote::initParameters()
     }
 
     if (subVoiceNr != -1)
-        NoteVoicePar[subVoiceNr].voiceOut.reset(synth.buffersize);
+        NoteVoicePar[subVoiceNr].voiceOut.reset(synth.controlsize);
 }
 
 
-void ADnote::computeNoteParameters()
+// After the parameters have changed, with the notes playing
+void ADnote::refreshNoteParameters()
 {
-    paramRNG.init(paramSeed);
+    uint changed = adpars.changedSince(paramsSeen);
+    paramsSeen = adpars.changeStamp();
+    if (changed)
+        computeNoteParameters(changed);
+}
 
-    noteGlobal.detune = getDetune(adpars.GlobalPar.PDetuneType,
-                                     adpars.GlobalPar.PCoarseDetune,
-                                     adpars.GlobalPar.PDetune);
-    bandwidthDetuneMultiplier = adpars.getBandwidthDetuneMultiplier();
 
-    noteGlobal.volume =
-        4.0f                                                           // +12dB boost (similar on PADnote, while SUBnote only boosts +6dB)
-        * decibel<-60>(1.0f - adpars.GlobalPar.PVolume / 96.0f)       // -60 dB .. +19.375 dB
-        * velF(note.vel, adpars.GlobalPar.PAmpVelocityScaleFunction); // velocity sensing
+// Only the groups given are worked out again, and a change in pitch
+// carries through to whatever depends on the voice base frequencies
+void ADnote::computeNoteParameters(uint changed)
+{
+    if (changed & ADnoteParameters::pitchChange)
+        changed |= ADnoteParameters::fmChange | ADnoteParameters::waveChange;
+    bool amp = changed & ADnoteParameters::ampChange;
+    bool pitch = changed & ADnoteParameters::pitchChange;
+    bool filter = changed & ADnoteParameters::filterChange;
+    bool fm = changed & ADnoteParameters::fmChange;
+    bool unisonData = changed & ADnoteParameters::unisonChange;
+    bool wave = changed & ADnoteParameters::waveChange;
+
+    // only the unison set up takes from it, so that alone gets the same values
+    if (unisonData)
+        paramRNG.init(paramSeed);
+
+    if (pitch)
+    {
+        noteGlobal.detune = getDetune(adpars.GlobalPar.PDetuneType,
+                                         adpars.GlobalPar.PCoarseDetune,
+                                         adpars.GlobalPar.PDetune);
+        bandwidthDetuneMultiplier = adpars.getBandwidthDetuneMultiplier();
+    }
+
+    if (amp)
+        noteGlobal.volume =
+            4.0f                                                           // +12dB boost (similar on PADnote, while SUBnote only boosts +6dB)
+            * decibel<-60>(1.0f - adpars.GlobalPar.PVolume / 96.0f)       // -60 dB .. +19.375 dB
+            * velF(note.vel, adpars.GlobalPar.PAmpVelocityScaleFunction); // velocity sensing
 
     for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
     {
         if (!NoteVoicePar[nvoice].enabled)
             continue;
+        if (pitch)
+            computeVoicePitch(nvoice);
+        if (filter)
+            NoteVoicePar[nvoice].filterBypass = adpars.VoicePar[nvoice].Pfilterbypass;
+        if (fm)
+            computeVoiceFM(nvoice);
+        if (amp)
+            computeVoiceAmp(nvoice);
+        if (wave)
+            computeVoiceWave(nvoice);
+        if (unisonData)
+            computeVoiceUnison(nvoice);
+    }
+}
 
-        if (subVoiceNr == -1)
-        {
-            int BendAdj = adpars.VoicePar[nvoice].PBendAdjust - 64;
-            if (BendAdj % 24 == 0)
-                NoteVoicePar[nvoice].bendAdjust = BendAdj / 24;
-            else
-                NoteVoicePar[nvoice].bendAdjust = BendAdj / 24.0f;
-        }
-        else
-        {
-            // No bend adjustments for sub voices. Take from parent via
-            // detuneFromParent.
-            NoteVoicePar[nvoice].bendAdjust = 0.0f;
-        }
 
-        float offset_val = (adpars.VoicePar[nvoice].POffsetHz - 64)/64.0f;
-        NoteVoicePar[nvoice].offsetHz =
-            15.0f*(offset_val * sqrtf(fabsf(offset_val)));
+void ADnote::computeVoicePitch(int nvoice)
+{
+    if (subVoiceNr == -1)
+    {
+        int BendAdj = adpars.VoicePar[nvoice].PBendAdjust - 64;
+        if (BendAdj % 24 == 0)
+            NoteVoicePar[nvoice].bendAdjust = BendAdj / 24;
+        else
+            NoteVoicePar[nvoice].bendAdjust = BendAdj / 24.0f;
+    }
+    else
+    {
+        // No bend adjustments for sub voices. Take from parent via
+        // detuneFromParent.
+        NoteVoicePar[nvoice].bendAdjust = 0.0f;
+    }
 
-        NoteVoicePar[nvoice].fixedFreq = adpars.VoicePar[nvoice].Pfixedfreq;
-        NoteVoicePar[nvoice].fixedFreqET = adpars.VoicePar[nvoice].PfixedfreqET;
+    float offset_val = (adpars.VoicePar[nvoice].POffsetHz - 64)/64.0f;
+    NoteVoicePar[nvoice].offsetHz =
+        15.0f*(offset_val * sqrtf(fabsf(offset_val)));
 
-        // use the Globalpars.detunetype if the detunetype is 0
-        if (adpars.VoicePar[nvoice].PDetuneType)
-        {
-            NoteVoicePar[nvoice].detune =
-                getDetune(adpars.VoicePar[nvoice].PDetuneType,
-                          adpars.VoicePar[nvoice].PCoarseDetune, 8192); // coarse detune
-            NoteVoicePar[nvoice].fineDetune =
-                getDetune(adpars.VoicePar[nvoice].PDetuneType, 0,
-                          adpars.VoicePar[nvoice].PDetune); // fine detune
-        }
-        else
-        {
-            NoteVoicePar[nvoice].detune =
-                getDetune(adpars.GlobalPar.PDetuneType,
-                          adpars.VoicePar[nvoice].PCoarseDetune, 8192); // coarse detune
-            NoteVoicePar[nvoice].fineDetune =
-                getDetune(adpars.GlobalPar.PDetuneType, 0,
-                          adpars.VoicePar[nvoice].PDetune); // fine detune
-        }
-        if (adpars.VoicePar[nvoice].PFMDetuneType != 0)
-            NoteVoicePar[nvoice].fmDetune =
-                getDetune(adpars.VoicePar[nvoice].PFMDetuneType,
-                          adpars.VoicePar[nvoice].PFMCoarseDetune,
-                          adpars.VoicePar[nvoice].PFMDetune);
-        else
-            NoteVoicePar[nvoice].fmDetune =
-                getDetune(adpars.GlobalPar.PDetuneType, adpars.VoicePar[nvoice].
-                          PFMCoarseDetune, adpars.VoicePar[nvoice].PFMDetune);
+    NoteVoicePar[nvoice].fixedFreq = adpars.VoicePar[nvoice].Pfixedfreq;
+    NoteVoicePar[nvoice].fixedFreqET = adpars.VoicePar[nvoice].PfixedfreqET;
 
-        NoteVoicePar[nvoice].filterBypass = adpars.VoicePar[nvoice].Pfilterbypass;
+    // use the Globalpars.detunetype if the detunetype is 0
+    if (adpars.VoicePar[nvoice].PDetuneType)
+    {
+        NoteVoicePar[nvoice].detune =
+            getDetune(adpars.VoicePar[nvoice].PDetuneType,
+                      adpars.VoicePar[nvoice].PCoarseDetune, 8192); // coarse detune
+        NoteVoicePar[nvoice].fineDetune =
+            getDetune(adpars.VoicePar[nvoice].PDetuneType, 0,
+                      adpars.VoicePar[nvoice].PDetune); // fine detune
+    }
+    else
+    {
+        NoteVoicePar[nvoice].detune =
+            getDetune(adpars.GlobalPar.PDetuneType,
+                      adpars.VoicePar[nvoice].PCoarseDetune, 8192); // coarse detune
+        NoteVoicePar[nvoice].fineDetune =
+            getDetune(adpars.GlobalPar.PDetuneType, 0,
+                      adpars.VoicePar[nvoice].PDetune); // fine detune
+    }
+    if (subVoice[nvoice])
+    {
+        float basefreq = getVoiceBaseFreq(nvoice);
+        if (basefreq != subVoice[nvoice][0]->note.freq)
+            for (size_t k = 0; k < unison_size[nvoice]; ++k)
+                subVoice[nvoice][k]->note.freq = basefreq;
+    }
+}
 
-        NoteVoicePar[nvoice].fmDetuneFromBaseOsc =
-            (adpars.VoicePar[nvoice].PFMDetuneFromBaseOsc != 0);
-        NoteVoicePar[nvoice].fmFreqFixed  = adpars.VoicePar[nvoice].PFMFixedFreq;
 
-        if (subVoice[nvoice])
-        {
-            float basefreq = getVoiceBaseFreq(nvoice);
-            if (basefreq != subVoice[nvoice][0]->note.freq)
-                for (size_t k = 0; k < unison_size[nvoice]; ++k)
-                    subVoice[nvoice][k]->note.freq = basefreq;
-        }
-        if (subFMVoice[nvoice])
-        {
-            float basefreq = getFMVoiceBaseFreq(nvoice);
-            if (basefreq != subFMVoice[nvoice][0]->note.freq)
-                for (size_t k = 0; k < unison_size[nvoice]; ++k)
-                    subFMVoice[nvoice][k]->note.freq = basefreq;
-        }
-
-        // Compute the Voice's modulator volume (incl. damping)
-        float fmvoldamp = powf(440.0f / getVoiceBaseFreq(nvoice),
-                               adpars.VoicePar[nvoice].PFMVolumeDamp
-                               / 64.0f - 1.0f);
-        switch (NoteVoicePar[nvoice].fmEnabled)
-        {
-            case PHASE_MOD:
-            case PW_MOD:
-                fmvoldamp = powf(440.0f / getVoiceBaseFreq(nvoice),
-                                 adpars.VoicePar[nvoice].PFMVolumeDamp / 64.0f);
-                NoteVoicePar[nvoice].fmVolume =
-                    (expf(adpars.VoicePar[nvoice].PFMVolume / 127.0f
-                          * FM_AMP_MULTIPLIER) - 1.0f) * fmvoldamp * 4.0f;
-                break;
+void ADnote::computeVoiceFM(int nvoice)
+{
+    if (adpars.VoicePar[nvoice].PFMDetuneType != 0)
+        NoteVoicePar[nvoice].fmDetune =
+            getDetune(adpars.VoicePar[nvoice].PFMDetuneType,
+                      adpars.VoicePar[nvoice].PFMCoarseDetune,
+                      adpars.VoicePar[nvoice].PFMDetune);
+    else
+        NoteVoicePar[nvoice].fmDetune =
+            getDetune(adpars.GlobalPar.PDetuneType, adpars.VoicePar[nvoice].
+                      PFMCoarseDetune, adpars.VoicePar[nvoice].PFMDetune);
 
-            case FREQ_MOD:
-                NoteVoicePar[nvoice].fmVolume =
-                    (expf(adpars.VoicePar[nvoice].PFMVolume / 127.0f
-                          * FM_AMP_MULTIPLIER) - 1.0f) * fmvoldamp * 4.0f;
-                break;
+    NoteVoicePar[nvoice].fmDetuneFromBaseOsc =
+        (adpars.VoicePar[nvoice].PFMDetuneFromBaseOsc != 0);
+    NoteVoicePar[nvoice].fmFreqFixed  = adpars.VoicePar[nvoice].PFMFixedFreq;
 
-            default:
-                if (fmvoldamp > 1.0f)
-                    fmvoldamp = 1.0f;
-                NoteVoicePar[nvoice].fmVolume =
-                    adpars.VoicePar[nvoice].PFMVolume / 127.0f * fmvoldamp;
-                break;
-        }
+    if (subFMVoice[nvoice])
+    {
+        float basefreq = getFMVoiceBaseFreq(nvoice);
+        if (basefreq != subFMVoice[nvoice][0]->note.freq)
+            for (size_t k = 0; k < unison_size[nvoice]; ++k)
+                subFMVoice[nvoice][k]->note.freq = basefreq;
+    }
 
-        // Voice's modulator velocity sensing
-        NoteVoicePar[nvoice].fmVolume *=
-            velF(note.vel, adpars.VoicePar[nvoice].PFMVelocityScaleFunction);
+    // Compute the Voice's modulator volume (incl. damping)
+    float fmvoldamp = powf(440.0f / getVoiceBaseFreq(nvoice),
+                           adpars.VoicePar[nvoice].PFMVolumeDamp
+                           / 64.0f - 1.0f);
+    switch (NoteVoicePar[nvoice].fmEnabled)
+    {
+        case PHASE_MOD:
+        case PW_MOD:
+            fmvoldamp = powf(440.0f / getVoiceBaseFreq(nvoice),
+                             adpars.VoicePar[nvoice].PFMVolumeDamp / 64.0f);
+            NoteVoicePar[nvoice].fmVolume =
+                (expf(adpars.VoicePar[nvoice].PFMVolume / 127.0f
+                      * FM_AMP_MULTIPLIER) - 1.0f) * fmvoldamp * 4.0f;
+            break;
 
-        // Voice Amplitude Parameters Init
-        if (adpars.VoicePar[nvoice].PVolume == 0)
-            NoteVoicePar[nvoice].volume = 0.0f;
-        else
-            NoteVoicePar[nvoice].volume =
-                decibel<-60>(1.0f - adpars.VoicePar[nvoice].PVolume / 127.0f)        // -60 dB .. 0 dB
-                * velF(note.vel, adpars.VoicePar[nvoice].PAmpVelocityScaleFunction); // velocity
+        case FREQ_MOD:
+            NoteVoicePar[nvoice].fmVolume =
+                (expf(adpars.VoicePar[nvoice].PFMVolume / 127.0f
+                      * FM_AMP_MULTIPLIER) - 1.0f) * fmvoldamp * 4.0f;
+            break;
 
-        if (adpars.VoicePar[nvoice].PVolumeminus)
-            NoteVoicePar[nvoice].volume = -NoteVoicePar[nvoice].volume;
+        default:
+            if (fmvoldamp > 1.0f)
+                fmvoldamp = 1.0f;
+            NoteVoicePar[nvoice].fmVolume =
+                adpars.VoicePar[nvoice].PFMVolume / 127.0f * fmvoldamp;
+            break;
+    }
 
-        int unison = unison_size[nvoice];
+    // Voice's modulator velocity sensing
+    NoteVoicePar[nvoice].fmVolume *=
+        velF(note.vel, adpars.VoicePar[nvoice].PFMVelocityScaleFunction);
 
-        if (subVoiceNr == -1)
-        {
-            int vc = nvoice;
-            if (adpars.VoicePar[nvoice].Pextoscil != -1)
-                vc = adpars.VoicePar[nvoice].Pextoscil;
-            adpars.VoicePar[vc].OscilSmp->getWave(NoteVoicePar[nvoice].oscilSmp,
-                                                   getVoiceBaseFreq(nvoice),
-                                                   adpars.VoicePar[nvoice].Presonance != 0);
+    if (NoteVoicePar[nvoice].fmEnabled != NONE
+        && NoteVoicePar[nvoice].fmVoice < 0
+        && subVoiceNr == -1)
+    {
+        int vc = nvoice;
+        if (adpars.VoicePar[nvoice].PextFMoscil != -1)
+            vc = adpars.VoicePar[nvoice].PextFMoscil;
 
-            // I store the first elements to the last position for speedups
-            NoteVoicePar[nvoice].oscilSmp.fillInterpolationBuffer();
-        }
+        float freqtmp = 1.0f;
+        if (adpars.VoicePar[vc].POscilFM->Padaptiveharmonics != 0
+            || (NoteVoicePar[nvoice].fmEnabled == MORPH)
+            || (NoteVoicePar[nvoice].fmEnabled == RING_MOD))
+            freqtmp = getFMVoiceBaseFreq(nvoice);
 
-        if (NoteVoicePar[nvoice].fmEnabled != NONE
-            && NoteVoicePar[nvoice].fmVoice < 0
-            && subVoiceNr == -1)
-        {
-            int vc = nvoice;
-            if (adpars.VoicePar[nvoice].PextFMoscil != -1)
-                vc = adpars.VoicePar[nvoice].PextFMoscil;
+        adpars.VoicePar[vc].FMSmp->getWave(NoteVoicePar[nvoice].fmSmp, freqtmp);
+        NoteVoicePar[nvoice].fmSmp.fillInterpolationBuffer();
+    }
+    computeFMPhaseOffsets(nvoice);
+}
 
-            float freqtmp = 1.0f;
-            if (adpars.VoicePar[vc].POscilFM->Padaptiveharmonics != 0
-                || (NoteVoicePar[nvoice].fmEnabled == MORPH)
-                || (NoteVoicePar[nvoice].fmEnabled == RING_MOD))
-                freqtmp = getFMVoiceBaseFreq(nvoice);
 
-            adpars.VoicePar[vc].FMSmp->getWave(NoteVoicePar[nvoice].fmSmp, freqtmp);
-            NoteVoicePar[nvoice].fmSmp.fillInterpolationBuffer();
-        }
+void ADnote::computeVoiceAmp(int nvoice)
+{
+    // Voice Amplitude Parameters Init
+    if (adpars.VoicePar[nvoice].PVolume == 0)
+        NoteVoicePar[nvoice].volume = 0.0f;
+    else
+        NoteVoicePar[nvoice].volume =
+            decibel<-60>(1.0f - adpars.VoicePar[nvoice].PVolume / 127.0f)        // -60 dB .. 0 dB
+            * velF(note.vel, adpars.VoicePar[nvoice].PAmpVelocityScaleFunction); // velocity
 
-        computePhaseOffsets(nvoice);
-        computeFMPhaseOffsets(nvoice);
+    if (adpars.VoicePar[nvoice].PVolumeminus)
+        NoteVoicePar[nvoice].volume = -NoteVoicePar[nvoice].volume;
+}
 
-        bool is_pwm = NoteVoicePar[nvoice].fmEnabled == PW_MOD;
 
-        unison_stereo_spread[nvoice] =
-            adpars.VoicePar[nvoice].Unison_stereo_spread / 127.0f;
-        float unison_spread = adpars.getUnisonFrequencySpreadCents(nvoice);
-        float unison_real_spread = power<2>((unison_spread * 0.5f) / 1200.0f);
-        float unison_vibrato_a = adpars.VoicePar[nvoice].Unison_vibrato / 127.0f;   // 0.0 .. 1.0
+void ADnote::computeVoiceWave(int nvoice)
+{
+    if (subVoiceNr == -1)
+    {
+        int vc = nvoice;
+        if (adpars.VoicePar[nvoice].Pextoscil != -1)
+            vc = adpars.VoicePar[nvoice].Pextoscil;
+        adpars.VoicePar[vc].OscilSmp->getWave(NoteVoicePar[nvoice].oscilSmp,
+                                               getVoiceBaseFreq(nvoice),
+                                               adpars.VoicePar[nvoice].Presonance != 0);
 
-        int true_unison = unison >> is_pwm;
-        switch (true_unison)
-        {
-            case 1: // if no unison, set the subvoice to the default note
-                unison_base_freq_rap[nvoice][0] = 1.0f;
-                break;
+        // I store the first elements to the last position for speedups
+        NoteVoicePar[nvoice].oscilSmp.fillInterpolationBuffer();
+    }
+    computePhaseOffsets(nvoice);
+}
 
-            case 2:  // unison for 2 subvoices
-                {
-                    unison_base_freq_rap[nvoice][0] = 1.0f / unison_real_spread;
-                    unison_base_freq_rap[nvoice][1] = unison_real_spread;
-                }
-                break;
 
-            default: // unison for more than 2 subvoices
-                {
-                    float unison_values[unison];
-                    float min = -1e-6f, max = 1e-6f;
-                    for (int k = 0; k < true_unison; ++k)
-                    {
-                        float step = (k / (float) (true_unison - 1)) * 2.0f - 1.0f;  //this makes the unison spread more uniform
-                        float val  = step + (paramRNG.numRandom() * 2.0f - 1.0f) / (true_unison - 1);
-                        unison_values[k] = val;
-                        if (val > max)
-                            max = val;
-                        if (val < min)
-                            min = val;
-                    }
-                    float diff = max - min;
-                    for (int k = 0; k < true_unison; ++k)
-                    {
-                        unison_values[k] =
-                            (unison_values[k] - (max + min) * 0.5f) / diff;
-                            // the lowest value will be -1 and the highest will be 1
-                        unison_base_freq_rap[nvoice][k] =
-                            power<2>((unison_spread * unison_values[k]) / 1200.0f);
-                    }
-                }
-                break;
-        }
-        if (is_pwm)
-            for (int i = true_unison - 1; i >= 0; i--)
-            {
-                unison_base_freq_rap[nvoice][2*i + 1] = unison_base_freq_rap[nvoice][i];
-                unison_base_freq_rap[nvoice][2*i]     = unison_base_freq_rap[nvoice][i];
-            }
+void ADnote::computeVoiceUnison(int nvoice)
+{
+    int unison = unison_size[nvoice];
+    bool is_pwm = NoteVoicePar[nvoice].fmEnabled == PW_MOD;
 
-        // unison vibratos
-        if (true_unison > 1)
-        {
-            for (int k = 0; k < unison; ++k) // reduce the frequency difference
-                                             // for larger vibratos
-                unison_base_freq_rap[nvoice][k] =
-                    1.0f + (unison_base_freq_rap[nvoice][k] - 1.0f)
-                    * (1.0f - unison_vibrato_a);
+    unison_stereo_spread[nvoice] =
+        adpars.VoicePar[nvoice].Unison_stereo_spread / 127.0f;
+    float unison_spread = adpars.getUnisonFrequencySpreadCents(nvoice);
+    float unison_real_spread = power<2>((unison_spread * 0.5f) / 1200.0f);
+    float unison_vibrato_a = adpars.VoicePar[nvoice].Unison_vibrato / 127.0f;   // 0.0 .. 1.0
 
-            unison_vibrato[nvoice].amplitude = (unison_real_spread - 1.0f) * unison_vibrato_a;
+    int true_unison = unison >> is_pwm;
+    switch (true_unison)
+    {
+        case 1: // if no unison, set the subvoice to the default note
+            unison_base_freq_rap[nvoice][0] = 1.0f;
+            break;
 
-            float increments_per_second = 1 / synth.fixed_sample_step_f;
-            const float vib_speed = adpars.VoicePar[nvoice].Unison_vibrato_speed / 127.0f;
-            float vibrato_base_period  = 0.25f * power<2>((1.0f - vib_speed) * 4.0f);
-            for (int k = 0; k < unison; ++k)
+        case 2:  // unison for 2 subvoices
             {
-                // make period to vary randomly from 50% to 200% vibrato base period
-                float vibrato_period = vibrato_base_period * power<2>(paramRNG.numRandom() * 2.0f - 1.0f);
-                float m = 4.0f / (vibrato_period * increments_per_second);
-                if (unison_vibrato[nvoice].step[k] < 0.0f)
-                    m = -m;
-                unison_vibrato[nvoice].step[k] = m;
+                unison_base_freq_rap[nvoice][0] = 1.0f / unison_real_spread;
+                unison_base_freq_rap[nvoice][1] = unison_real_spread;
+            }
+            break;
 
-                if (is_pwm)
+        default: // unison for more than 2 subvoices
+            {
+                float unison_values[unison];
+                float min = -1e-6f, max = 1e-6f;
+                for (int k = 0; k < true_unison; ++k)
                 {
-                    // Set the next position the same as this one.
-                    unison_vibrato[nvoice].step[k+1] =
-                        unison_vibrato[nvoice].step[k];
-                    ++k; // Skip an iteration.
+                    float step = (k / (float) (true_unison - 1)) * 2.0f - 1.0f;  //this makes the unison spread more uniform
+                    float val  = step + (paramRNG.numRandom() * 2.0f - 1.0f) / (true_unison - 1);
+                    unison_values[k] = val;
+                    if (val > max)
+                        max = val;
+                    if (val < min)
+                        min = val;
+                }
+                float diff = max - min;
+                for (int k = 0; k < true_unison; ++k)
+                {
+                    unison_values[k] =
+                        (unison_values[k] - (max + min) * 0.5f) / diff;
+                        // the lowest value will be -1 and the highest will be 1
+                    unison_base_freq_rap[nvoice][k] =
+                        power<2>((unison_spread * unison_values[k]) / 1200.0f);
                 }
             }
-        }
-        else // No vibrato for a single voice
+            break;
+    }
+    if (is_pwm)
+        for (int i = true_unison - 1; i >= 0; i--)
         {
-            unison_vibrato[nvoice].step[0] = 0.0f;
-            unison_vibrato[nvoice].amplitude = 0.0f;
+            unison_base_freq_rap[nvoice][2*i + 1] = unison_base_freq_rap[nvoice][i];
+            unison_base_freq_rap[nvoice][2*i]     = unison_base_freq_rap[nvoice][i];
+        }
+
+    // unison vibratos
+    if (true_unison > 1)
+    {
+        for (int k = 0; k < unison; ++k) // reduce the frequency difference
+                                         // for larger vibratos
+            unison_base_freq_rap[nvoice][k] =
+                1.0f + (unison_base_freq_rap[nvoice][k] - 1.0f)
+                * (1.0f - unison_vibrato_a);
+
+        unison_vibrato[nvoice].amplitude = (unison_real_spread - 1.0f) * unison_vibrato_a;
+
+        float increments_per_second = 1 / synth.control_step_f;
+        const float vib_speed = adpars.VoicePar[nvoice].Unison_vibrato_speed / 127.0f;
+        float vibrato_base_period  = 0.25f * power<2>((1.0f - vib_speed) * 4.0f);
+        for (int k = 0; k < unison; ++k)
+        {
+            // make period to vary randomly from 50% to 200% vibrato base period
+            float vibrato_period = vibrato_base_period * power<2>(paramRNG.numRandom() * 2.0f - 1.0f);
+            float m = 4.0f / (vibrato_period * increments_per_second);
+            if (unison_vibrato[nvoice].step[k] < 0.0f)
+                m = -m;
+            unison_vibrato[nvoice].step[k] = m;
 
             if (is_pwm)
             {
-                unison_vibrato[nvoice].step[1]     = 0.0f;
+                // Set the next position the same as this one.
+                unison_vibrato[nvoice].step[k+1] =
+                    unison_vibrato[nvoice].step[k];
+                ++k; // Skip an iteration.
             }
         }
+    }
+    else // No vibrato for a single voice
+    {
+        unison_vibrato[nvoice].step[0] = 0.0f;
+        unison_vibrato[nvoice].amplitude = 0.0f;
 
-        // phase invert for unison
-        unison_invert_phase[nvoice][0] = false;
-        if (unison != 1)
+        if (is_pwm)
         {
-            int inv = adpars.VoicePar[nvoice].Unison_invert_phase;
-            switch(inv)
-            {
-                case 0:
-                    for (int k = 0; k < unison; ++k)
-                        unison_invert_phase[nvoice][k] = false;
-                    break;
+            unison_vibrato[nvoice].step[1]     = 0.0f;
+        }
+    }
 
-                case 1:
-                    for (int k = 0; k < unison; ++k)
-                        unison_invert_phase[nvoice][k] = _SYS_::F2B(paramRNG.numRandom());
-                    break;
+    // phase invert for unison
+    unison_invert_phase[nvoice][0] = false;
+    if (unison != 1)
+    {
+        int inv = adpars.VoicePar[nvoice].Unison_invert_phase;
+        switch(inv)
+        {
+            case 0:
+                for (int k = 0; k < unison; ++k)
+                    unison_invert_phase[nvoice][k] = false;
+                break;
 
-                default:
-                    for (int k = 0; k < unison; ++k)
-                        unison_invert_phase[nvoice][k] = (k % inv == 0) ? true : false;
-                    break;
-            }
+            case 1:
+                for (int k = 0; k < unison; ++k)
+                    unison_invert_phase[nvoice][k] = _SYS_::F2B(paramRNG.numRandom());
+                break;
+
+            default:
+                for (int k = 0; k < unison; ++k)
+                    unison_invert_phase[nvoice][k] = (k % inv == 0) ? true : false;
+                break;
         }
     }
 }
@@ -1508,7 +1590,7 @@ void ADnote::computeWorkingParameters()
 
     float filterpitch, filterfreq;
     float globalpitch = 0.01f * (noteGlobal.freqEnvelope->envout()
-                       + noteGlobal.freqLFO->lfoout() * ctl.modwheel.relmod);
+                       + noteGlobal.freqLFO->lfoout() * expr.relmod);
     globaloldamplitude = globalnewamplitude;
     globalnewamplitude = noteGlobal.volume
                          * noteGlobal.ampEnvelope->envout_dB()
@@ -1517,11 +1599,11 @@ void ADnote::computeWorkingParameters()
                               + noteGlobal.filterLFO->lfoout()
                               + filterCenterPitch;
 
-    float tmpfilterfreq = globalfilterpitch + ctl.filtercutoff.relfreq
+    float tmpfilterfreq = globalfilterpitch + expr.cutoff
           + filterFreqTracking;
 
     tmpfilterfreq = noteGlobal.filterL->getrealfreq(tmpfilterfreq);
-    float globalfilterq = filterQ * ctl.filterq.relq;
+    float globalfilterq = filterQ * expr.relq;
     noteGlobal.filterL->setfreq_and_q(tmpfilterfreq, globalfilterq);
     if (stereo)
         noteGlobal.filterR->setfreq_and_q(tmpfilterfreq, globalfilterq);
@@ -1541,8 +1623,8 @@ void ADnote::computeWorkingParameters()
     {
         if (!NoteVoicePar[nvoice].enabled)
             continue;
-        NoteVoicePar[nvoice].delayTicks -= 1;
-        if (NoteVoicePar[nvoice].delayTicks > 0)
+        NoteVoicePar[nvoice].delayFrames -= synth.sent_buffersize;
+        if (NoteVoicePar[nvoice].delayFrames > 0)
             continue;
 
         computeUnisonFreqRap(nvoice);
@@ -1585,7 +1667,7 @@ void ADnote::computeWorkingParameters()
             basevoicepitch += detuneFromParent;
 
             basevoicepitch += 12.0f * NoteVoicePar[nvoice].bendAdjust *
-                log2f(ctl.pitchwheel.relfreq); //change the frequency by the controller
+                log2f(expr.relfreq); //change the frequency by the controller
 
             float voicepitch = basevoicepitch;
             if (NoteVoicePar[nvoice].freqLFO)
@@ -1662,28 +1744,21 @@ void ADnote::computeWorkingParameters()
 
 
 // Fadein in a way that removes clicks but keep sound "punchy"
-void ADnote::fadein(Samples& smps)
+// The length is set by the voice frequency on the first tick, and the
+// fade then runs on over as many control blocks as it needs.
+void ADnote::fadein(int nvoice, Samples& smpsl, Samples& smpsr)
 {
-    int zerocrossings = 0;
-    for (int i = 1; i < synth.sent_buffersize; ++i)
-        if (smps[i - 1] < 0.0f && smps[i] > 0.0f)
-            zerocrossings++; // this is only the positive crossings
-
-    float tmp = (synth.sent_buffersize - 1.0f) / (zerocrossings + 1) / 3.0f;
-    if (tmp < 8.0f)
-        tmp = 8.0f;
-    tmp *= noteGlobal.fadeinAdjustment;
-
-    int fadein = int(tmp); // how many samples is the fade-in
-    if (fadein < 8)
-        fadein = 8;
-    if (fadein > synth.sent_buffersize)
-        fadein = synth.sent_buffersize;
-    for (int i = 0; i < fadein; ++i) // fade-in
-    {
-        float tmp = 0.5f - cosf((float)i / (float) fadein * PI) * 0.5f;
-        smps[i] *= tmp;
+    if (firsttick[nvoice])
+    {
+        int length = fadeInLength(synth.samplerate_f, getVoiceBaseFreq(nvoice),
+                                  noteGlobal.fadeinAdjustment, int(1.0f / synth.fadeStepShort));
+        fadeinLength[nvoice] = (length < 8) ? 8 : length;
+        fadeinPos[nvoice] = 0;
+        firsttick[nvoice] = 0;
     }
+    if (fadeinPos[nvoice] < fadeinLength[nvoice])
+        fadeIn(smpsl.get(), stereo ? smpsr.get() : NULL,
+               fadeinPos[nvoice], fadeinLength[nvoice], synth.sent_buffersize);
 }
 
 
@@ -1798,7 +1873,7 @@ void ADnote::computeVoiceModulator(int nvoice, int FMmode)
             Samples const& smps = subFMVoice[nvoice][k]->NoteVoicePar[subVoiceNumber].voiceOut;
             // For historical/compatibility reasons we do not reduce volume here
             // if are using stereo. See same section in computeVoiceOscillator.
-            memcpy(tmpmod_unison[k].get(), smps.get(), synth.bufferbytes);
+            memcpy(tmpmod_unison[k].get(), smps.get(), synth.sent_bufferbytes);
         }
     }
     else if (parentFMmod != NULL)
@@ -2275,14 +2350,14 @@ void ADnote::computeVoiceOscillator(int nvoice)
             if (stereo)
             {
                 // Reduce volume due to stereo being combined to mono.
-                for (int i = 0; i < synth.buffersize; ++i)
+                for (int i = 0; i < synth.sent_buffersize; ++i)
                 {
                     unison[i] = smps[i] * 0.5f;
                 }
             }
             else
             {
-                memcpy(unison.get(), smps.get(), synth.bufferbytes);
+                memcpy(unison.get(), smps.get(), synth.sent_bufferbytes);
             }
         }
     }
@@ -2349,14 +2424,33 @@ void ADnote::ComputeVoiceSpotNoise(int nvoice)
 }
 
 
+// Picks up parameter changes ahead of noteout(), as the oscillators they
+// are read from are shared. Part calls this on the Synth-thread when the
+// note itself is rendered elsewhere, after which noteout() finds nothing to do.
+void ADnote::prepareOut()
+{
+    if (paramsUpdate.checkUpdated())
+        refreshNoteParameters();
+    for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
+    {
+        if (subVoice[nvoice])
+            for (size_t k = 0; k < unison_size[nvoice]; ++k)
+                subVoice[nvoice][k]->prepareOut();
+        if (subFMVoice[nvoice])
+            for (size_t k = 0; k < unison_size[nvoice]; ++k)
+                subFMVoice[nvoice][k]->prepareOut();
+    }
+}
+
+
 // Compute the ADnote samples, returns 0 if the note is finished
 void ADnote::noteout(float *outl, float *outr)
 {
     Config &Runtime = synth.getRuntime();
-    Samples& tmpwavel = Runtime.genTmp1;
-    Samples& tmpwaver = Runtime.genTmp2;
-    Samples& bypassl = Runtime.genTmp3;
-    Samples& bypassr = Runtime.genTmp4;
+    Samples& tmpwavel = render::scratch(Runtime.genTmp1, 0);
+    Samples& tmpwaver = render::scratch(Runtime.genTmp2, 1);
+    Samples& bypassl = render::scratch(Runtime.genTmp3, 2);
+    Samples& bypassr = render::scratch(Runtime.genTmp4, 3);
     int i, nvoice;
     if (outl and outr)
     {
@@ -2372,13 +2466,13 @@ void ADnote::noteout(float *outl, float *outr)
     }
 
     if (paramsUpdate.checkUpdated())
-        computeNoteParameters();
+        refreshNoteParameters();
 
     computeWorkingParameters();
 
     for (nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
     {
-        if (!NoteVoicePar[nvoice].enabled || NoteVoicePar[nvoice].delayTicks > 0)
+        if (!NoteVoicePar[nvoice].enabled || NoteVoicePar[nvoice].delayFrames > 0)
             continue;
 
         if (NoteVoicePar[nvoice].fmEnabled != NONE)
@@ -2487,34 +2581,29 @@ void ADnote::noteout(float *outl, float *outr)
         }
 
         // Fade in
-        if (firsttick[nvoice])
-        {
-            fadein(tmpwavel);
-            if (stereo)
-                fadein(tmpwaver);
-            firsttick[nvoice] = 0;
-        }
+        fadein(nvoice, tmpwavel, tmpwaver);
 
 
         // Filter
-        if (NoteVoicePar[nvoice].voiceFilterL != NULL)
-            NoteVoicePar[nvoice].voiceFilterL->filterout(tmpwavel.get());
-        if (stereo && NoteVoicePar[nvoice].voiceFilterR != NULL)
-            NoteVoicePar[nvoice].voiceFilterR->filterout(tmpwaver.get());
+        if (stereo && NoteVoicePar[nvoice].voiceFilterL != NULL && NoteVoicePar[nvoice].voiceFilterR != NULL)
+            NoteVoicePar[nvoice].voiceFilterL->filterStereo(tmpwavel.get(), tmpwaver.get(),
+                                                            *NoteVoicePar[nvoice].voiceFilterR);
+        else
+        {
+            if (NoteVoicePar[nvoice].voiceFilterL != NULL)
+                NoteVoicePar[nvoice].voiceFilterL->filterout(tmpwavel.get());
+            if (stereo && NoteVoicePar[nvoice].voiceFilterR != NULL)
+                NoteVoicePar[nvoice].voiceFilterR->filterout(tmpwaver.get());
+        }
 
         // check if the amplitude envelope is finished.
         // if yes, the voice will fadeout
         if (NoteVoicePar[nvoice].ampEnvelope != NULL)
         {
             if (NoteVoicePar[nvoice].ampEnvelope->finished())
-            {
-                for (i = 0; i < synth.sent_buffersize; ++i)
-                    tmpwavel[i] *= 1.0f - (float)i / synth.sent_buffersize_f;
-                if (stereo)
-                    for (i = 0; i < synth.sent_buffersize; ++i)
-                        tmpwaver[i] *= 1.0f - (float)i / synth.sent_buffersize_f;
-            }
-            // the voice is killed later
+                fadeOut(tmpwavel.get(), stereo ? tmpwaver.get() : NULL,
+                        voiceFadeOut[nvoice], synth.fadeStepShort, synth.sent_buffersize);
+            // the voice is killed later, once it has faded out
         }
 
         // Put the ADnote samples in VoiceOut (without applying Global volume,
@@ -2577,7 +2666,7 @@ void ADnote::noteout(float *outl, float *outr)
             // check if there is necessary to process the voice longer
             // (if the Amplitude envelope isn't finished)
             if (NoteVoicePar[nvoice].ampEnvelope)
-                if (NoteVoicePar[nvoice].ampEnvelope->finished())
+                if (NoteVoicePar[nvoice].ampEnvelope->finished() && voiceFadeOut[nvoice] <= 0.0f)
                     killVoice(nvoice);
         }
     }
@@ -2585,15 +2674,14 @@ void ADnote::noteout(float *outl, float *outr)
     if (outl != NULL)
     {
         // Processing Global parameters
-        noteGlobal.filterL->filterout(outl);
-
         if (!stereo) // set the right channel=left channel
         {
+            noteGlobal.filterL->filterout(outl);
             memcpy(outr, outl, synth.sent_bufferbytes);
             memcpy(bypassr.get(), bypassl.get(), synth.sent_bufferbytes);
         }
         else
-            noteGlobal.filterR->filterout(outr);
+            noteGlobal.filterL->filterStereo(outl, outr, *noteGlobal.filterR);
 
         for (i = 0; i < synth.sent_buffersize; ++i)
         {
@@ -2676,18 +2764,12 @@ void ADnote::noteout(float *outl, float *outr)
     }
 
     // Check if the global amplitude is finished.
-    // If it does, disable the note
+    // If it does, fade out and then disable the note
     if (noteGlobal.ampEnvelope->finished())
     {
-        if (outl != NULL)
-        {
-            for (i = 0; i < synth.sent_buffersize; ++i) // fade-out
-            {
-                float tmp = 1.0f - (float)i / synth.sent_buffersize_f;
-                outl[i] *= tmp;
-                outr[i] *= tmp;
-            }
-        }
+        if (outl != NULL
+            && fadeOut(outl, outr, fadeOutLevel, synth.fadeStepShort, synth.sent_buffersize))
+            return; // still fading
         killNote();
         return;
     }
@@ -41,6 +41,7 @@ using std::unique_ptr;
 class ADnoteParameters;
 class SynthEngine;
 class Controller;
+struct NoteExpression;
 class Envelope;
 class Filter;
 class LFO;
@@ -128,13 +129,13 @@ public:
 
 class ADnote
 {
-        ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note note_, bool portamento_
+        ADnote(ADnoteParameters& adpars_, Controller& ctl_, NoteExpression const& expr_, Note note_, bool portamento_
               ,ADnote *topVoice_, int subVoiceNr, int phaseOffset, float *parentFMmod_
               ,bool forFM_, size_t unison_total_size);
         ADnote(ADnote *topVoice_, float freq_, int phase_offset_, int subVoiceNumber_,
                float *parentFMmod_, bool forFM_, size_t unison_total_size);
     public:
-        ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note, bool portamento_);
+        ADnote(ADnoteParameters& adpars_, Controller& ctl_, NoteExpression const& expr_, Note, bool portamento_);
         ADnote(const ADnote &orig, ADnote *topVoice_ = NULL, float *parentFMmod_ = NULL);
        ~ADnote();
 
@@ -143,12 +144,14 @@ class ADnote
         ADnote& operator=(ADnote&&)      = delete;
         ADnote& operator=(ADnote const&) = delete;
 
+        void prepareOut();
         void noteout(float *outl, float *outr);
         void releasekey();
         bool finished() const { return noteStatus == NOTE_DISABLED; }
         void performPortamento(Note);
         void legatoFadeIn(Note);
         void legatoFadeOut();
+        void stealFadeOut();
 
     private:
         void construct(size_t unison_total_size);
@@ -165,7 +168,13 @@ class ADnote
             unisonDetuneFactorFromParent = factor;
         }
         void computeUnisonFreqRap(int nvoice);
-        void computeNoteParameters();
+        void refreshNoteParameters();
+        void computeNoteParameters(uint changed = ADnoteParameters::allChanges);
+        void computeVoicePitch(int nvoice);
+        void computeVoiceFM(int nvoice);
+        void computeVoiceAmp(int nvoice);
+        void computeVoiceWave(int nvoice);
+        void computeVoiceUnison(int nvoice);
         void computeWorkingParameters();
         void computePhaseOffsets(int nvoice);
         void computeFMPhaseOffsets(int nvoice);
@@ -196,14 +205,16 @@ class ADnote
 
         void computeVoiceOscillator(int nvoice);
 
-        void fadein(Samples& smps);
+        void fadein(int nvoice, Samples& smpsl, Samples& smpsr);
 
 
         // Globals
         SynthEngine& synth;
         ADnoteParameters& adpars;
         ParamBase::ParamsUpdate paramsUpdate;
+        uint paramsSeen; // adpars change stamp last worked out
         Controller& ctl;
+        NoteExpression const& expr; // the controllers as this note has them
 
         Note note;
         bool stereo;
@@ -262,7 +273,7 @@ class ADnote
             int voice;              // the voice used as source.
             int noiseType;          // (sound/noise)
             int filterBypass;
-            int delayTicks;
+            int delayFrames;
             SampleHolder oscilSmp;  // Waveform of the Voice. Shared with sub voices.
             int phaseOffset;        // PWM emulation
 
@@ -396,6 +407,10 @@ class ADnote
 
         char firsttick[NUM_VOICES]; // 1 - if it is the first tick.
                                     // used to fade in the sound
+        int fadeinPos[NUM_VOICES];  // the fade-in can run over several blocks
+        int fadeinLength[NUM_VOICES];
+        float voiceFadeOut[NUM_VOICES]; // level once a voice envelope is finished
+        float fadeOutLevel;         // and the same for the whole note
 
         bool portamento;            // note performs portamento starting from previous note frequency
 
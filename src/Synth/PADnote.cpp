@@ -51,6 +51,9 @@ using synth::velF;
 using synth::getDetune;
 using synth::interpolateAmplitude;
 using synth::aboveAmplitudeThreshold;
+using synth::fadeInLength;
+using synth::fadeIn;
+using synth::fadeOut;
 using func::setRandomPan;
 using std::unique_ptr;
 
@@ -58,11 +61,12 @@ using std::unique_ptr;
 PADnote::~PADnote() { }
 
 
-PADnote::PADnote(PADnoteParameters& parameters, Controller& ctl_, Note note_, bool portamento_)
+PADnote::PADnote(PADnoteParameters& parameters, Controller& ctl_, NoteExpression const& expr_, Note note_, bool portamento_)
     : synth{parameters.getSynthEngine()}
     , pars{parameters}
     , padSynthUpdate{parameters}
     , ctl{ctl_}
+    , expr{expr_}
     , noteStatus{NOTE_ENABLED}
     , waveInterpolator{}   // will be installed in computeNoteParameters()
     , note{note_}
@@ -71,7 +75,11 @@ PADnote::PADnote(PADnoteParameters& parameters, Controller& ctl_, Note note_, bo
     , OffsetHz{0}
     , firsttime{true}
     , released{false}
+    , fadeinPos{0}
+    , fadeinLength{0}
+    , fadeOutLevel{1.0f}
     , portamento{portamento_}
+    , prepared{false}
     , globaloldamplitude{0}
     , globalnewamplitude{0}
     , randpanL{0.7}
@@ -127,6 +135,7 @@ PADnote::PADnote(const PADnote &orig)
     , pars{orig.pars}
     , padSynthUpdate{pars}
     , ctl{orig.ctl}
+    , expr{orig.expr}
     , noteStatus{orig.noteStatus}
     , waveInterpolator{WaveInterpolator::clone(orig.waveInterpolator)}  // use wavetable and reading position from orig
     , note{orig.note}
@@ -135,7 +144,11 @@ PADnote::PADnote(const PADnote &orig)
     , OffsetHz{orig.OffsetHz}
     , firsttime{orig.firsttime}
     , released{orig.released}
+    , fadeinPos{orig.fadeinPos}
+    , fadeinLength{orig.fadeinLength}
+    , fadeOutLevel{orig.fadeOutLevel}
     , portamento{orig.portamento}
+    , prepared{false}
     , globaloldamplitude{orig.globaloldamplitude}
     , globalnewamplitude{orig.globalnewamplitude}
     , randpanL{orig.randpanL}
@@ -191,6 +204,15 @@ void PADnote::legatoFadeOut()
 }
 
 
+// Fade to silence from the current level, then the note disables itself.
+// Used by the voice manager, so unlike a release there is no tail.
+void PADnote::stealFadeOut()
+{
+    legatoFadeStep = -synth.fadeStepShort;
+    noteStatus = NOTE_LEGATOFADEOUT;
+}
+
+
 void PADnote::performPortamento(Note note_)
 {
     portamento = true;
@@ -217,26 +239,17 @@ void PADnote::setupBaseFreq()
     }
 }
 
-inline void PADnote::fadein(float *smps)
+// the length is set on the first call, then the fade may run over several blocks
+inline void PADnote::fadein(float *smpsl, float *smpsr)
 {
-    int zerocrossings = 0;
-    for (int i = 1; i < synth.sent_buffersize; ++i)
-        if (smps[i - 1] < 0.0 && smps[i] > 0.0)
-            zerocrossings++; // this is only the positive crossings
-
-    float tmp = (synth.sent_buffersize_f - 1.0) / (zerocrossings + 1) / 3.0;
-    if (tmp < 8.0)
-        tmp = 8.0;
-    tmp *= noteGlobal.fadeinAdjustment;
-
-    int n = int(tmp); // how many samples is the fade-in
-    if (n > synth.sent_buffersize)
-        n = synth.sent_buffersize;
-    for (int i = 0; i < n; ++i)
-    {   // fade-in
-        float tmp = 0.5 - cosf((float)i / (float) n * PI) * 0.5f;
-        smps[i] *= tmp;
+    if (firsttime)
+    {
+        fadeinLength = fadeInLength(synth.samplerate_f, realfreq, noteGlobal.fadeinAdjustment,
+                                    int(1.0f / synth.fadeStepShort));
+        fadeinPos = 0;
     }
+    if (fadeinPos < fadeinLength)
+        fadeIn(smpsl, smpsr, fadeinPos, fadeinLength, synth.sent_buffersize);
 }
 
 
@@ -289,7 +302,7 @@ WaveInterpolator* PADnote::setupCrossFade(WaveInterpolator* newInterpolator)
                                              ,unique_ptr<WaveInterpolator>{waveInterpolator.release()}
                                              ,unique_ptr<WaveInterpolator>{newInterpolator}
                                              ,crossFadeLengthSmps
-                                             ,synth.buffersize);
+                                             ,synth.controlsize);
     }
     else // fallback: no existing Interpolator ==> just install given new one
         return newInterpolator;    // relevant for NoteOn after wavetable rebuild (no waveInterpolator yet)
@@ -346,7 +359,7 @@ void PADnote::computecurrentparameters()
 {
     float globalpitch =
         0.01 * (noteGlobal.freqEnvelope->envout()
-        + noteGlobal.freqLFO->lfoout() * ctl.modwheel.relmod + noteGlobal.detune);
+        + noteGlobal.freqLFO->lfoout() * expr.relmod + noteGlobal.detune);
     globaloldamplitude = globalnewamplitude;
     globalnewamplitude = noteGlobal.volume
         * noteGlobal.ampEnvelope->envout_dB()
@@ -365,11 +378,11 @@ void PADnote::computecurrentparameters()
         + filterCenterPitch;
 
     float tmpfilterfreq =
-        globalfilterpitch + ctl.filtercutoff.relfreq + filterFreqTracking;
+        globalfilterpitch + expr.cutoff + filterFreqTracking;
 
     tmpfilterfreq = noteGlobal.filterL->getrealfreq(tmpfilterfreq);
 
-    float globalfilterq = filterQ * ctl.filterq.relq;
+    float globalfilterq = filterQ * expr.relq;
     globalfilterq *= pars.randWalkFilterFreq.getFactor();
     noteGlobal.filterL->setfreq_and_q(tmpfilterfreq,globalfilterq);
     noteGlobal.filterR->setfreq_and_q(tmpfilterfreq,globalfilterq);
@@ -386,17 +399,36 @@ void PADnote::computecurrentparameters()
     }
 
     realfreq = note.freq * portamentofreqrap * power<2>(globalpitch / 12.0)
-               * powf(ctl.pitchwheel.relfreq, BendAdjust) + OffsetHz;
+               * powf(expr.relfreq, BendAdjust) + OffsetHz;
     realfreq *= pars.randWalkDetune.getFactor();
 }
 
 
 
-void PADnote::noteout(float *outl,float *outr)
+// Everything in noteout() that touches the shared parameters.
+// Part calls this on the Synth-thread when the note itself is rendered elsewhere.
+void PADnote::prepareOut()
 {
     pars.activate_wavetable();
     if (padSynthUpdate.checkUpdated())
         computeNoteParameters();
+    prepared = true;
+}
+
+
+// Crossfading wavetables keeps a use count in the parameters,
+// so such notes must stay on the Synth-thread
+bool PADnote::crossFading() const
+{
+    return pars.PxFadeUpdate > 0 or bool(pars.xFade);
+}
+
+
+void PADnote::noteout(float *outl,float *outr)
+{
+    if (not prepared)
+        prepareOut();
+    prepared = false;
     computecurrentparameters();
     if (not waveInterpolator
          or noteStatus == NOTE_DISABLED)
@@ -404,17 +436,15 @@ void PADnote::noteout(float *outl,float *outr)
 
     waveInterpolator->caculateSamples(outl,outr, realfreq,
                                       synth.sent_buffersize);
+    fadein(outl, outr);
     if (firsttime)
     {
-        fadein(outl);
-        fadein(outr);
         globaloldamplitude = globalnewamplitude;
         // avoid triggering amplitude interpolation at first buffer cycle
         firsttime = false;
     }
 
-    noteGlobal.filterL->filterout(outl);
-    noteGlobal.filterR->filterout(outr);
+    noteGlobal.filterL->filterStereo(outl, outr, *noteGlobal.filterR);
 
     // Apply the punch
     if (noteGlobal.punch.enabled)
@@ -489,14 +519,9 @@ void PADnote::noteout(float *outl,float *outr)
 
     // Check global envelope and discard this note when finished.
     if (noteGlobal.ampEnvelope->finished() != 0)
-    {
-        for (int i = 0 ; i < synth.sent_buffersize; ++i)
-        {   // fade-out
-            float tmp = 1.0f - (float)i / synth.sent_buffersize_f;
-            outl[i] *= tmp;
-            outr[i] *= tmp;
-        }
-        noteStatus = NOTE_DISABLED; // causes clean-up of this note instance
+    {   // fade-out first
+        if (!fadeOut(outl, outr, fadeOutLevel, synth.fadeStepShort, synth.sent_buffersize))
+            noteStatus = NOTE_DISABLED; // causes clean-up of this note instance
         return;
     }
 }
@@ -38,14 +38,14 @@ class Controller;
 class Envelope;
 class LFO;
 class Filter;
-class Controller;
+struct NoteExpression;
 
 class SynthEngine;
 
 class PADnote
 {
     public:
-        PADnote(PADnoteParameters& parameters, Controller& ctl_, Note, bool portamento_);
+        PADnote(PADnoteParameters& parameters, Controller& ctl_, NoteExpression const& expr_, Note, bool portamento_);
         PADnote(const PADnote &orig);
        ~PADnote();
 
@@ -57,13 +57,17 @@ class PADnote
         void performPortamento(Note);
         void legatoFadeIn(Note);
         void legatoFadeOut();
+        void stealFadeOut();
 
+        void prepareOut();
         void noteout(float* outl, float* outr);
         bool finished() const { return noteStatus == NOTE_DISABLED; }
         void releasekey();
 
+        bool crossFading() const;
+
     private:
-        void fadein(float* smps);
+        void fadein(float* smpsl, float* smpsr);
         bool isWavetableChanged(size_t tableNr);
         WaveInterpolator* buildInterpolator(size_t tableNr);
         WaveInterpolator* setupCrossFade(WaveInterpolator*);
@@ -77,6 +81,7 @@ class PADnote
         PADnoteParameters& pars;
         ParamBase::ParamsUpdate padSynthUpdate;
         Controller& ctl;
+        NoteExpression const& expr;
 
         enum NoteStatus {
             NOTE_DISABLED,
@@ -92,8 +97,12 @@ class PADnote
         float OffsetHz;
         bool firsttime;
         bool released;
+        int fadeinPos;     // fades can run over several blocks
+        int fadeinLength;
+        float fadeOutLevel;
 
         bool portamento;
+        bool prepared; // prepareOut() already done for the next noteout()
 
         int Compute_Linear(float* outl, float* outr, int freqhi, float freqlo);
         int Compute_Cubic (float* outl, float* outr, int freqhi, float freqlo);
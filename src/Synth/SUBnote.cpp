@@ -37,6 +37,7 @@
 #include "Misc/SynthEngine.h"
 #include "Misc/SynthHelper.h"
 #include "Misc/NumericFuncs.h"
+#include "Misc/RenderPool.h"
 
 using func::power;
 using func::powFrac;
@@ -45,16 +46,18 @@ using synth::velF;
 using synth::getDetune;
 using synth::interpolateAmplitude;
 using synth::aboveAmplitudeThreshold;
+using synth::fadeOut;
 
 using func::setRandomPan;
 
 
 
-SUBnote::SUBnote(SUBnoteParameters& parameters, Controller& ctl_, Note note_, bool portamento_)
+SUBnote::SUBnote(SUBnoteParameters& parameters, Controller& ctl_, NoteExpression const& expr_, Note note_, bool portamento_)
     : synth{parameters.getSynthEngine()}
     , pars{parameters}
     , subNoteChange{parameters}
     , ctl{ctl_}
+    , expr{expr_}
     , note{note_}
     , stereo{pars.Pstereo}
     , realfreq{computeRealFreq()}
@@ -73,11 +76,10 @@ SUBnote::SUBnote(SUBnoteParameters& parameters, Controller& ctl_, Note note_, bo
     , globalFilterR{}
     , noteStatus{NOTE_ENABLED}
     , firsttick{1}
+    , fadeOutLevel{1.0f}
     , lfilter{}
     , rfilter{}
-    , tmpsmp{synth.getRuntime().genTmp1}
-    , tmprnd{synth.getRuntime().genTmp2}
-    , oldpitchwheel{0}
+    , oldpitchwheel{1.0f}
     , oldbandwidth{64}
     , legatoFade{1.0f}       // Full volume
     , legatoFadeStep{0.0f}   // Legato disabled
@@ -105,6 +107,7 @@ SUBnote::SUBnote(SUBnote const& orig)
     , pars{orig.pars}
     , subNoteChange{pars}
     , ctl{orig.ctl}
+    , expr{orig.expr}
     , note{orig.note}
     , stereo{orig.stereo}
     , realfreq{orig.realfreq}
@@ -125,13 +128,12 @@ SUBnote::SUBnote(SUBnote const& orig)
     , globalFilterR{}
     , noteStatus{orig.noteStatus}
     , firsttick{orig.firsttick}
+    , fadeOutLevel{orig.fadeOutLevel}
     , volume{orig.volume}
     , oldamplitude{orig.oldamplitude}
     , newamplitude{orig.newamplitude}
     , lfilter{}
     , rfilter{}
-    , tmpsmp{orig.synth.getRuntime().genTmp1}
-    , tmprnd{orig.synth.getRuntime().genTmp2}
     , oldpitchwheel{orig.oldpitchwheel}
     , oldbandwidth{orig.oldbandwidth}
     , legatoFade{0.0f}     // Silent by default
@@ -206,6 +208,15 @@ void SUBnote::legatoFadeOut()
 }
 
 
+// Fade to silence from the current level, then the note disables itself.
+// Used by the voice manager, so unlike a release there is no tail.
+void SUBnote::stealFadeOut()
+{
+    legatoFadeStep = -synth.fadeStepShort;
+    noteStatus = NOTE_LEGATOFADEOUT;
+}
+
+
 SUBnote::~SUBnote()
 {
     killNote();
@@ -528,7 +539,7 @@ void SUBnote::computeallfiltercoefs()
         envfreq = power<2>(envfreq);
     }
 
-    envfreq *= powf(ctl.pitchwheel.relfreq, bendAdjust); // pitch wheel
+    envfreq *= powf(expr.relfreq, bendAdjust); // pitch wheel
 
     if (portamento)
     {
@@ -576,7 +587,7 @@ void SUBnote::computeallfiltercoefs()
             }
         }
     oldbandwidth = ctl.bandwidth.data;
-    oldpitchwheel = ctl.pitchwheel.data;
+    oldpitchwheel = expr.relfreq;
 }
 
 // Compute Parameters of SUBnote for each tick
@@ -584,7 +595,7 @@ void SUBnote::computecurrentparameters()
 {
     if (freqEnvelope != NULL
         || bandWidthEnvelope != NULL
-        || oldpitchwheel != ctl.pitchwheel.data
+        || oldpitchwheel != expr.relfreq
         || oldbandwidth != ctl.bandwidth.data
         || portamento)
         computeallfiltercoefs();
@@ -604,12 +615,24 @@ void SUBnote::computecurrentparameters()
         float filtercenterq = pars.GlobalFilter->getq();
         float filterFreqTracking = pars.GlobalFilter->getfreqtracking(note.freq);
         float globalfilterpitch = filterCenterPitch + globalFilterEnvelope->envout();
-        float filterfreq = globalfilterpitch + ctl.filtercutoff.relfreq + filterFreqTracking;
+        float filterfreq = globalfilterpitch + expr.cutoff + filterFreqTracking;
         filterfreq = globalFilterL->getrealfreq(filterfreq);
 
-        globalFilterL->setfreq_and_q(filterfreq, filtercenterq * ctl.filterq.relq);
+        globalFilterL->setfreq_and_q(filterfreq, filtercenterq * expr.relq);
         if (globalFilterR != NULL)
-            globalFilterR->setfreq_and_q(filterfreq, filtercenterq * ctl.filterq.relq);
+            globalFilterR->setfreq_and_q(filterfreq, filtercenterq * expr.relq);
+    }
+}
+
+
+// Parameter changes, done ahead of noteout() by Part
+// when the note itself is rendered on another thread
+void SUBnote::prepareOut()
+{
+    if (subNoteChange.checkUpdated())
+    {
+        realfreq = computeRealFreq();
+        computeNoteParameters();
     }
 }
 
@@ -617,17 +640,13 @@ void SUBnote::computecurrentparameters()
 // Note Output
 void SUBnote::noteout(float *outl, float *outr)
 {
-    assert(tmpsmp.get() == synth.getRuntime().genTmp1.get());
-    assert(tmprnd.get() == synth.getRuntime().genTmp2.get());
+    Samples& tmpsmp = render::scratch(synth.getRuntime().genTmp1, 0);
+    Samples& tmprnd = render::scratch(synth.getRuntime().genTmp2, 1); // filled with random numbers
     memset(outl, 0, synth.sent_bufferbytes);
     memset(outr, 0, synth.sent_bufferbytes);
     if (noteStatus == NOTE_DISABLED) return;
 
-    if (subNoteChange.checkUpdated())
-    {
-        realfreq = computeRealFreq();
-        computeNoteParameters();
-    }
+    prepareOut();
 
     // left channel
     for (int i = 0; i < synth.sent_buffersize; ++i)
@@ -642,7 +661,7 @@ void SUBnote::noteout(float *outl, float *outr)
             outl[i] += tmpsmp[i] * rolloff;
     }
 
-    if (globalFilterL != NULL)
+    if (globalFilterL != NULL && !stereo)
         globalFilterL->filterout(outl);
 
     // right channel
@@ -659,7 +678,12 @@ void SUBnote::noteout(float *outl, float *outr)
             for (int i = 0; i < synth.sent_buffersize; ++i)
                 outr[i] += tmpsmp[i] * rolloff;
         }
-        if (globalFilterR != NULL)
+        // both filtered together once the right is ready
+        if (globalFilterL != NULL && globalFilterR != NULL)
+            globalFilterL->filterStereo(outl, outr, *globalFilterR);
+        else if (globalFilterL != NULL)
+            globalFilterL->filterout(outl);
+        else if (globalFilterR != NULL)
             globalFilterR->filterout(outr);
     }
     else
@@ -738,14 +762,9 @@ void SUBnote::noteout(float *outl, float *outr)
 
     // Check if the note needs to be computed more
     if (ampEnvelope->finished() != 0)
-    {
-        for (int i = 0; i < synth.sent_buffersize; ++i)
-        {   // fade-out
-            float tmp = 1.0f - (float)i / synth.sent_buffersize_f;
-            outl[i] *= tmp;
-            outr[i] *= tmp;
-        }
-        killNote();
+    {   // fade-out first
+        if (!fadeOut(outl, outr, fadeOutLevel, synth.fadeStepShort, synth.sent_buffersize))
+            killNote();
         return;
     }
 }
@@ -38,6 +38,7 @@ using std::unique_ptr;
 
 class SUBnoteParameters;
 class Controller;
+struct NoteExpression;
 class Envelope;
 class Filter;
 
@@ -46,7 +47,7 @@ class SynthEngine;
 class SUBnote
 {
     public:
-        SUBnote(SUBnoteParameters& parameters, Controller& ctl_, Note, bool portamento_);
+        SUBnote(SUBnoteParameters& parameters, Controller& ctl_, NoteExpression const& expr_, Note, bool portamento_);
         SUBnote(SUBnote const&);
        ~SUBnote();
 
@@ -58,7 +59,9 @@ class SUBnote
         void performPortamento(Note);
         void legatoFadeIn(Note);
         void legatoFadeOut();
+        void stealFadeOut();
 
+        void prepareOut();
         void noteout(float* outl, float* outr);
         void releasekey();
         bool finished() const { return noteStatus == NOTE_DISABLED; }
@@ -74,6 +77,7 @@ class SUBnote
         SUBnoteParameters& pars;
         ParamBase::ParamsUpdate subNoteChange;
         Controller& ctl;
+        NoteExpression const& expr;
 
         Note note;
         bool stereo;
@@ -105,6 +109,7 @@ class SUBnote
         } noteStatus;
 
         int firsttick;
+        float fadeOutLevel; // the fade-out can run over several blocks
         float volume;
         float oldamplitude;
         float newamplitude;
@@ -143,10 +148,7 @@ class SUBnote
         float overtone_rolloff[MAX_SUB_HARMONICS];
         float overtone_freq[MAX_SUB_HARMONICS];
 
-        Samples& tmpsmp;
-        Samples& tmprnd; // this is filled with random numbers
-
-        int oldpitchwheel;
+        float oldpitchwheel;
         int oldbandwidth;
 
         // Legato vars
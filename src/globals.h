@@ -98,6 +98,7 @@ using ushort = unsigned short;
 #define MAX_OSCIL_SIZE 16384
 #define MIN_BUFFER_SIZE 16
 #define MAX_BUFFER_SIZE 8192
+#define CONTROL_BLOCK_SIZE 64 // envelopes, LFOs and note filters step at this rate
 #define NO_MSG 255 // these two may become different
 #define UNUSED 255
 
@@ -646,6 +647,8 @@ namespace PART // usage PART::control::volume
         minToLastKey,
         maxToLastKey,
         resetMinMaxKey,
+        mpeChannels,
+        mpeBendRange,
         kitEffectNum = 24,
         maxNotes = 33,
         keyShift = 35,